@@ -29,7 +29,9 @@ public class DriverProxy {
 		DISABLE_SORTING_HEURISTICS(12), 
 		REGEX_FLAG(13),
 		OUTPUT_PATH(14), 					// not actively used through Java
-		SCRIPT_PATH(15);					// not actively used
+		SCRIPT_PATH(15),					// not actively used
+		OPERATION_CACHE_SIZE(18),			// maximum total number of states and bdd nodes of cached operation results, 0 disables the cache
+		REGEX_CACHE_FILE(19);				// compiled regexes are loaded from the file, new ones are saved on dispose
 
 		private final int value;
 
@@ -125,6 +127,12 @@ public class DriverProxy {
 	public native BigInteger countStrs(final long bound);
 	
 	public native BigInteger count(final long intBound, final long strBound);
+
+	public native BigInteger[] countVariable(final String varName, final long[] bounds);
+
+	public native BigInteger[] countInts(final long[] bounds);
+
+	public native BigInteger[] countStrs(final long[] bounds);
 	
 	public native byte[] getModelCounterForVariable(final String varName);
 	
@@ -148,6 +156,18 @@ public class DriverProxy {
 
 	public native Map<String, String> getSatisfyingExamplesRandomBounded(final int bound);
 
+	public native void initModelIterator(final String varName, final long bound);
+
+	public native String getNextModel(final String varName);
+
+	public native String sampleModel(final String varName, final long bound);
+
+	public native BigInteger countModelsForRanking(final String varName, final long bound);
+
+	public native BigInteger rankModel(final String varName, final String model, final long bound);
+
+	public native String unrankModel(final String varName, final BigInteger rank, final long bound);
+
 	public native void reset();
 
 	public native void dispose();
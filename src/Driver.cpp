@@ -16,13 +16,25 @@ Driver::Driver()
     : script_(nullptr),
       symbol_table_(nullptr),
       constraint_information_(nullptr),
-      is_model_counter_cached_ { false } {
+      is_model_counter_cached_ { false },
+      random_generator_ { std::random_device()() } {
 }
 
 Driver::~Driver() {
+  for (auto& entry : model_iterators_) {
+    delete entry.second.first;
+    delete entry.second.second;
+  }
+  for (auto& entry : model_rankers_) {
+    delete entry.second.first;
+    delete entry.second.second;
+  }
   delete symbol_table_;
   delete script_;
   delete constraint_information_;
+  if (not Option::Theory::REGEX_CACHE_FILE.empty() and Theory::RegexCache::Instance().HasUnsavedEntries()) {
+    Theory::RegexCache::Instance().Save(Option::Theory::REGEX_CACHE_FILE);
+  }
   Theory::Automaton::CleanUp();
 }
 
@@ -143,249 +155,216 @@ bool Driver::is_sat() {
   return symbol_table_->isSatisfiable();
 }
 
-void Driver::GetModels(const unsigned long bound,const unsigned long num_models) {
+/**
+ * Models are written as they are generated, none of them is kept in memory
+ */
+void Driver::GetModels(const unsigned long bound, const unsigned long num_models, std::ostream& out) {
+  std::vector<std::string> var_names;
+  for (const auto& variable_entry : getSatisfyingVariables()) {
+    if (variable_entry.second == nullptr) {
+      continue;
+    }
+    switch (variable_entry.second->getType()) {
+      case Solver::Value::Type::BINARYINT_AUTOMATON:
+        for (auto& el : variable_entry.second->getBinaryIntAutomaton()->GetFormula()->GetVariableCoefficientMap()) {
+          if (symbol_table_->get_variable_unsafe(el.first) != nullptr) {
+            var_names.push_back(el.first);
+          }
+        }
+        break;
+      case Solver::Value::Type::STRING_AUTOMATON:
+        for (auto& el : variable_entry.second->getStringAutomaton()->GetFormula()->GetVariableCoefficientMap()) {
+          if (symbol_table_->get_variable_unsafe(el.first) != nullptr) {
+            var_names.push_back(el.first);
+          }
+        }
+        break;
+      case Solver::Value::Type::INT_CONSTANT:
+        var_names.push_back(variable_entry.first->getName());
+        break;
+      case Solver::Value::Type::BOOL_CONSTANT:
+        out << variable_entry.first->getName() << " : " << (variable_entry.second->getBoolConstant() ? "true" : "false")
+            << std::endl;
+        break;
+      default:
+        LOG(ERROR)<< "models are not supported for: " << variable_entry.first->getName();
+        break;
+    }
+  }
 
-	LOG(FATAL) << "IMPLEMENT ME";
+  std::string model;
+  for (auto& var_name : var_names) {
+    InitializeModelIterator(var_name, bound);
+    for (unsigned long i = 0; i < num_models and GetNextModel(var_name, model); ++i) {
+      out << var_name << " : " << model << std::endl;
+    }
+    ClearModelIterator(var_name);
+  }
+}
 
-	//LOG(INFO) << "Numver of satisfying variables: " << getSatisfyingVariables().size();
-	std::map<std::string,std::vector<std::string>> variable_values;
-	std::map<SMT::Variable_ptr,Solver::Value_ptr> var_vals;
+/**
+ * A variable without models to iterate over gets no iterator, GetNextModel then returns false
+ */
+void Driver::InitializeModelIterator(const std::string var_name, const unsigned long bound) {
+  ClearModelIterator(var_name);
+  auto model_value = GetModelValue(var_name);
+  if (model_value == nullptr) {
+    return;
+  }
+  Theory::ModelIterator_ptr model_iterator = nullptr;
+  if (Solver::Value::Type::STRING_AUTOMATON == model_value->getType()) {
+    model_iterator = model_value->getStringAutomaton()->GetModelIterator(bound);
+  } else {
+    model_iterator = model_value->getBinaryIntAutomaton()->GetModelIterator(bound);
+  }
+  model_iterators_[var_name] = std::make_pair(model_iterator, model_value);
+}
 
-	std::string var_name("var_8");
-	auto v8 = symbol_table_->get_variable(var_name);
-	auto v8_rep = symbol_table_->get_representative_variable_of_at_scope(script_, v8);
-	auto v8_all_solutions = symbol_table_->get_projected_value_at_scope(script_,v8_rep);
+bool Driver::GetNextModel(const std::string var_name, std::string& model) {
+  auto it = model_iterators_.find(var_name);
+  if (it == model_iterators_.end()) {
+    LOG(ERROR)<< "model iterator is not initialized for: " << var_name;
+    return false;
+  }
+  auto model_iterator = it->second.first;
+  auto model_automaton = GetModelAutomaton(it->second.second);
+  std::vector<bool> word;
+  while (model_iterator->Next(word)) {
+    if (model_automaton->DecodeModel(word, model)) {
+      return true;
+    }
+  }
+  return false;
+}
 
-	auto v8_n_solutions = v8_all_solutions->getStringAutomaton()->GetModelsWithinBound(num_models,-1);
-	LOG(INFO) << 0;
-	Theory::StringAutomaton_ptr union_auto = nullptr, t1_auto = nullptr, t2_auto = nullptr;
-	for(int i = 0; i < v8_n_solutions["var_8"].size(); i++) {
-		t1_auto = Theory::StringAutomaton::MakeString(v8_n_solutions["var_8"][i]);
-		if(union_auto == nullptr) {
-			union_auto = t1_auto;
-		} else {
-			t2_auto = union_auto->Union(t1_auto);
-			delete union_auto;
-			delete t1_auto;
-			union_auto = t2_auto;
-		}
-	}
+bool Driver::SampleModel(const std::string var_name, const unsigned long bound, std::string& model) {
+  auto model_ranker = GetModelRanker(var_name, bound);
+  if (model_ranker == nullptr) {
+    return false;
+  }
+  std::vector<bool> word;
+  if (not model_ranker->first->Sample(random_generator_, word)) {
+    LOG(ERROR)<< "there is no model to sample for: " << var_name;
+    return false;
+  }
+  model = GetModelAutomaton(model_ranker->second)->DecodeWord(word);
+  return true;
+}
 
-	var_name = "var_7";
-	auto v7_var = symbol_table_->get_variable(var_name);
-	auto v7_rep = symbol_table_->get_representative_variable_of_at_scope(script_,v7_var);
-	auto v7_all_solutions_val = symbol_table_->get_projected_value_at_scope(script_,v7_rep);
-
-	var_name = "var_6";
-	auto v6_var = symbol_table_->get_variable(var_name);
-	auto v6_rep = symbol_table_->get_representative_variable_of_at_scope(script_,v6_var);
-	auto v6_all_solutions_val = symbol_table_->get_projected_value_at_scope(script_,v6_rep);
-
-	Theory::StringAutomaton_ptr prefix_suffix_auto = Theory::StringAutomaton::MakePrefixSuffix(0,1,2,3);
-	auto prefix_multi = new Theory::StringAutomaton(v6_all_solutions_val->getStringAutomaton()->getDFA(),1,3,8);
-	auto temp_dfa = Theory::StringAutomaton::PrependLambda(v7_all_solutions_val->getStringAutomaton()->getDFA(),8);
-	auto suffix_multi = new Theory::StringAutomaton(temp_dfa,2,3,9);
-	dfaFree(temp_dfa);
-
-	auto intersect_multi = prefix_suffix_auto->Intersect(prefix_multi);
-	delete prefix_suffix_auto;
-	delete prefix_multi;
-	prefix_suffix_auto = intersect_multi;
-
-	intersect_multi = prefix_suffix_auto->Intersect(suffix_multi);
-	delete prefix_suffix_auto;
-	delete suffix_multi;
-
-	auto v8_multi = new Theory::StringAutomaton(union_auto->getDFA(),0,3,8);
-	auto v8_v7_v6_auto = intersect_multi->Intersect(v8_multi);
-	delete intersect_multi;
-	delete v8_multi;
-
-
-	auto v8_v7_v6_solutions = v8_v7_v6_auto->GetModelsWithinBound(num_models,-1);
-	for(int k = 0; k < v8_v7_v6_solutions["var_8"].size();k++) {
-		LOG(INFO) << "v8=" << v8_v7_v6_solutions["var_8"][k];
-		LOG(INFO) << "v6=" << v8_v7_v6_solutions["var_6"][k];
-		LOG(INFO) << "v7=" << v8_v7_v6_solutions["var_7"][k];
-		std::cin.get();
-	}
+Theory::BigInteger Driver::CountModelsForRanking(const std::string var_name, const unsigned long bound) {
+  auto model_ranker = GetModelRanker(var_name, bound);
+  if (model_ranker == nullptr) {
+    return 0;
+  }
+  return model_ranker->first->GetNumberOfModels();
+}
 
+bool Driver::RankModel(const std::string var_name, const std::string model, const unsigned long bound, Theory::BigInteger& rank) {
+  auto model_ranker = GetModelRanker(var_name, bound);
+  if (model_ranker == nullptr) {
+    return false;
+  }
+  std::vector<bool> word;
+  if (not GetModelAutomaton(model_ranker->second)->EncodeWord(model, model_ranker->first->GetMaxLength(), word)
+      or not model_ranker->first->Rank(word, rank)) {
+    LOG(ERROR)<< "not a model of " << var_name << " within the bound: " << model;
+    return false;
+  }
+  return true;
+}
 
-//	temp_multi = MakePrefixSuffix(0,1,2,3);
-//	prefix_multi = new StringAutomaton(prefix_dfa,1,3,var);
-//	temp_dfa = PrependLambda(suffix_dfa,var);
-//	suffix_multi = new StringAutomaton(temp_dfa,2,3,VAR_PER_TRACK);
-//	dfaFree(temp_dfa);
-//	intersect_multi = temp_multi->Intersect(prefix_multi);
-//	delete temp_multi;
-//	delete prefix_multi;
-//	temp_multi = intersect_multi;
-//	intersect_multi = temp_multi->Intersect(suffix_multi);
-//	delete temp_multi;
-//	delete suffix_multi;
-
-	auto start = std::chrono::steady_clock::now();
-	int count = 0;
-	for (const auto &variable_entry : getSatisfyingVariables()) {
-		if (variable_entry.second == nullptr or variable_values.find(variable_entry.first->getName()) != variable_values.end()) {
-			continue;
-		}
-		count++;
-		//LOG(INFO) << "Var name: " << variable_entry.first->getName();
-		switch (variable_entry.second->getType()) {
-
-//			case Vlab::Solver::Value::Type::BINARYINT_AUTOMATON: {
-//				auto binary_auto = variable_entry.second->getBinaryIntAutomaton();
-//				auto formula = binary_auto->GetFormula();
-//				model_counter_.add_symbolic_counter(binary_auto->GetSymbolicCounter());
-//				//LOG(INFO) << "Binary int with " << formula->GetNumberOfVariables() << " variables";
-//				//binary_auto->inspectAuto(false,true);
-//				//std::cin.get();
-//				auto res = binary_auto->GetModelsWithinBound(num_models,-1);
-//				for(auto iter : res) {
-////					LOG(INFO) << "Setting " << iter.first;
-//					variable_values[iter.first] = iter.second;
-//				}
-//
-//			}
-			case Vlab::Solver::Value::Type::STRING_AUTOMATON: {
-				auto string_auto = variable_entry.second->getStringAutomaton();
-				model_counter_.add_symbolic_counter(string_auto->GetSymbolicCounter());
-				//LOG(INFO) << "String int with " << string_auto->GetNumTracks() << " variables";
-				auto res = string_auto->GetModelsWithinBound(num_models,-1);
-				for(auto iter : res) {
-					//LOG(INFO) << "Setting " << iter.first;
-					variable_values[iter.first] = iter.second;
-				}
-				//string_auto->inspectAuto(false,true);
-				//std::cin.get();
-			}
-				break;
-//			case Vlab::Solver::Value::Type::INT_AUTOMATON: {
-//				auto int_auto = variable_entry.second->getIntAutomaton();
-//				model_counter_.add_symbolic_counter(int_auto->GetSymbolicCounter());
-//				int_auto->GetModelsWithinBound(num_models,-1);
-//			}
-//				break;
-			default:
-				break;
-		}
-	}
-	//LOG(INFO) << "NUM SAT VAR: " << count;
-
-	auto end = std::chrono::steady_clock::now();
-	auto t1 = end-start;
-	int sat = 0;
-
-	LOG(INFO) << "Getting models took " << std::chrono::duration<long double, std::milli>(t1).count() << " ms";
-
-	start = std::chrono::steady_clock::now();
-	symbol_table_->clear_variable_values();
-	symbol_table_->push_scope(script_);
-	for(auto var : variable_values) {
-		Theory::StringAutomaton_ptr union_val = nullptr,temp = nullptr;
-		for(auto str_val : var.second) {
-			temp = Theory::StringAutomaton::MakeString(str_val);
-			if(union_val == nullptr) {
-				union_val = temp;
-			} else {
-				auto res = union_val->Union(temp);
-				delete union_val;
-				delete temp;
-				union_val = res;
-			}
-		}
-		Theory::StringFormula_ptr str_formula = union_val->GetFormula();
-		str_formula->AddVariable(var.first,1);
-		str_formula->SetType(Theory::StringFormula::Type::VAR);
-		symbol_table_->set_value(var.first,new Solver::Value(union_val));
-	}
-	symbol_table_->pop_scope();
-	Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
-	constraint_solver.start();
-	if(symbol_table_->isSatisfiable()) {
-		LOG(INFO) << "SAT!";
-	}
-	end = std::chrono::steady_clock::now();
+bool Driver::UnrankModel(const std::string var_name, const Theory::BigInteger rank, const unsigned long bound, std::string& model) {
+  auto model_ranker = GetModelRanker(var_name, bound);
+  if (model_ranker == nullptr) {
+    return false;
+  }
+  std::vector<bool> word;
+  if (not model_ranker->first->Unrank(rank, word)) {
+    LOG(ERROR)<< "rank is out of range for " << var_name << ": " << rank;
+    return false;
+  }
+  model = GetModelAutomaton(model_ranker->second)->DecodeWord(word);
+  return true;
+}
 
+void Driver::ClearModelIterator(const std::string var_name) {
+  auto it = model_iterators_.find(var_name);
+  if (it != model_iterators_.end()) {
+    delete it->second.first;
+    delete it->second.second;
+    model_iterators_.erase(it);
+  }
+}
 
-	variable_values.clear();
-	for (const auto &variable_entry : getSatisfyingVariables()) {
-		if (variable_entry.second == nullptr or variable_values.find(variable_entry.first->getName()) != variable_values.end()) {
-			continue;
-		}
-		count++;
-		//LOG(INFO) << "Var name: " << variable_entry.first->getName();
-		switch (variable_entry.second->getType()) {
-
-//			case Vlab::Solver::Value::Type::BINARYINT_AUTOMATON: {
-//				auto binary_auto = variable_entry.second->getBinaryIntAutomaton();
-//				auto formula = binary_auto->GetFormula();
-//				model_counter_.add_symbolic_counter(binary_auto->GetSymbolicCounter());
-//				//LOG(INFO) << "Binary int with " << formula->GetNumberOfVariables() << " variables";
-//				//binary_auto->inspectAuto(false,true);
-//				//std::cin.get();
-//				auto res = binary_auto->GetModelsWithinBound(num_models,-1);
-//				for(auto iter : res) {
-////					LOG(INFO) << "Setting " << iter.first;
-//					variable_values[iter.first] = iter.second;
-//				}
-//
-//			}
-			case Vlab::Solver::Value::Type::STRING_AUTOMATON: {
-				auto string_auto = variable_entry.second->getStringAutomaton();
-				model_counter_.add_symbolic_counter(string_auto->GetSymbolicCounter());
-				//LOG(INFO) << "String int with " << string_auto->GetNumTracks() << " variables";
-				auto res = string_auto->GetModelsWithinBound(num_models,-1);
-				for(auto iter : res) {
-					//LOG(INFO) << "Setting " << iter.first;
-					variable_values[iter.first] = iter.second;
-				}
-				//string_auto->inspectAuto(false,true);
-				//std::cin.get();
-			}
-				break;
-//			case Vlab::Solver::Value::Type::INT_AUTOMATON: {
-//				auto int_auto = variable_entry.second->getIntAutomaton();
-//				model_counter_.add_symbolic_counter(int_auto->GetSymbolicCounter());
-//				int_auto->GetModelsWithinBound(num_models,-1);
-//			}
-//				break;
-			default:
-				break;
-		}
-	}
+/**
+ * Rankers are kept per variable for the last bound used, count vectors are computed once per bound.
+ * Returns nullptr if models are not supported for the variable.
+ */
+std::pair<Theory::ModelRanker_ptr, Solver::Value_ptr>* Driver::GetModelRanker(const std::string var_name, const unsigned long bound) {
+  auto it = model_rankers_.find(var_name);
+  if (it != model_rankers_.end()) {
+    if (it->second.first->GetBound() == bound) {
+      return &it->second;
+    }
+    delete it->second.first;
+    delete it->second.second;
+    model_rankers_.erase(it);
+  }
 
+  auto model_value = GetModelValue(var_name);
+  if (model_value == nullptr) {
+    return nullptr;
+  }
+  Theory::ModelRanker_ptr model_ranker = GetModelAutomaton(model_value)->GetModelRanker(bound);
+  return &(model_rankers_[var_name] = std::make_pair(model_ranker, model_value));
+}
 
-	start = std::chrono::steady_clock::now();
-	for(int model_index = 0; model_index < num_models; model_index++) {
-		symbol_table_->clear_variable_values();
-		symbol_table_->push_scope(script_);
+/**
+ * Copies the projected value of the variable, iterators and rankers work on the copy since the symbol table can
+ * change while models are read. Unconstrained variables and integer constants are turned into automata.
+ * Returns nullptr for an unknown variable or a value of any other type.
+ */
+Solver::Value_ptr Driver::GetModelValue(const std::string var_name) {
+  auto variable = symbol_table_->get_variable_unsafe(var_name);
+  if (variable == nullptr) {
+    LOG(ERROR)<< "variable is not found: " << var_name;
+    return nullptr;
+  }
+  auto representative_variable = symbol_table_->get_representative_variable_of_at_scope(script_, variable);
+  auto var_value = symbol_table_->get_projected_value_at_scope(script_, representative_variable);
 
-		for(auto var : variable_values) {
-			int safety_index = (model_index >= var.second.size()) ? var.second.size()-1 : model_index;
-			Theory::StringAutomaton_ptr str_auto = Theory::StringAutomaton::MakeString(var.second[safety_index]);
-			Theory::StringFormula_ptr str_formula = str_auto->GetFormula();
-			str_formula->AddVariable(var.first,1);
-			str_formula->SetType(Theory::StringFormula::Type::VAR);
-			symbol_table_->set_value(var.first,new Solver::Value(str_auto));
-		}
-		symbol_table_->pop_scope();
-		Solver::ConstraintSolver constraint_solver(script_, symbol_table_, constraint_information_);
-		constraint_solver.start();
-		if(symbol_table_->isSatisfiable()) {
-			sat++;
-		}
-		//LOG(INFO) << "sat? " << symbol_table_->isSatisfiable();
-		//std::cin.get();
-	}
-	end = std::chrono::steady_clock::now();
-	auto t2 = end-start;
+  if (var_value == nullptr) {
+    if (SMT::Variable::Type::STRING == variable->getType()) {
+      return new Solver::Value(Theory::StringAutomaton::MakeAnyString());
+    }
+    auto formula = new Theory::ArithmeticFormula();
+    formula->AddVariable(var_name, 1);
+    return new Solver::Value(Theory::BinaryIntAutomaton::MakeAnyInt(formula, not Option::Solver::USE_SIGNED_INTEGERS));
+  }
 
-	LOG(INFO) << "Checking models took " << std::chrono::duration<long double, std::milli>(t1).count() << " ms";
-	LOG(INFO) << "num sat  : " << sat;
-	LOG(INFO) << "num unsat: " << num_models - sat;
+  switch (var_value->getType()) {
+    case Solver::Value::Type::STRING_AUTOMATON:
+    case Solver::Value::Type::BINARYINT_AUTOMATON:
+      return var_value->clone();
+    case Solver::Value::Type::INT_CONSTANT: {
+      auto formula = new Theory::ArithmeticFormula();
+      formula->AddVariable(var_name, 1);
+      formula->SetConstant(-var_value->getIntConstant());
+      formula->SetType(Theory::ArithmeticFormula::Type::EQ);
+      return new Solver::Value(Theory::BinaryIntAutomaton::MakeAutomaton(formula, not Option::Solver::USE_SIGNED_INTEGERS));
+    }
+    default:
+      LOG(ERROR)<< "models are not supported for type: " << static_cast<int>(var_value->getType());
+      break;
+  }
+  return nullptr;
+}
 
+Theory::Automaton_ptr Driver::GetModelAutomaton(Solver::Value_ptr model_value) {
+  if (Solver::Value::Type::STRING_AUTOMATON == model_value->getType()) {
+    return model_value->getStringAutomaton();
+  }
+  return model_value->getBinaryIntAutomaton();
 }
 
 Theory::BigInteger Driver::CountVariable(const std::string var_name, const unsigned long bound) {
@@ -410,6 +389,43 @@ Theory::BigInteger Driver::Count(const unsigned long int_bound, const unsigned l
   return CountInts(int_bound) * CountStrs(str_bound);
 }
 
+std::vector<Theory::BigInteger> Driver::CountVariable(const std::string var_name, const std::vector<unsigned long>& bounds) {
+  auto tuple_counts = GetModelCounterForVariable(var_name,false).Count(bounds, bounds);
+  auto projected_counts = GetModelCounterForVariable(var_name,true).Count(bounds, bounds);
+  for (std::size_t i = 0; i < tuple_counts.size(); ++i) {
+    if (projected_counts[i] < tuple_counts[i]) {
+      tuple_counts[i] = projected_counts[i];
+    }
+  }
+  return tuple_counts;
+}
+
+double Driver::CountVariableLog2(const std::string var_name, const unsigned long bound) {
+  auto tuple_count = GetModelCounterForVariable(var_name,false).CountLog2(bound, bound);
+  auto projected_count = GetModelCounterForVariable(var_name,true).CountLog2(bound, bound);
+  return std::min(projected_count, tuple_count);
+}
+
+double Driver::CountIntsLog2(const unsigned long bound) {
+  return GetModelCounter().CountIntsLog2(bound);
+}
+
+double Driver::CountStrsLog2(const unsigned long bound) {
+  return GetModelCounter().CountStrsLog2(bound);
+}
+
+double Driver::CountLog2(const unsigned long int_bound, const unsigned long str_bound) {
+  return CountIntsLog2(int_bound) + CountStrsLog2(str_bound);
+}
+
+std::vector<Theory::BigInteger> Driver::CountInts(const std::vector<unsigned long>& bounds) {
+  return GetModelCounter().CountInts(bounds);
+}
+
+std::vector<Theory::BigInteger> Driver::CountStrs(const std::vector<unsigned long>& bounds) {
+  return GetModelCounter().CountStrs(bounds);
+}
+
 Solver::ModelCounter& Driver::GetModelCounterForVariable(const std::string var_name, bool project) {
   auto variable = symbol_table_->get_variable(var_name);
   auto representative_variable = symbol_table_->get_representative_variable_of_at_scope(script_, variable);
@@ -663,6 +679,18 @@ void Driver::reset() {
 	}
 	cached_bounded_values_.clear();
 
+  for (auto& entry : model_iterators_) {
+    delete entry.second.first;
+    delete entry.second.second;
+  }
+  model_iterators_.clear();
+
+  for (auto& entry : model_rankers_) {
+    delete entry.second.first;
+    delete entry.second.second;
+  }
+  model_rankers_.clear();
+
   delete symbol_table_;
   delete script_;
   script_ = nullptr;
@@ -728,6 +756,9 @@ void Driver::set_option(const Option::Name option, const int value) {
     case Option::Name::REGEX_FLAG:
       Util::RegularExpression::DEFAULT = value;
       break;
+    case Option::Name::OPERATION_CACHE_SIZE:
+      Theory::OperationCache::Instance().set_capacity(std::max(value, 0));
+      break;
     default:
       LOG(ERROR)<< "option is not recognized: " << static_cast<int>(option) << " -> " << value;
       break;
@@ -744,6 +775,10 @@ void Driver::set_option(const Option::Name option, const std::string value) {
       Option::Solver::SCRIPT_PATH = value;
       Option::Theory::SCRIPT_PATH = value;
       break;
+    case Option::Name::REGEX_CACHE_FILE:
+      Option::Theory::REGEX_CACHE_FILE = value;
+      Theory::RegexCache::Instance().Load(value);
+      break;
     default:
       LOG(ERROR)<< "option is not recognized: " << static_cast<int>(option) << " -> " << value;
       break;
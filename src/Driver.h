@@ -8,14 +8,17 @@
 #ifndef SRC_DRIVER_H_
 #define SRC_DRIVER_H_
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <random>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -45,7 +48,10 @@
 #include "theory/ArithmeticFormula.h"
 #include "theory/BinaryIntAutomaton.h"
 #include "theory/IntAutomaton.h"
+#include "theory/ModelIterator.h"
+#include "theory/ModelRanker.h"
 #include "theory/options/Theory.h"
+#include "theory/RegexCache.h"
 #include "theory/StringAutomaton.h"
 #include "theory/StringFormula.h"
 #include "theory/Formula.h"
@@ -77,12 +83,75 @@ public:
   void Solve();
   bool is_sat();
 
-  void GetModels(const unsigned long bound,const unsigned long num_models);
+  /**
+   * Writes up to num_models models for each variable in length-lexicographic order
+   * @param bound maximum length of a string, maximum number of bits of an integer
+   * @param num_models
+   * @param out
+   */
+  void GetModels(const unsigned long bound, const unsigned long num_models, std::ostream& out = std::cout);
+
+  /**
+   * Starts a streaming enumeration of the models of a variable
+   * @param var_name
+   * @param bound maximum length of a string, maximum number of bits of an integer
+   */
+  void InitializeModelIterator(const std::string var_name, const unsigned long bound);
+
+  /**
+   * Gets the next model of a variable whose model iterator is initialized
+   * @param var_name
+   * @param model
+   * @return false if there is no more model within the bound or the model iterator is not initialized
+   */
+  bool GetNextModel(const std::string var_name, std::string& model);
+
+  /**
+   * Draws a model of a variable uniformly at random among the models counted for the bound
+   * @param var_name
+   * @param bound
+   * @param model
+   * @return false if the variable has no model within the bound or models are not supported for it
+   */
+  bool SampleModel(const std::string var_name, const unsigned long bound, std::string& model);
+
+  /**
+   * Gets the number of models ranked for the bound, ranks are from 0 to this number; 0 if models are not supported
+   * for the variable
+   */
+  Theory::BigInteger CountModelsForRanking(const std::string var_name, const unsigned long bound);
+
+  /**
+   * Gets the rank of a model of a variable among the models counted for the bound
+   * @param var_name
+   * @param model
+   * @param bound
+   * @param rank
+   * @return false if the model is not a model of the variable within the bound
+   */
+  bool RankModel(const std::string var_name, const std::string model, const unsigned long bound, Theory::BigInteger& rank);
+
+  /**
+   * Gets the model of a variable with the given rank among the models counted for the bound
+   * @param var_name
+   * @param rank
+   * @param bound
+   * @param model
+   * @return false if the rank is not less than the number of models
+   */
+  bool UnrankModel(const std::string var_name, const Theory::BigInteger rank, const unsigned long bound, std::string& model);
 
   Theory::BigInteger CountVariable(const std::string var_name, const unsigned long bound);
   Theory::BigInteger CountInts(const unsigned long bound);
   Theory::BigInteger CountStrs(const unsigned long bound);
   Theory::BigInteger Count(const unsigned long int_bound, const unsigned long str_bound);
+  std::vector<Theory::BigInteger> CountVariable(const std::string var_name, const std::vector<unsigned long>& bounds);
+  double CountVariableLog2(const std::string var_name, const unsigned long bound);
+  double CountIntsLog2(const unsigned long bound);
+  double CountStrsLog2(const unsigned long bound);
+  double CountLog2(const unsigned long int_bound, const unsigned long str_bound);
+  std::vector<Theory::BigInteger> CountInts(const std::vector<unsigned long>& bounds);
+  std::vector<Theory::BigInteger> CountStrs(const std::vector<unsigned long>& bounds);
 
   Solver::ModelCounter& GetModelCounterForVariable(const std::string var_name, bool project = true);
   Solver::ModelCounter& GetModelCounter();
@@ -114,6 +183,10 @@ public:
 protected:
   void SetModelCounterForVariable(const std::string var_name, bool project = true);
   void SetModelCounter();
+  void ClearModelIterator(const std::string var_name);
+  std::pair<Theory::ModelRanker_ptr, Solver::Value_ptr>* GetModelRanker(const std::string var_name, const unsigned long bound);
+  Solver::Value_ptr GetModelValue(const std::string var_name);
+  Theory::Automaton_ptr GetModelAutomaton(Solver::Value_ptr model_value);
 
   bool is_model_counter_cached_;
   Solver::ModelCounter model_counter_;
@@ -132,6 +205,17 @@ protected:
    */
   std::map<std::string, Solver::Value_ptr> cached_bounded_values_;
 
+  /**
+   * Keeps model iterators for variables together with the values they iterate over
+   */
+  std::map<std::string, std::pair<Theory::ModelIterator_ptr, Solver::Value_ptr>> model_iterators_;
+
+  /**
+   * Keeps model rankers for variables together with the values they rank
+   */
+  std::map<std::string, std::pair<Theory::ModelRanker_ptr, Solver::Value_ptr>> model_rankers_;
+  std::mt19937_64 random_generator_;
+
 private:
   static bool IS_LOGGING_INITIALIZED;
 
@@ -12,6 +12,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <ratio>
 #include <sstream>
@@ -110,6 +111,12 @@ int main(const int argc, const char **argv) {
       str_bounds = parse_count_bounds(bounds_str);
       int_bounds = str_bounds;
       ++i;
+    } else if (argv[i] == std::string("--operation-cache-size")) {
+      driver.set_option(Vlab::Option::Name::OPERATION_CACHE_SIZE, std::stoi(argv[i + 1]));
+      ++i;
+    } else if (argv[i] == std::string("--regex-cache")) {
+      driver.set_option(Vlab::Option::Name::REGEX_CACHE_FILE, std::string(argv[i + 1]));
+      ++i;
     } else if (argv[i] == std::string("--get-models")) {
     	num_models = std::stoi(argv[i+1]);
     	++i;
@@ -151,6 +158,8 @@ int main(const int argc, const char **argv) {
       std::cout << std::setw(col) << "--limit-len-implications" << ": disables length implications for word equations" << std::endl;
       std::cout << std::setw(col) << "--enable-sorting" << ": enables sorting heuristics for string constraints" << std::endl;
       std::cout << std::setw(col) << "--disable-sorting" << ": disables sorting heuristics for string constraints" << std::endl;
+      std::cout << std::setw(col) << "--operation-cache-size <value>" << ": total number of states and bdd nodes of cached automata operation results, 0 disables the cache" << std::endl;
+      std::cout << std::setw(col) << "--regex-cache <path>" << ": loads compiled regular expressions from the file and saves new ones to it on exit" << std::endl;
       std::cout << std::setw(col) << "--output-dir <dir>" << ": used for debugging outputs" << std::endl;
       std::cout << std::setw(col) << "--log-dir <dir>" << ": redirect logs from stderr to files and saves in the directory specified." << std::endl;
       std::cout << std::setw(col) << "--v <value>" << ": sets verbose logging level, unless you build ABC with configure --disable-debug" << std::endl;
@@ -202,6 +211,9 @@ int main(const int argc, const char **argv) {
   auto end = std::chrono::steady_clock::now();
   auto solving_time = end - start;
   LOG(INFO) << "Done solving";
+  LOG(INFO) << Vlab::Theory::OperationCache::Instance().str();
+  LOG(INFO) << Vlab::Theory::FactoryCache::Instance().str();
+  LOG(INFO) << Vlab::Theory::RegexCache::Instance().str();
 
   std::cout << (driver.is_sat() ? "sat" : "unsat") << std::endl;
 
@@ -292,48 +304,48 @@ int main(const int argc, const char **argv) {
     LOG(INFO)<< "report is_sat: SAT time: " << std::chrono::duration <long double, std::milli> (solving_time).count() << " ms";
     if(num_models > 0) {
     	start = std::chrono::steady_clock::now();
-    	driver.GetModels(0,num_models);
+    	driver.GetModels(std::numeric_limits<unsigned long>::max(), num_models);
     	end = std::chrono::steady_clock::now();
     	auto count_time = end-start;
     	LOG(INFO) << "report get_models: " << num_models << " time: "
     	                  << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
     }
 
+    // all bounds are counted in one sweep, reported time is the time of the whole batch
+    auto report_counts = [](const std::vector<unsigned long>& bounds, const std::vector<Vlab::Theory::BigInteger>& counts,
+                            const std::chrono::steady_clock::duration count_time) {
+      for (std::size_t i = 0; i < bounds.size(); ++i) {
+        LOG(INFO) << "report bound: " << bounds[i] << " count: " << counts[i] << " time: "
+                  << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+      }
+    };
+
     if(not count_variable.empty()) {
       LOG(INFO) << "report var: " << count_variable;
-      for (auto b : int_bounds) {
+      if (not int_bounds.empty()) {
         start = std::chrono::steady_clock::now();
-        auto count_result = driver.CountVariable(count_variable, b);
+        auto count_results = driver.CountVariable(count_variable, int_bounds);
         end = std::chrono::steady_clock::now();
-        auto count_time = end - start;
-        LOG(INFO) << "report bound: " << b << " count: " << count_result << " time: "
-                  << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+        report_counts(int_bounds, count_results, end - start);
       }
-      for (auto b : str_bounds) {
+      if (not str_bounds.empty()) {
         start = std::chrono::steady_clock::now();
-        auto count_result = driver.CountVariable(count_variable, b);
+        auto count_results = driver.CountVariable(count_variable, str_bounds);
         end = std::chrono::steady_clock::now();
-        auto count_time = end - start;
-        LOG(INFO) << "report bound: " << b << " count: " << count_result << " time: "
-                  << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
-        
+        report_counts(str_bounds, count_results, end - start);
       }
     } else {
-      for (auto b : int_bounds) {
+      if (not int_bounds.empty()) {
         start = std::chrono::steady_clock::now();
-        auto count = driver.CountInts(b);
+        auto counts = driver.CountInts(int_bounds);
         end = std::chrono::steady_clock::now();
-        auto count_time = end - start;
-        LOG(INFO) << "report bound: " << b << " count: " << count << " time: "
-                  << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+        report_counts(int_bounds, counts, end - start);
       }
-      for (auto b : str_bounds) {
+      if (not str_bounds.empty()) {
         start = std::chrono::steady_clock::now();
-        auto count = driver.CountStrs(b);
+        auto counts = driver.CountStrs(str_bounds);
         end = std::chrono::steady_clock::now();
-        auto count_time = end - start;
-        LOG(INFO) << "report bound: " << b << " count: " << count << " time: "
-                  << std::chrono::duration<long double, std::milli>(count_time).count() << " ms";
+        report_counts(str_bounds, counts, end - start);
       }
     }
   } else {
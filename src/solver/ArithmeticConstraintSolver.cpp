@@ -159,6 +159,15 @@ void ArithmeticConstraintSolver::visitAnd(And_ptr and_term) {
 		}
 	}
 
+	// term values are collected per group, a group is intersected at once, smallest automata first, as soon as all of
+	// its terms are visited
+	std::map<std::string, std::vector<Value_ptr>> group_term_values;
+	std::map<std::string, int> group_remaining_terms;
+	for (auto term : *(and_term->term_list)) {
+		if (arithmetic_formula_generator_.get_term_formula(term) != nullptr and (dynamic_cast<Or_ptr>(term) == nullptr)) {
+			++group_remaining_terms[arithmetic_formula_generator_.get_term_group_name(term)];
+		}
+	}
 	for (auto term : *(and_term->term_list)) {
 		auto formula = arithmetic_formula_generator_.get_term_formula(term);
 		// Do not visit child or terms here, handle them in POSTVISIT AND
@@ -181,8 +190,12 @@ void ArithmeticConstraintSolver::visitAnd(And_ptr and_term) {
 					LOG(FATAL) << "Term has no group!";
 				}
 				//LOG(INFO) << "------------ " << *term << " has group name " << term_group_name;
-				symbol_table_->IntersectValue(term_group_name,param);
-				is_satisfiable = symbol_table_->get_value(term_group_name)->is_satisfiable();
+				auto& term_values = group_term_values[term_group_name];
+				term_values.push_back(param->clone());
+				if (--group_remaining_terms[term_group_name] == 0) {
+					symbol_table_->IntersectValues(term_group_name, term_values);
+					is_satisfiable = symbol_table_->get_value(term_group_name)->is_satisfiable();
+				}
 			}
 			clear_term_value(term);
 			if (not is_satisfiable) {
@@ -191,6 +204,17 @@ void ArithmeticConstraintSolver::visitAnd(And_ptr and_term) {
 		}
 	}
 
+	for (auto& entry : group_term_values) {
+		// groups left after the loop, i.e., a term is not counted above
+		if (is_satisfiable and group_remaining_terms[entry.first] > 0) {
+			symbol_table_->IntersectValues(entry.first, entry.second);
+			is_satisfiable = symbol_table_->get_value(entry.first)->is_satisfiable();
+		}
+		for (auto value : entry.second) {
+			delete value;
+		}
+	}
+
   DVLOG(VLOG_LEVEL) << "visit children of component end: " << *and_term << "@" << and_term;
 
   DVLOG(VLOG_LEVEL) << "post visit component start: " << *and_term << "@" << and_term;
@@ -452,17 +452,12 @@ void ConstraintSolver::visitNotEq(NotEq_ptr not_eq_term) {
     result = new Value(param_left->getIntConstant() not_eq param_right->getIntConstant());
   } else if (not (param_left->is_satisfiable() and param_right->is_satisfiable())) {
     result = new Value(false);
+  } else if (param_left->is_intersection_empty(param_right)) {
+    result = new Value(true);
+  } else if (param_left->isSingleValue() and param_right->isSingleValue()) {
+    result = new Value(false);
   } else {
-    Value_ptr intersection = param_left->intersect(param_right);
-    if (not intersection->is_satisfiable()) {
-      result = new Value(true);
-      delete intersection;
-    } else if(param_left->isSingleValue() and param_right->isSingleValue() and intersection->is_satisfiable()) {
-      result = new Value(false);
-      delete intersection;
-    } else {
-      result = intersection;
-    }
+    result = param_left->intersect(param_right);
   }
 
   setTermValue(not_eq_term, result);
@@ -42,9 +42,146 @@ void ModelCounter::add_symbolic_counter(const Theory::SymbolicCounter& counter)
 }
 
 
-Theory::BigInteger ModelCounter::CountInts(const unsigned long bound) {
+Theory::BigInteger ModelCounter::CountInts(const unsigned long bound) const {
+  return CountInts(bound, &Theory::SymbolicCounter::Count);
+}
+
+Theory::BigInteger ModelCounter::CountStrs(const unsigned long bound) const {
+  return CountStrs(bound, &Theory::SymbolicCounter::Count);
+}
+
+Theory::BigInteger ModelCounter::Count(const unsigned long int_bound, const unsigned long str_bound) const {
+  return CountInts(int_bound) * CountStrs(str_bound);
+}
+
+Theory::BigInteger ModelCounter::CountByMatrixMultiplication(const unsigned long int_bound, const unsigned long str_bound) const {
+  return CountInts(int_bound, &Theory::SymbolicCounter::CountbyMatrixMultiplication)
+      * CountStrs(str_bound, &Theory::SymbolicCounter::CountbyMatrixMultiplication);
+}
+
+double ModelCounter::CountIntsLog2(const unsigned long bound) const {
+  if (not IsConstantsInRange(bound)) {
+    return -std::numeric_limits<double>::infinity();
+  }
+
+  double result = 0;
+  for (const Theory::SymbolicCounter& counter : symbolic_counters_) {
+    if (Theory::SymbolicCounter::Type::STRING != counter.type()) {
+      result += counter.CountLog2(bound);
+    }
+  }
+
+  if (unconstraint_int_vars_ > 0) {
+    if (use_signed_integers_) {
+      // log2(2^(2 * bound) - 1)
+      result += unconstraint_int_vars_ * (2.0 * bound + std::log1p(-std::ldexp(1.0, -2 * static_cast<int>(bound))) / std::log(2.0));
+    } else {
+      result += static_cast<double>(unconstraint_int_vars_) * bound;
+    }
+  }
+  return result;
+}
+
+double ModelCounter::CountStrsLog2(const unsigned long bound) const {
+  double result = 0;
+  for (const Theory::SymbolicCounter& counter : symbolic_counters_) {
+    if (Theory::SymbolicCounter::Type::STRING == counter.type()) {
+      result += counter.CountLog2(bound);
+    }
+  }
+
+  if (unconstraint_str_vars_ > 0) {
+    if (count_bound_exact_) {
+      result += unconstraint_str_vars_ * 8.0 * bound;
+    } else {
+      // log2((256^(bound + 1) - 1) / 255)
+      result += unconstraint_str_vars_ * (8.0 * (bound + 1) + std::log1p(-std::ldexp(1.0, -8 * static_cast<int>(bound + 1))) / std::log(2.0)
+          - std::log2(255.0));
+    }
+  }
+  return result;
+}
+
+double ModelCounter::CountLog2(const unsigned long int_bound, const unsigned long str_bound) const {
+  return CountIntsLog2(int_bound) + CountStrsLog2(str_bound);
+}
+
+std::vector<Theory::BigInteger> ModelCounter::CountInts(const std::vector<unsigned long>& bounds) const {
+  std::vector<Theory::BigInteger> results (bounds.size(), 1);
+  for (const Theory::SymbolicCounter& counter : symbolic_counters_) {
+    if (Theory::SymbolicCounter::Type::STRING != counter.type()) {
+      auto counts = counter.CountBounds(bounds);
+      for (std::size_t i = 0; i < bounds.size(); ++i) {
+        results[i] = results[i] * counts[i];
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    if (IsConstantsInRange(bounds[i])) {
+      results[i] = results[i] * CountUnconstraintInts(bounds[i]);
+    } else {
+      results[i] = 0;
+    }
+  }
+  return results;
+}
+
+std::vector<Theory::BigInteger> ModelCounter::CountStrs(const std::vector<unsigned long>& bounds) const {
+  std::vector<Theory::BigInteger> results (bounds.size(), 1);
+  for (const Theory::SymbolicCounter& counter : symbolic_counters_) {
+    if (Theory::SymbolicCounter::Type::STRING == counter.type()) {
+      auto counts = counter.CountBounds(bounds);
+      for (std::size_t i = 0; i < bounds.size(); ++i) {
+        results[i] = results[i] * counts[i];
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    results[i] = results[i] * CountUnconstraintStrs(bounds[i]);
+  }
+  return results;
+}
+
+std::vector<Theory::BigInteger> ModelCounter::Count(const std::vector<unsigned long>& int_bounds, const std::vector<unsigned long>& str_bounds) const {
+  CHECK_EQ(int_bounds.size(), str_bounds.size());
+  auto results = CountInts(int_bounds);
+  auto str_results = CountStrs(str_bounds);
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    results[i] = results[i] * str_results[i];
+  }
+  return results;
+}
+
+Theory::BigInteger ModelCounter::CountInts(const unsigned long bound, CountFunction count) const {
+  if (not IsConstantsInRange(bound)) {
+    return 0; // no need to compute further
+  }
+
+  Theory::BigInteger result(1);
+  for (const Theory::SymbolicCounter& counter : symbolic_counters_) {
+    if (Theory::SymbolicCounter::Type::STRING != counter.type()) {
+      result = result * count(counter, bound);
+    }
+  }
+
+  return result * CountUnconstraintInts(bound);
+}
+
+Theory::BigInteger ModelCounter::CountStrs(const unsigned long bound, CountFunction count) const {
   Theory::BigInteger result(1);
 
+  for (const Theory::SymbolicCounter& counter : symbolic_counters_) {
+    if (Theory::SymbolicCounter::Type::STRING == counter.type()) {
+      result = result * count(counter, bound);
+    }
+  }
+
+  return result * CountUnconstraintStrs(bound);
+}
+
+bool ModelCounter::IsConstantsInRange(const unsigned long bound) const {
   for (int i : constant_ints_) {
     Theory::BigInteger value(i);
     auto shift = bound;
@@ -59,68 +196,48 @@ Theory::BigInteger ModelCounter::CountInts(const unsigned long bound) {
     }
 
     if (not (value <= upper_bound and value >= lower_bound)) {
-     return 0; // no need to compute further
-    }
-  }
-
-
-  for (Theory::SymbolicCounter& counter : symbolic_counters_) {
-    if (Theory::SymbolicCounter::Type::STRING != counter.type()) {
-      result = result * counter.Count(bound);
+      return false;
     }
   }
+  return true;
+}
 
+Theory::BigInteger ModelCounter::CountUnconstraintInts(const unsigned long bound) const {
+  Theory::BigInteger result(1);
   if (unconstraint_int_vars_ > 0) {
    if (use_signed_integers_) {
-     result = result
-            * boost::multiprecision::pow(
+     result = boost::multiprecision::pow(
                 (boost::multiprecision::pow(
                     boost::multiprecision::cpp_int(2),
                     (2 * bound)) - 1),
                 unconstraint_int_vars_);
    } else {
-     result = result
-         * boost::multiprecision::pow(boost::multiprecision::cpp_int(2),
+     result = boost::multiprecision::pow(boost::multiprecision::cpp_int(2),
                                       (unconstraint_int_vars_ * bound));
    }
   }
-
   return result;
 }
 
-Theory::BigInteger ModelCounter::CountStrs(const unsigned long bound) {
+Theory::BigInteger ModelCounter::CountUnconstraintStrs(const unsigned long bound) const {
   Theory::BigInteger result(1);
-
-  for (Theory::SymbolicCounter& counter : symbolic_counters_) {
-    if (Theory::SymbolicCounter::Type::STRING == counter.type()) {
-      result = result * counter.Count(bound);
-    }
-  }
-
   if (unconstraint_str_vars_ > 0) {
   	if(count_bound_exact_) {
   		Theory::BigInteger single_unconstraint_str_count = (boost::multiprecision::pow(
 				boost::multiprecision::cpp_int(256), bound));
-			result = result
-			 * boost::multiprecision::pow(single_unconstraint_str_count,
+			result = boost::multiprecision::pow(single_unconstraint_str_count,
 																		unconstraint_str_vars_);
   	} else {
 			Theory::BigInteger single_unconstraint_str_count = (boost::multiprecision::pow(
 				boost::multiprecision::cpp_int(256), (bound + 1)) - 1)
 						/ 255;
-			result = result
-			 * boost::multiprecision::pow(single_unconstraint_str_count,
+			result = boost::multiprecision::pow(single_unconstraint_str_count,
 																		unconstraint_str_vars_);
   	}
   }
-
   return result;
 }
 
-Theory::BigInteger ModelCounter::Count(const unsigned long int_bound, const unsigned long str_bound) {
-  return CountInts(int_bound) * CountStrs(str_bound);
-}
-
 std::string ModelCounter::str() const {
   std::stringstream ss;
   ss << "use signed integers: " << std::boolalpha << use_signed_integers_ << std::endl;
@@ -8,7 +8,9 @@
 #ifndef SRC_SOLVER_MODELCOUNTER_H_
 #define SRC_SOLVER_MODELCOUNTER_H_
 
+#include <cmath>
 #include <functional>
+#include <limits>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -33,9 +35,24 @@ class ModelCounter {
   void set_num_of_unconstraint_str_vars(int n);
   void add_constant(int c);
   void add_symbolic_counter(const Theory::SymbolicCounter& counter);
-  Theory::BigInteger CountInts(const unsigned long bound);
-  Theory::BigInteger CountStrs(const unsigned long bound);
-  Theory::BigInteger Count(const unsigned long int_bound, const unsigned long str_bound);
+  Theory::BigInteger CountInts(const unsigned long bound) const;
+  Theory::BigInteger CountStrs(const unsigned long bound) const;
+  Theory::BigInteger Count(const unsigned long int_bound, const unsigned long str_bound) const;
+  Theory::BigInteger CountByMatrixMultiplication(const unsigned long int_bound, const unsigned long str_bound) const;
+
+  /**
+   * Approximate log2 of counts, see SymbolicCounter::CountLog2; -infinity if there is no model.
+   */
+  double CountIntsLog2(const unsigned long bound) const;
+  double CountStrsLog2(const unsigned long bound) const;
+  double CountLog2(const unsigned long int_bound, const unsigned long str_bound) const;
+
+  /**
+   * Batch versions, each symbolic counter is swept once for all bounds.
+   */
+  std::vector<Theory::BigInteger> CountInts(const std::vector<unsigned long>& bounds) const;
+  std::vector<Theory::BigInteger> CountStrs(const std::vector<unsigned long>& bounds) const;
+  std::vector<Theory::BigInteger> Count(const std::vector<unsigned long>& int_bounds, const std::vector<unsigned long>& str_bounds) const;
 
   template <class Archive>
   void save(Archive& ar) const {
@@ -63,6 +80,13 @@ class ModelCounter {
   int unconstraint_str_vars_;
   std::vector<int> constant_ints_;
   std::vector<Theory::SymbolicCounter> symbolic_counters_;
+
+  using CountFunction = std::function<Theory::BigInteger(const Theory::SymbolicCounter&, const unsigned long)>;
+  Theory::BigInteger CountInts(const unsigned long bound, CountFunction count) const;
+  Theory::BigInteger CountStrs(const unsigned long bound, CountFunction count) const;
+  bool IsConstantsInRange(const unsigned long bound) const;
+  Theory::BigInteger CountUnconstraintInts(const unsigned long bound) const;
+  Theory::BigInteger CountUnconstraintStrs(const unsigned long bound) const;
 };
 
 } /* namespace Solver */
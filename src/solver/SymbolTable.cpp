@@ -451,6 +451,30 @@ bool SymbolTable::IntersectValue(Variable_ptr variable, Value_ptr value) {
   return res;
 }
 
+bool SymbolTable::IntersectValues(std::string var_name, const std::vector<Value_ptr>& values) {
+  return IntersectValues(get_variable(var_name), values);
+}
+
+/**
+ * Intersects old value of the variable with all new values at once
+ */
+bool SymbolTable::IntersectValues(Variable_ptr variable, const std::vector<Value_ptr>& values) {
+  std::vector<Value_ptr> operands;
+  Value_ptr variable_old_value = get_value(variable);
+  if (variable_old_value not_eq nullptr) {
+    operands.push_back(variable_old_value);
+  }
+  operands.insert(operands.end(), values.begin(), values.end());
+  if (operands.empty()) {
+    return true;
+  }
+
+  Value_ptr variable_new_value = Value::intersect(operands);
+  bool res = set_value(variable, variable_new_value);
+  delete variable_new_value;
+  return res;
+}
+
 bool SymbolTable::UnionValue(std::string var_name, Value_ptr value) {
   return UnionValue(get_variable(var_name), value);
 }
@@ -101,6 +101,8 @@ public:
   bool set_value(SMT::Variable_ptr variable, Value_ptr value);
   bool IntersectValue(std::string var_name, Value_ptr value);
   bool IntersectValue(SMT::Variable_ptr variable, Value_ptr value);
+  bool IntersectValues(std::string var_name, const std::vector<Value_ptr>& values);
+  bool IntersectValues(SMT::Variable_ptr variable, const std::vector<Value_ptr>& values);
   bool UnionValue(std::string var_name, Value_ptr value);
   bool UnionValue(SMT::Variable_ptr variable, Value_ptr value);
 
@@ -247,6 +247,37 @@ Value_ptr Value::intersect(Value_ptr other_value) const {
   return intersection_value;
 }
 
+Value_ptr Value::intersect(const std::vector<Value_ptr>& values) {
+  CHECK(not values.empty());
+  const Type type = values.front()->type;
+  bool has_same_type = true;
+  for (auto value : values) {
+    has_same_type = has_same_type and (value->type == type);
+  }
+
+  if (has_same_type and Type::STRING_AUTOMATON == type) {
+    std::vector<Theory::StringAutomaton_ptr> automata;
+    for (auto value : values) {
+      automata.push_back(value->string_automaton);
+    }
+    return new Value(Theory::StringAutomaton::Intersect(automata));
+  } else if (has_same_type and Type::BINARYINT_AUTOMATON == type) {
+    std::vector<Theory::BinaryIntAutomaton_ptr> automata;
+    for (auto value : values) {
+      automata.push_back(value->binaryint_automaton);
+    }
+    return new Value(Theory::BinaryIntAutomaton::Intersect(automata));
+  }
+
+  Value_ptr intersection_value = values.front()->clone();
+  for (auto it = values.begin() + 1; it != values.end() and intersection_value->is_satisfiable(); ++it) {
+    Value_ptr tmp_value = intersection_value;
+    intersection_value = tmp_value->intersect(*it);
+    delete tmp_value;
+  }
+  return intersection_value;
+}
+
 Value_ptr Value::complement() const {
   Value_ptr complement_value = nullptr;
   switch (type) {
@@ -439,6 +470,19 @@ Value_ptr Value::minus(Value_ptr other_value) const {
   return result;
 }
 
+bool Value::is_intersection_empty(Value_ptr other_value) const {
+  if (Type::STRING_AUTOMATON == type and Type::STRING_AUTOMATON == other_value->type
+      and string_automaton->GetNumTracks() == other_value->string_automaton->GetNumTracks()) {
+    return string_automaton->IsIntersectionEmpty(other_value->string_automaton);
+  } else if (Type::BINARYINT_AUTOMATON == type and Type::BINARYINT_AUTOMATON == other_value->type) {
+    return binaryint_automaton->IsIntersectionEmpty(other_value->binaryint_automaton);
+  }
+  Value_ptr intersection_value = this->intersect(other_value);
+  bool result = not intersection_value->is_satisfiable();
+  delete intersection_value;
+  return result;
+}
+
 bool Value::is_satisfiable() {
   bool is_satisfiable = false;
   switch (type) {
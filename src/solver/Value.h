@@ -10,6 +10,7 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -72,6 +73,11 @@ class Value {
 
   Value_ptr union_(Value_ptr other_value) const;
   Value_ptr intersect(Value_ptr other_value) const;
+
+  /**
+   * Intersects all values at once, string and binary int automata use n-ary intersection.
+   */
+  static Value_ptr intersect(const std::vector<Value_ptr>& values);
   Value_ptr complement() const;
   Value_ptr difference(Value_ptr other_value) const;
 
@@ -81,6 +87,12 @@ class Value {
   Value_ptr minus(Value_ptr other_value) const;
 
   bool is_satisfiable();bool isSingleValue();
+
+  /**
+   * Checks if the intersection with the other value is unsatisfiable, automata with matching
+   * tracks are checked on the fly without building the product.
+   */
+  bool is_intersection_empty(Value_ptr other_value) const;
   std::string getASatisfyingExample();
 
   class Name {
@@ -34,7 +34,9 @@ enum class Name: int {
 	COUNT_BOUND_EXACT,
   REGEX_FLAG,
   OUTPUT_PATH,
-  SCRIPT_PATH
+  SCRIPT_PATH,
+  OPERATION_CACHE_SIZE,
+  REGEX_CACHE_FILE
 };
 
 class Solver {
@@ -12,6 +12,8 @@ namespace Theory {
 
 const int Automaton::VLOG_LEVEL = 9;
 
+const int Automaton::MAX_CHAR_RANGE_BITS = 16;
+
 int Automaton::name_counter = 0;
 int Automaton::next_state = 0;
 
@@ -19,6 +21,7 @@ unsigned long Automaton::next_id = 0;
 
 std::unordered_map<int, int*> Automaton::bdd_variable_indices;
 bool Automaton::count_bound_exact_;
+thread_local int Automaton::minimization_deferral_depth_ = 0;
 
 const std::string Automaton::Name::NONE = "none";
 const std::string Automaton::Name::BOOL = "BoolAutomaton";
@@ -28,24 +31,26 @@ const std::string Automaton::Name::STRING = "StringAutomaton";
 const std::string Automaton::Name::BINARYINT = "BinaryIntAutomaton";
 
 Automaton::Automaton(Automaton::Type type)
-        : type_(type), is_counter_cached_{false}, dfa_(nullptr), num_of_bdd_variables_(0), id_(Automaton::next_id++) {
+        : id_(Automaton::next_id++), type_(type), is_counter_cached_{false}, num_of_bdd_variables_(0), dfa_(nullptr),
+          is_minimized_(false) {
 }
 
-Automaton::Automaton(Automaton::Type type, DFA_ptr dfa, int num_of_variables)
-        : type_(type), is_counter_cached_{false}, dfa_(dfa), num_of_bdd_variables_(num_of_variables), id_(Automaton::next_id++) { }
+Automaton::Automaton(Automaton::Type type, DFA_ptr dfa, int num_of_variables, const bool is_minimized)
+        : id_(Automaton::next_id++), type_(type), is_counter_cached_{false}, num_of_bdd_variables_(num_of_variables),
+          dfa_(nullptr), is_minimized_(false) {
+  set_dfa(dfa, is_minimized);
+}
 
+/**
+ * Copies share the dfa, it is copied only when one of them changes it
+ */
 Automaton::Automaton(const Automaton& other)
-        : type_(other.type_), is_counter_cached_{false}, dfa_(nullptr), num_of_bdd_variables_(other.num_of_bdd_variables_), id_(Automaton::next_id++) {
-          if (other.dfa_)
-          {
-            dfa_ = dfaCopy(other.dfa_);
-          }
+        : id_(Automaton::next_id++), type_(other.type_), is_counter_cached_{false},
+          num_of_bdd_variables_(other.num_of_bdd_variables_), dfa_(other.dfa_), shared_dfa_(other.shared_dfa_),
+          is_minimized_(other.is_minimized_), metadata_(other.metadata_), char_range_index_(other.char_range_index_) {
 }
 
 Automaton::~Automaton() {
-	if(dfa_ != nullptr) {
-		dfaFree(dfa_);
-	}
 //  DVLOG(VLOG_LEVEL) << "deleted " << " [" << this->id_ << "]";
 }
 
@@ -93,7 +98,7 @@ int Automaton::get_number_of_bdd_variables() {
 }
 
 bool Automaton::IsEmptyLanguage() const {
-  bool result = DFAIsMinimizedEmtpy(this->dfa_);
+  bool result = DFAIsMinimizedEmtpy(this->dfa_) or (not is_minimized_ and DFAIsEmpty(this->dfa_));
   DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->IsEmptyLanguage() " << std::boolalpha << result;
   return result;
 }
@@ -137,6 +142,18 @@ bool Automaton::IsEqual(const Automaton_ptr other_automaton) const {
   return result;
 }
 
+bool Automaton::IsIntersectionEmpty(const Automaton_ptr other_automaton) const {
+  bool result = Automaton::DFAIsIntersectionEmpty(this->dfa_, other_automaton->dfa_);
+  DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->IsIntersectionEmpty("<< other_automaton->id_ <<  ")" << std::boolalpha << result;
+  return result;
+}
+
+bool Automaton::IsSubsetOf(const Automaton_ptr other_automaton) const {
+  bool result = Automaton::DFAIsSubset(this->dfa_, other_automaton->dfa_);
+  DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->IsSubsetOf("<< other_automaton->id_ <<  ")" << std::boolalpha << result;
+  return result;
+}
+
 int Automaton::GetInitialState() const {
   int initial_state = Automaton::DFAGetInitialState(this->dfa_);
   DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->GetInitialState() = " << initial_state;
@@ -144,14 +161,16 @@ int Automaton::GetInitialState() const {
 }
 
 int Automaton::GetSinkState() const {
-  int sink_state = Automaton::DFAGetSinkState(this->dfa_);
+  int sink_state = GetMetadata().sink_state;
   //DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->GetSinkState() = " << sink_state;
   return sink_state;
 }
 
 Automaton_ptr Automaton::Complement() {
   DFA_ptr complement_dfa = Automaton::DFAComplement(this->dfa_);
-  Automaton_ptr complement_auto = MakeAutomaton(complement_dfa, this->GetFormula()->Complement(), num_of_bdd_variables_);
+  Automaton_ptr complement_auto = MakeAutomaton(nullptr, this->GetFormula()->Complement(), num_of_bdd_variables_);
+  // negation keeps a minimal dfa minimal
+  complement_auto->set_dfa(complement_dfa, is_minimized_);
   DVLOG(VLOG_LEVEL) << complement_auto->id_ << " = [" << this->id_ << "]->Complement()";
   return complement_auto;
 }
@@ -160,8 +179,11 @@ Automaton_ptr Automaton::Union(Automaton_ptr other_automaton) {
 	if(this->num_of_bdd_variables_ != other_automaton->num_of_bdd_variables_) {
 		LOG(FATAL) << "number of variables does not match between both automaton!";
 	}
-	DFA_ptr union_dfa = Automaton::DFAUnion(this->dfa_, other_automaton->dfa_);
-  Automaton_ptr union_auto = MakeAutomaton(union_dfa, this->GetFormula()->Union(other_automaton->GetFormula()), num_of_bdd_variables_);
+	auto union_dfa = GetOrComputeDFA(OperationCache::Operation::UNION, {this, other_automaton}, {}, [this, other_automaton]() {
+    return Automaton::DFAUnion(this->dfa_, other_automaton->dfa_);
+  });
+  Automaton_ptr union_auto = MakeAutomaton(nullptr, this->GetFormula()->Union(other_automaton->GetFormula()), num_of_bdd_variables_);
+  union_auto->ShareDFA(union_dfa, not IsMinimizationDeferred());
   DVLOG(VLOG_LEVEL) << union_auto->id_ << " = [" << this->id_ << "]->Union(" << other_automaton->id_ << ")";
   return union_auto;
 }
@@ -170,8 +192,12 @@ Automaton_ptr Automaton::Intersect(Automaton_ptr other_automaton) {
 	if(this->num_of_bdd_variables_ != other_automaton->num_of_bdd_variables_) {
 		LOG(FATAL) << "number of variables does not match between both automaton!";
 	}
-	DFA_ptr intersect_dfa = Automaton::DFAIntersect(this->dfa_, other_automaton->dfa_);
-  Automaton_ptr intersect_auto =  MakeAutomaton(intersect_dfa, this->GetFormula()->Intersect(other_automaton->GetFormula()), num_of_bdd_variables_);
+	auto intersect_dfa = GetOrComputeDFA(OperationCache::Operation::INTERSECT, {this, other_automaton}, {},
+      [this, other_automaton]() {
+    return Automaton::DFAIntersect(this->dfa_, other_automaton->dfa_);
+  });
+  Automaton_ptr intersect_auto =  MakeAutomaton(nullptr, this->GetFormula()->Intersect(other_automaton->GetFormula()), num_of_bdd_variables_);
+  intersect_auto->ShareDFA(intersect_dfa, not IsMinimizationDeferred());
   DVLOG(VLOG_LEVEL) << intersect_auto->id_ << " = [" << this->id_ << "]->Intersect(" << other_automaton->id_ << ")";
   return intersect_auto;
 }
@@ -181,7 +207,8 @@ Automaton_ptr Automaton::Difference(Automaton_ptr other_automaton) {
 		LOG(FATAL) << "number of variables does not match between both automaton!";
 	}
 	DFA_ptr difference_dfa = Automaton::DFADifference(this->dfa_, other_automaton->dfa_);
-  Automaton_ptr difference_auto = MakeAutomaton(difference_dfa, this->GetFormula()->Intersect(other_automaton->GetFormula()), num_of_bdd_variables_);
+  Automaton_ptr difference_auto = MakeAutomaton(nullptr, this->GetFormula()->Intersect(other_automaton->GetFormula()), num_of_bdd_variables_);
+  difference_auto->set_dfa(difference_dfa, true);
   DVLOG(VLOG_LEVEL) << difference_auto->id_ << " = [" << this->id_ << "]->Difference(" << other_automaton->id_ << ")";
   return difference_auto;
 }
@@ -240,25 +267,41 @@ Automaton_ptr Automaton::Concat(Automaton_ptr other_automaton) {
 }
 
 bool Automaton::isCyclic() {
-  bool result = false;
-  std::map<int, bool> is_discovered;
-  std::map<int, bool> is_stack_member;
-  int sink_state = GetSinkState();
-  is_discovered[sink_state] = true; // avoid sink state
-
-  result = isCyclic(this->dfa_->s, is_discovered, is_stack_member);
+  bool result = GetMetadata().is_cyclic;
   DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->isCyclic() ? " << std::boolalpha << result;
   return result;
 }
 
 bool Automaton::isInCycle(int state) {
-  std::map<int, bool> is_stack_member;
-  return isStateReachableFrom(state, state, is_stack_member);
+  return GetMetadata().is_in_cycle[state];
 }
 
+/**
+ * Checks if search state is reachable with at least one transition, paths do not go through sink states
+ */
 bool Automaton::isStateReachableFrom(int search_state, int from_state) {
-  std::map<int, bool> is_stack_member;
-  return isStateReachableFrom(search_state, from_state, is_stack_member);
+  const Metadata& metadata = GetMetadata();
+  // successors never have a larger scc id
+  if (metadata.scc_ids[search_state] > metadata.scc_ids[from_state]) {
+    return false;
+  }
+
+  std::vector<bool> is_visited (this->dfa_->ns, false);
+  std::stack<int> states;
+  states.push(from_state);
+  while (not states.empty()) {
+    const int state = states.top();
+    states.pop();
+    for (int next_state : metadata.next_states[state]) {
+      if (next_state == search_state) {
+        return true;
+      } else if ((not is_visited[next_state]) and (not IsSinkState(next_state))) {
+        is_visited[next_state] = true;
+        states.push(next_state);
+      }
+    }
+  }
+  return false;
 }
 
 BigInteger Automaton::Count(const unsigned long bound) {
@@ -292,23 +335,27 @@ BigInteger Automaton::CountByMatrixMultiplication(unsigned long bound) {
   return result;
 }
 
+/**
+ * Counting with the linear recurrence of the count sequence, works for arbitrary large bounds
+ */
 BigInteger Automaton::SymbolicCount(int bound, bool count_less_than_or_equal_to_bound) {
-  std::stringstream cmd;
-  std::string str_result;
-  std::string tmp_math_file = Option::Theory::TMP_PATH + "/math_script.m";
-  std::ofstream out_file(tmp_math_file.c_str());
-
-  generateMatrixScript(bound, out_file, count_less_than_or_equal_to_bound);
-//  generateGFScript(bound, out_file, count_less_than_or_equal_to_bound);
-  cmd << "math -script " << tmp_math_file;
-  try {
-    DVLOG(VLOG_LEVEL) << "run_cmd(`" << cmd.str() << "`)";
-    str_result = Util::Cmd::run_cmd(cmd.str());
-  } catch (std::string& e) {
-    LOG(ERROR) << e;
+  if (not is_counter_cached_) {
+    SetSymbolicCounter();
   }
 
-  return BigInteger (str_result);
+  BigInteger result;
+  if (count_less_than_or_equal_to_bound == (not count_bound_exact_)) {
+    result = counter_.CountbyRecurrence(bound);
+  } else if (count_less_than_or_equal_to_bound) {
+    result = counter_.SumbyRecurrence(bound);
+  } else {
+    result = counter_.CountbyRecurrence(bound);
+    if (bound > 0) {
+      result = result - counter_.CountbyRecurrence(bound - 1);
+    }
+  }
+  DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->symbolic_count(" << bound << ") : " << result;
+  return result;
 }
 
 BigInteger Automaton::SymbolicCount(double bound, bool count_less_than_or_equal_to_bound) {
@@ -325,52 +372,7 @@ std::map<std::string,std::vector<std::string>> Automaton::GetModelsWithinBound(i
 		bound = counter.GetMinBound(num_models);
 	}
 
-//	LOG(INFO) << "bound : " << bound;
-//	LOG(INFO) << "models: " << num_models;
-
-	// compute BFS for unweighted graph (dfa)
-	std::queue<int> states_to_process;
-	std::vector<int> distances(this->dfa_->ns,INT_MAX);
-	std::set<int> final_states;
-
-	std::vector<int> shortest_accepting_path(this->dfa_->ns,INT_MAX);
-	for(int start_state = 0; start_state < this->dfa_->ns; start_state++) {
-		distances[start_state] = 0;
-		states_to_process.push(start_state);
-
-		while(not states_to_process.empty()) {
-			int s = states_to_process.front();
-			states_to_process.pop();
-			// mark final states for later
-			if(this->dfa_->f[s] == 1) {
-				final_states.insert(s);
-			}
-
-			for(auto iter : getNextStates(s)) {
-				if(distances[iter] == INT_MAX) {
-					states_to_process.push(iter);
-					distances[iter] = distances[s] + 1;
-				}
-			}
-		}
-
-		int shortest = INT_MAX;
-		for(auto final : final_states) {
-			if(distances[final] < shortest) {
-				shortest = distances[final];
-			}
-		}
-		shortest_accepting_path[start_state] = shortest;
-
-
-		distances = std::vector<int>(this->dfa_->ns,INT_MAX);
-	}
-
-//	for(int i = 0; i < this->dfa_->ns; i++) {
-//		LOG(INFO) << "shortest path for state " << i << " = " << shortest_accepting_path[i];
-//	}
-//
-//	LOG(INFO) << "Done computing shortest paths to final state";
+	const std::vector<int>& shortest_accepting_path = GetMetadata().distance_to_accepting;
 
 	// assume num_tracks > 1; Otherwise, juse call normal version
 	int models_so_far = 0;
@@ -606,40 +608,59 @@ std::map<std::string,std::vector<std::string>> Automaton::GetModelsWithinBound(i
 	return variable_values;
 }
 
-void Automaton::SetCountBoundExact(bool value) {
-	count_bound_exact_ = value;
+ModelIterator_ptr Automaton::GetModelIterator(const unsigned long bound) const {
+  return new ModelIterator(shared_dfa_, num_of_bdd_variables_, bound);
 }
 
-bool Automaton::isCyclic(int state, std::map<int, bool>& is_discovered, std::map<int, bool>& is_stack_member) {
-  if (not is_discovered[state]) {
-    is_discovered[state] = true;
-    is_stack_member[state] = true;
-    for (auto next_state : getNextStates(state)) {
-      if ((not is_discovered[next_state]) and isCyclic(next_state, is_discovered, is_stack_member)) {
-        return true;
-      } else if (is_stack_member[next_state]) {
-        return true;
-      }
-    }
-  }
-  is_stack_member[state] = false;
-  return false;
+ModelRanker_ptr Automaton::GetModelRanker(const unsigned long bound) {
+  return new ModelRanker(shared_dfa_, num_of_bdd_variables_, GetSymbolicCounter(), bound);
+}
+
+bool Automaton::DecodeModel(const std::vector<bool>& word, std::string& model) const {
+  model = DecodeWord(word);
+  return true;
 }
 
-bool Automaton::isStateReachableFrom(int search_state, int from_state, std::map<int, bool>& is_stack_member) {
-  is_stack_member[from_state] = true;
+std::string Automaton::DecodeWord(const std::vector<bool>& word) const {
+  std::string model;
+  model.reserve(word.size());
+  for (bool bit : word) {
+    model.push_back(bit ? '1' : '0');
+  }
+  return model;
+}
 
-  for (auto next_state : getNextStates(from_state)) {
-    if (next_state == search_state) {
-      return true;
-    } else if ((not is_stack_member[next_state]) and (not IsSinkState(next_state)) and
-      isStateReachableFrom(search_state, next_state, is_stack_member)) {
-      return true;
+bool Automaton::EncodeWord(const std::string& model, const unsigned long number_of_symbols, std::vector<bool>& word) const {
+  word.clear();
+  word.reserve(model.size());
+  for (char c : model) {
+    if (c != '0' and c != '1') {
+      DVLOG(VLOG_LEVEL) << "model is not a bit string: " << model;
+      return false;
     }
+    word.push_back(c == '1');
   }
+  return true;
+}
 
-  is_stack_member[from_state] = false;
-  return false;
+void Automaton::SetCountBoundExact(bool value) {
+	count_bound_exact_ = value;
+}
+
+Automaton::MinimizationDeferral::MinimizationDeferral() {
+  ++minimization_deferral_depth_;
+}
+
+Automaton::MinimizationDeferral::~MinimizationDeferral() {
+  --minimization_deferral_depth_;
+}
+
+bool Automaton::IsMinimizationDeferred() {
+  return minimization_deferral_depth_ > 0;
+}
+
+bool Automaton::IsMinimized() const {
+  return is_minimized_;
 }
 
 /**
@@ -679,6 +700,22 @@ Graph_ptr Automaton::toGraph() {
  * Assumes automaton is minimized and there is a sink state
  * @returns true if automaton is a singleton
  */
+bool Automaton::isAcceptingWord(const std::vector<bool>& word, const std::size_t number_of_symbols) const {
+  CHECK_LE(number_of_symbols * num_of_bdd_variables_, word.size());
+  unsigned p, l, r, index; // BDD traversal variables
+  int state = this->dfa_->s;
+  for (std::size_t i = 0; i < number_of_symbols; ++i) {
+    p = this->dfa_->q[state];
+    LOAD_lri(&this->dfa_->bddm->node_table[p], l, r, index);
+    while (index != BDD_LEAF_INDEX) {
+      p = word[i * num_of_bdd_variables_ + index] ? r : l;
+      LOAD_lri(&this->dfa_->bddm->node_table[p], l, r, index);
+    }
+    state = l;
+  }
+  return this->dfa_->f[state] == 1;
+}
+
 bool Automaton::isAcceptingSingleWord() {
   unsigned p, l, r, index; // BDD traversal variables
   std::map<unsigned, unsigned> next_states;
@@ -730,18 +767,27 @@ bool Automaton::isAcceptingSingleWord() {
   return is_accepting_single_word;
 }
 
+/**
+ * Follows transitions that decrease the distance to an accepting state, hence finds a shortest accepting word
+ */
 std::vector<bool>* Automaton::getAnAcceptingWord(std::function<bool(unsigned& index)> next_node_heuristic) {
-  int sink_state = GetSinkState();
-  NextState start_state = std::make_pair(this->dfa_->s, std::vector<bool>());
-  std::vector<bool>* bit_vector = new std::vector<bool>();
-  std::map<int, bool> is_stack_member;
-  is_stack_member[sink_state] = true;
-
-  if (getAnAcceptingWord(start_state, is_stack_member, *bit_vector, next_node_heuristic)) {
-    return bit_vector;
+  const Metadata& metadata = GetMetadata();
+  int state = this->dfa_->s;
+  if (metadata.distance_to_accepting[state] == INT_MAX) {
+    return nullptr;
   }
 
-  return nullptr;
+  std::vector<bool>* bit_vector = new std::vector<bool>();
+  while (metadata.distance_to_accepting[state] > 0) {
+    for (auto& next_state : getNextStatesOrdered(state, next_node_heuristic)) {
+      if (metadata.distance_to_accepting[next_state.first] == metadata.distance_to_accepting[state] - 1) {
+        bit_vector->insert(bit_vector->end(), next_state.second.begin(), next_state.second.end());
+        state = next_state.first;
+        break;
+      }
+    }
+  }
+  return bit_vector;
 }
 
 std::vector<bool>* Automaton::getAnAcceptingWordRandom(std::function<bool(unsigned& index)> next_node_heuristic) {
@@ -804,29 +850,6 @@ std::vector<char> Automaton::decodeException(std::vector<char>& exception) {
   return decoded_exceptions_in_ascii;
 }
 
-bool Automaton::getAnAcceptingWord(NextState& state, std::map<int, bool>& is_stack_member, std::vector<bool>& path, std::function<bool(unsigned& index)> next_node_heuristic) {
-  is_stack_member[state.first] = true;
-  path.insert(path.end(), state.second.begin(), state.second.end());
-
-
-  if (this->IsAcceptingState(state.first)) {
-    return true;
-  }
-
-
-  for (auto& next_state : getNextStatesOrdered(state.first, next_node_heuristic)) {
-    if (not is_stack_member[next_state.first]) {
-      if (getAnAcceptingWord(next_state, is_stack_member, path, next_node_heuristic)) {
-        return true;
-      }
-    }
-  }
-
-  path.erase(path.end() - state.second.size(), path.end());
-  is_stack_member[state.first] = false;
-  return false;
-}
-
 char* Automaton::getAnExample(bool accepting) {
   return dfaMakeExample(this->dfa_, 1, num_of_bdd_variables_, (unsigned*)GetBddVariableIndices(num_of_bdd_variables_));
 }
@@ -847,16 +870,43 @@ bool Automaton::DFAIsMinimizedEmtpy(const DFA_ptr minimized_dfa) {
     return (minimized_dfa->ns == 1 && minimized_dfa->f[minimized_dfa->s] == -1)? true : false;
 }
 
-// TODO implement general is empty function
+/**
+ * Depth first search from the initial state over the leaves of the transition bdds
+ */
 bool Automaton::DFAIsEmpty(const DFA_ptr dfa) {
-  bool result = false;
-  for (int s = 0; s < dfa->ns; ++s) {
-    if (DFAIsAcceptingState(dfa, s)) {
-      // check if the accepting state is reachable
-      LOG(FATAL) << "Not implemented";
+  if (DFAIsMinimizedEmtpy(dfa)) {
+    return true;
+  }
+
+  unsigned p, l, r, index; // BDD traversal variables
+  std::vector<bool> is_visited (dfa->ns, false);
+  std::stack<int> states;
+  std::stack<unsigned> nodes;
+  is_visited[dfa->s] = true;
+  states.push(dfa->s);
+  while (not states.empty()) {
+    const int state = states.top();
+    states.pop();
+    if (dfa->f[state] == 1) {
+      return false;
+    }
+    nodes.push(dfa->q[state]);
+    while (not nodes.empty()) {
+      p = nodes.top();
+      nodes.pop();
+      LOAD_lri(&dfa->bddm->node_table[p], l, r, index);
+      if (index == BDD_LEAF_INDEX) {
+        if (not is_visited[l]) {
+          is_visited[l] = true;
+          states.push(l);
+        }
+      } else {
+        nodes.push(l);
+        nodes.push(r);
+      }
     }
   }
-  return result;
+  return true;
 }
 
 bool Automaton::DFAIsMinimizedOnlyAcceptingEmptyInput(const DFA_ptr minimized_dfa) {
@@ -910,17 +960,91 @@ bool Automaton::DFAIsOneStepAway(const DFA_ptr dfa, const int from_state, const
 }
 
 bool Automaton::DFAIsEqual(const DFA_ptr dfa1, const DFA_ptr dfa2) {
-  DFA_ptr impl_1 = dfaProduct(dfa1, dfa2, dfaIMPL);
-  DFA_ptr impl_2 = dfaProduct(dfa2, dfa1, dfaIMPL);
-  DFA_ptr result_dfa = dfaProduct(impl_1,impl_2,dfaAND);
-  dfaFree(impl_1);
-  dfaFree(impl_2);
-  dfaNegation(result_dfa);
-  DFA_ptr minimized_dfa = dfaMinimize(result_dfa);
-  dfaFree(result_dfa);
-  bool result = DFAIsMinimizedEmtpy(minimized_dfa);
-  dfaFree(minimized_dfa);
-  return result;
+  return not Automaton::DFAHasProductWitness(dfa1, dfa2, ProductWitness::SYMMETRIC_DIFFERENCE);
+}
+
+bool Automaton::DFAIsIntersectionEmpty(const DFA_ptr dfa1, const DFA_ptr dfa2) {
+  return not Automaton::DFAHasProductWitness(dfa1, dfa2, ProductWitness::INTERSECTION);
+}
+
+bool Automaton::DFAIsSubset(const DFA_ptr dfa1, const DFA_ptr dfa2) {
+  return not Automaton::DFAHasProductWitness(dfa1, dfa2, ProductWitness::DIFFERENCE);
+}
+
+bool Automaton::DFAHasProductWitness(const DFA_ptr dfa1, const DFA_ptr dfa2, const ProductWitness witness) {
+  auto is_witness = [dfa1, dfa2, witness](const int state_1, const int state_2) {
+    const bool is_accepting_1 = Automaton::DFAIsAcceptingState(dfa1, state_1);
+    const bool is_accepting_2 = Automaton::DFAIsAcceptingState(dfa2, state_2);
+    switch (witness) {
+      case ProductWitness::INTERSECTION:
+        return is_accepting_1 and is_accepting_2;
+      case ProductWitness::DIFFERENCE:
+        return is_accepting_1 and not is_accepting_2;
+      default:
+        return is_accepting_1 != is_accepting_2;
+    }
+  };
+
+  // a pair cannot lead to a witness once the side(s) that must accept are stuck in a rejecting sink
+  auto is_dead = [dfa1, dfa2, witness](const int state_1, const int state_2) {
+    const bool is_sink_1 = Automaton::DFAIsSinkState(dfa1, state_1);
+    const bool is_sink_2 = Automaton::DFAIsSinkState(dfa2, state_2);
+    switch (witness) {
+      case ProductWitness::INTERSECTION:
+        return is_sink_1 or is_sink_2;
+      case ProductWitness::DIFFERENCE:
+        return is_sink_1;
+      default:
+        return is_sink_1 and is_sink_2;
+    }
+  };
+
+  const unsigned long number_of_states_2 = dfa2->ns;
+  std::unordered_set<unsigned long> visited_states;
+  std::queue<std::pair<int, int>> pending_states;
+
+  if (is_witness(dfa1->s, dfa2->s)) {
+    return true;
+  }
+  visited_states.insert(dfa1->s * number_of_states_2 + dfa2->s);
+  pending_states.push(std::make_pair(dfa1->s, dfa2->s));
+
+  unsigned l1, r1, index1, l2, r2, index2; // BDD traversal variables
+  std::stack<std::pair<unsigned, unsigned>> nodes;
+  std::unordered_set<unsigned long> visited_nodes;
+  while (not pending_states.empty()) {
+    const auto current_states = pending_states.front();
+    pending_states.pop();
+    if (is_dead(current_states.first, current_states.second)) {
+      continue;
+    }
+
+    // walk both bdds together, branching on the smaller variable index until both reach a leaf
+    visited_nodes.clear();
+    nodes.push(std::make_pair(dfa1->q[current_states.first], dfa2->q[current_states.second]));
+    while (not nodes.empty()) {
+      const auto current_nodes = nodes.top();
+      nodes.pop();
+      if (not visited_nodes.insert(((unsigned long)current_nodes.first << 32) | current_nodes.second).second) {
+        continue;
+      }
+      LOAD_lri(&dfa1->bddm->node_table[current_nodes.first], l1, r1, index1);
+      LOAD_lri(&dfa2->bddm->node_table[current_nodes.second], l2, r2, index2);
+      if (index1 == BDD_LEAF_INDEX and index2 == BDD_LEAF_INDEX) {
+        if (visited_states.insert(l1 * number_of_states_2 + l2).second) {
+          if (is_witness(l1, l2)) {
+            return true;
+          }
+          pending_states.push(std::make_pair(l1, l2));
+        }
+      } else {
+        const unsigned index = std::min(index1, index2);
+        nodes.push(std::make_pair((index1 == index) ? l1 : current_nodes.first, (index2 == index) ? l2 : current_nodes.second));
+        nodes.push(std::make_pair((index1 == index) ? r1 : current_nodes.first, (index2 == index) ? r2 : current_nodes.second));
+      }
+    }
+  }
+  return false;
 }
 
 int Automaton::DFAGetInitialState(const DFA_ptr dfa) {
@@ -980,6 +1104,86 @@ DFA_ptr Automaton::DFAMakeEmpty(const int number_of_bdd_variables) {
   return dfaBuild(statuses);
 }
 
+/**
+ * Ranges that go to the default target of a state are not stored as exceptions
+ */
+DFA_ptr Automaton::DFAMakeFromCharRanges(const std::vector<std::vector<CharRange>>& transitions,
+                                         const std::vector<bool>& is_accepting, const int number_of_bdd_variables) {
+  CHECK_EQ(transitions.size(), is_accepting.size());
+  const unsigned max_symbol = (1u << number_of_bdd_variables) - 1;
+  int number_of_states = transitions.size();
+  const int sink_state = number_of_states;
+  bool needs_sink_state = false;
+  std::vector<int> default_states (number_of_states, sink_state);
+  for (int s = 0; s < number_of_states; ++s) {
+    const auto& ranges = transitions[s];
+    unsigned long next_symbol = 0;
+    for (auto& range : ranges) {
+      if (range.first != next_symbol) {
+        break;
+      }
+      next_symbol = (unsigned long)range.last + 1;
+    }
+    if (next_symbol == (unsigned long)max_symbol + 1) {
+      default_states[s] = ranges.back().next_state;
+    } else {
+      needs_sink_state = true;
+    }
+  }
+  if (needs_sink_state) {
+    ++number_of_states;
+  }
+
+  std::vector<char> statuses (number_of_states + 1, '-');
+  dfaSetup(number_of_states, number_of_bdd_variables, GetBddVariableIndices(number_of_bdd_variables));
+  std::vector<std::pair<int, std::string>> exceptions;
+  for (int s = 0; s < (int)transitions.size(); ++s) {
+    exceptions.clear();
+    for (auto& range : transitions[s]) {
+      if (range.next_state != default_states[s]) {
+        for (auto& exception : GetCharRangeExceptions(range.first, range.last, number_of_bdd_variables)) {
+          exceptions.push_back(std::make_pair(range.next_state, exception));
+        }
+      }
+    }
+    dfaAllocExceptions(exceptions.size());
+    for (auto& exception : exceptions) {
+      dfaStoreException(exception.first, &exception.second[0]);
+    }
+    dfaStoreState(default_states[s]);
+    if (is_accepting[s]) {
+      statuses[s] = '+';
+    }
+  }
+  if (needs_sink_state) {
+    dfaAllocExceptions(0);
+    dfaStoreState(sink_state);
+  }
+  statuses[number_of_states] = '\0';
+  return dfaBuild(&statuses[0]);
+}
+
+std::vector<std::string> Automaton::GetCharRangeExceptions(const unsigned long first, const unsigned long last,
+                                                           const int number_of_bdd_variables) {
+  std::vector<std::string> exceptions;
+  unsigned long current = first;
+  while (current <= last) {
+    int free_bits = 0;
+    while (free_bits < number_of_bdd_variables and (current & ((1ul << (free_bits + 1)) - 1)) == 0
+        and current + (1ul << (free_bits + 1)) - 1 <= last) {
+      ++free_bits;
+    }
+    std::string exception;
+    for (int b = number_of_bdd_variables - 1; b >= free_bits; --b) {
+      exception.push_back(((current >> b) & 1) ? '1' : '0');
+    }
+    exception.append(free_bits, 'X');
+    exceptions.push_back(exception);
+    current += (1ul << free_bits);
+  }
+  return exceptions;
+}
+
 DFA_ptr Automaton::DFAComplement(const DFA_ptr dfa) {
   DFA_ptr complement_dfa = dfaCopy(dfa);
   dfaNegation(complement_dfa);
@@ -988,6 +1192,9 @@ DFA_ptr Automaton::DFAComplement(const DFA_ptr dfa) {
 
 DFA_ptr Automaton::DFAUnion(const DFA_ptr dfa1, const DFA_ptr dfa2) {
   DFA_ptr union_dfa = dfaProduct(dfa1, dfa2, dfaOR);
+  if (IsMinimizationDeferred()) {
+    return union_dfa;
+  }
   DFA_ptr minimized_dfa = dfaMinimize(union_dfa);
   dfaFree(union_dfa);
   return minimized_dfa;
@@ -995,15 +1202,42 @@ DFA_ptr Automaton::DFAUnion(const DFA_ptr dfa1, const DFA_ptr dfa2) {
 
 DFA_ptr Automaton::DFAIntersect(const DFA_ptr dfa1, const DFA_ptr dfa2) {
   DFA_ptr intersect_dfa = dfaProduct(dfa1, dfa2, dfaAND);
+  if (IsMinimizationDeferred()) {
+    return intersect_dfa;
+  }
   DFA_ptr minimized_dfa = dfaMinimize(intersect_dfa);
   dfaFree(intersect_dfa);
   return minimized_dfa;
 }
 
-DFA_ptr Automaton::DFADifference(const DFA_ptr dfa1, DFA_ptr dfa2) {
-  dfaNegation(dfa2); // efficient
-  DFA_ptr difference_dfa = Automaton::DFAIntersect(dfa1, dfa2);
-  dfaNegation(dfa2); // restore back
+DFA_ptr Automaton::DFAIntersect(const std::vector<DFA_ptr>& dfas) {
+  CHECK(not dfas.empty());
+  std::vector<DFA_ptr> ordered_dfas (dfas);
+  std::stable_sort(ordered_dfas.begin(), ordered_dfas.end(), [](const DFA_ptr dfa1, const DFA_ptr dfa2) {
+    return dfa1->ns < dfa2->ns;
+  });
+
+  DFA_ptr intersect_dfa = dfaCopy(ordered_dfas.front());
+  for (auto it = ordered_dfas.begin() + 1; it != ordered_dfas.end(); ++it) {
+    if (IsMinimizationDeferred() ? DFAIsEmpty(intersect_dfa) : DFAIsMinimizedEmtpy(intersect_dfa)) {
+      break;
+    }
+    DFA_ptr tmp_dfa = intersect_dfa;
+    intersect_dfa = DFAIntersect(tmp_dfa, *it);
+    dfaFree(tmp_dfa);
+  }
+  return intersect_dfa;
+}
+
+/**
+ * Operands may be shared with other automata and caches, the difference is the negation of dfa1 implies dfa2 so that
+ * only the product is negated
+ */
+DFA_ptr Automaton::DFADifference(const DFA_ptr dfa1, const DFA_ptr dfa2) {
+  DFA_ptr implication_dfa = dfaProduct(dfa1, dfa2, dfaIMPL);
+  DFA_ptr difference_dfa = dfaMinimize(implication_dfa);
+  dfaFree(implication_dfa);
+  dfaNegation(difference_dfa);
   return difference_dfa;
 }
 
@@ -1015,19 +1249,130 @@ DFA_ptr Automaton::DFAProjectAway(const DFA_ptr dfa, const int index) {
 }
 
 DFA_ptr Automaton::DFAProjectAway(const DFA_ptr dfa, std::vector<int> map, const std::vector<int> indices) {
-	DFA_ptr temp,result_dfa = dfa;
-	int flag = 0;
+  DFA_ptr result_dfa = Automaton::DFAProjectAwayIndices(dfa, map.size(), indices);
+  dfaReplaceIndices(result_dfa, &map[0]);
+  return result_dfa;
+}
 
-	for(auto index : indices) {
-		temp = dfaProject(result_dfa,(unsigned)index);
-		if(flag)
-			dfaFree(result_dfa);
-		result_dfa = dfaMinimize(temp);
-		flag = 1;
-		dfaFree(temp);
-	}
-	dfaReplaceIndices(result_dfa,&map[0]);
-	return result_dfa;
+DFA_ptr Automaton::DFAProjectAwayIndices(const DFA_ptr dfa, const int number_of_bdd_variables, const std::vector<int> indices) {
+  std::vector<bool> is_projected (number_of_bdd_variables, false);
+  for (int index : indices) {
+    CHECK(index >= 0 and index < number_of_bdd_variables) << "invalid bdd variable index: " << index;
+    is_projected[index] = true;
+  }
+
+  // subsets of original states are the states of the projected dfa
+  std::map<std::vector<int>, int> subset_ids;
+  std::vector<std::vector<int>> subsets;
+  std::vector<std::vector<std::pair<std::string, int>>> subset_transitions;
+  auto get_subset_id = [&subset_ids, &subsets](std::vector<int>& subset) {
+    std::sort(subset.begin(), subset.end());
+    subset.erase(std::unique(subset.begin(), subset.end()), subset.end());
+    auto it = subset_ids.find(subset);
+    if (it != subset_ids.end()) {
+      return it->second;
+    }
+    const int id = subsets.size();
+    subset_ids[subset] = id;
+    subsets.push_back(subset);
+    return id;
+  };
+
+  std::vector<int> initial_subset {dfa->s};
+  get_subset_id(initial_subset);
+
+  unsigned l, r, index; // BDD traversal variables
+  std::stack<std::pair<std::string, std::vector<unsigned>>> pending_paths;
+  for (std::size_t subset_id = 0; subset_id < subsets.size(); ++subset_id) {
+    subset_transitions.push_back(std::vector<std::pair<std::string, int>>());
+    std::vector<unsigned> nodes;
+    for (int state : subsets[subset_id]) {
+      nodes.push_back(dfa->q[state]);
+    }
+    pending_paths.push(std::make_pair(std::string(), nodes));
+
+    // walks the bdds of all states in the subset together, follows both branches of projected variables
+    while (not pending_paths.empty()) {
+      std::string path = pending_paths.top().first;
+      nodes = pending_paths.top().second;
+      pending_paths.pop();
+
+      unsigned next_index = BDD_LEAF_INDEX;
+      for (unsigned node : nodes) {
+        LOAD_lri(&dfa->bddm->node_table[node], l, r, index);
+        next_index = std::min(next_index, index);
+      }
+
+      if (next_index == BDD_LEAF_INDEX) {
+        std::vector<int> next_subset;
+        for (unsigned node : nodes) {
+          LOAD_lri(&dfa->bddm->node_table[node], l, r, index);
+          next_subset.push_back(l);
+        }
+        path.resize(number_of_bdd_variables, 'X');
+        subset_transitions[subset_id].push_back(std::make_pair(path, get_subset_id(next_subset)));
+        continue;
+      }
+
+      CHECK_LT(next_index, (unsigned)number_of_bdd_variables) << "bdd variable index is out of range";
+      path.resize(next_index, 'X');
+      std::vector<unsigned> low_nodes, high_nodes;
+      for (unsigned node : nodes) {
+        LOAD_lri(&dfa->bddm->node_table[node], l, r, index);
+        if (index == next_index) {
+          low_nodes.push_back(l);
+          high_nodes.push_back(r);
+        } else {
+          low_nodes.push_back(node);
+          high_nodes.push_back(node);
+        }
+      }
+
+      if (is_projected[next_index]) {
+        low_nodes.insert(low_nodes.end(), high_nodes.begin(), high_nodes.end());
+        std::sort(low_nodes.begin(), low_nodes.end());
+        low_nodes.erase(std::unique(low_nodes.begin(), low_nodes.end()), low_nodes.end());
+        pending_paths.push(std::make_pair(path + 'X', low_nodes));
+      } else {
+        std::sort(low_nodes.begin(), low_nodes.end());
+        low_nodes.erase(std::unique(low_nodes.begin(), low_nodes.end()), low_nodes.end());
+        std::sort(high_nodes.begin(), high_nodes.end());
+        high_nodes.erase(std::unique(high_nodes.begin(), high_nodes.end()), high_nodes.end());
+        pending_paths.push(std::make_pair(path + '0', low_nodes));
+        pending_paths.push(std::make_pair(path + '1', high_nodes));
+      }
+    }
+  }
+
+  const int number_of_states = subsets.size();
+  char* statuses = new char[number_of_states + 1];
+  dfaSetup(number_of_states, number_of_bdd_variables, GetBddVariableIndices(number_of_bdd_variables));
+  for (int subset_id = 0; subset_id < number_of_states; ++subset_id) {
+    // paths are disjoint and cover all inputs, last one becomes the default transition
+    auto& transitions = subset_transitions[subset_id];
+    dfaAllocExceptions(transitions.size() - 1);
+    for (std::size_t i = 0; i + 1 < transitions.size(); ++i) {
+      dfaStoreException(transitions[i].second, const_cast<char*>(transitions[i].first.data()));
+    }
+    dfaStoreState(transitions.back().second);
+
+    statuses[subset_id] = '0';
+    for (int state : subsets[subset_id]) {
+      if (dfa->f[state] == 1) {
+        statuses[subset_id] = '+';
+        break;
+      } else if (dfa->f[state] == -1) {
+        statuses[subset_id] = '-';
+      }
+    }
+  }
+  statuses[number_of_states] = '\0';
+
+  DFA_ptr projected_dfa = dfaBuild(statuses);
+  delete[] statuses;
+  DFA_ptr minimized_dfa = dfaMinimize(projected_dfa);
+  dfaFree(projected_dfa);
+  return minimized_dfa;
 }
 
 DFA_ptr Automaton::DFAProjectAwayAndReMap(const DFA_ptr dfa, const int number_of_bdd_variables, const int index) {
@@ -1043,21 +1388,19 @@ DFA_ptr Automaton::DFAProjectAwayAndReMap(const DFA_ptr dfa, const int number_of
     dfaReplaceIndices(projected_dfa, indices_map);
     delete[] indices_map;
   }
-
   DFA_ptr minimized_dfa = dfaMinimize(projected_dfa);
   dfaFree(projected_dfa);
   return minimized_dfa;
 }
 
 DFA_ptr Automaton::DFAProjectTo(const DFA_ptr dfa, const int number_of_bdd_variables, const int index) {
-  DFA_ptr projected_dfa = dfaCopy(dfa);
+  std::vector<int> indices;
   for (int i = 0 ; i < number_of_bdd_variables; ++i) {
     if (i != index) {
-      DFA_ptr tmp_dfa = projected_dfa;
-      projected_dfa = Automaton::DFAProjectAway(tmp_dfa, i);
-      dfaFree(tmp_dfa);
+      indices.push_back(i);
     }
   }
+  DFA_ptr projected_dfa = Automaton::DFAProjectAwayIndices(dfa, number_of_bdd_variables, indices);
 
   int* indices_map = CreateBddVariableIndices(number_of_bdd_variables);
   indices_map[index] = 0;
@@ -1067,6 +1410,33 @@ DFA_ptr Automaton::DFAProjectTo(const DFA_ptr dfa, const int number_of_bdd_varia
   return projected_dfa;
 }
 
+DFA_ptr Automaton::DFAProjectTo(const DFA_ptr dfa, const int number_of_bdd_variables, const std::vector<int> indices) {
+  std::vector<bool> is_kept (number_of_bdd_variables, false);
+  for (int index : indices) {
+    is_kept[index] = true;
+  }
+  std::vector<int> projected_indices;
+  for (int i = 0 ; i < number_of_bdd_variables; ++i) {
+    if (not is_kept[i]) {
+      projected_indices.push_back(i);
+    }
+  }
+  DFA_ptr projected_dfa = Automaton::DFAProjectAwayIndices(dfa, number_of_bdd_variables, projected_indices);
+
+  // kept variables move to the front in the given order
+  int* indices_map = CreateBddVariableIndices(number_of_bdd_variables);
+  int next_index = 0;
+  for (int index : indices) {
+    indices_map[index] = next_index++;
+  }
+  for (int index : projected_indices) {
+    indices_map[index] = next_index++;
+  }
+  dfaReplaceIndices(projected_dfa, indices_map);
+  delete[] indices_map;
+  return projected_dfa;
+}
+
 DFA_ptr Automaton::DFAMakeAcceptingAnyWithInRange(const int start, const int end, const int number_of_bdd_variables) {
   CHECK((start >= 0) && (end >= start));
   // 1 initial state and 1 sink state
@@ -1097,27 +1467,47 @@ DFA_ptr Automaton::DFAMakeAcceptingAnyWithInRange(const int start, const int end
 }
 
 DFA_ptr Automaton::DFAMakeAcceptingAnyAfterLength(const int length, const int number_of_bdd_variables) {
+  return dfaCopy(Automaton::DFAGetAcceptingAnyAfterLength(length, number_of_bdd_variables).get());
+}
+
+std::shared_ptr<DFA> Automaton::DFAGetAcceptingAnyWithInRange(const int start, const int end,
+                                                              const int number_of_bdd_variables) {
+  return FactoryCache::Instance().GetOrMake(FactoryCache::Factory::ACCEPTING_ANY_WITH_IN_RANGE,
+      {start, end, number_of_bdd_variables}, [start, end, number_of_bdd_variables]() {
+    DFA_ptr range_dfa = Automaton::DFAMakeAcceptingAnyWithInRange(start, end, number_of_bdd_variables);
+    DFA_ptr minimized_dfa = dfaMinimize(range_dfa);
+    dfaFree(range_dfa);
+    return minimized_dfa;
+  });
+}
+
+std::shared_ptr<DFA> Automaton::DFAGetAcceptingAnyAfterLength(const int length, const int number_of_bdd_variables) {
   CHECK(length >= 0);
-  // 1 initial state
-  const int number_of_states = length + 1;
-  char *statuses = new char[number_of_states+1];
-  dfaSetup(number_of_states, number_of_bdd_variables, GetBddVariableIndices(number_of_bdd_variables));
+  return FactoryCache::Instance().GetOrMake(FactoryCache::Factory::ACCEPTING_ANY_AFTER_LENGTH,
+      {length, number_of_bdd_variables}, [length, number_of_bdd_variables]() {
+    // 1 initial state
+    const int number_of_states = length + 1;
+    char *statuses = new char[number_of_states+1];
+    dfaSetup(number_of_states, number_of_bdd_variables, GetBddVariableIndices(number_of_bdd_variables));
+
+    // 0 to length - 1 not accepting
+    for(int i = 0; i < length; ++i) {
+      dfaAllocExceptions(0);
+      dfaStoreState(i + 1);
+      statuses[i] = '-';
+    }
 
-  // 0 to length - 1 not accepting
-  for(int i = 0; i < length; ++i) {
+    // final state
     dfaAllocExceptions(0);
-    dfaStoreState(i + 1);
-    statuses[i] = '-';
-  }
-
-  // final state
-  dfaAllocExceptions(0);
-  dfaStoreState(length);
-  statuses[length] = '+';
-  statuses[number_of_states] = '\0';
-  DFA_ptr result_dfa = dfaBuild(statuses);
-  delete[] statuses;
-  return result_dfa;
+    dfaStoreState(length);
+    statuses[length] = '+';
+    statuses[number_of_states] = '\0';
+    DFA_ptr result_dfa = dfaBuild(statuses);
+    delete[] statuses;
+    DFA_ptr minimized_dfa = dfaMinimize(result_dfa);
+    dfaFree(result_dfa);
+    return minimized_dfa;
+  });
 }
 
 std::set<std::string> Automaton::DFAGetTransitionsFromTo(DFA_ptr dfa, const int from, const int to, const int number_of_bdd_variables) {
@@ -1148,6 +1538,74 @@ std::set<std::string> Automaton::DFAGetTransitionsFromTo(DFA_ptr dfa, const int
   return transitions;
 }
 
+std::map<int, BigInteger> Automaton::DFAGetTransitionCounts(const DFA_ptr dfa, const int state, const int number_of_bdd_variables,
+                                                           std::unordered_map<unsigned, std::map<int, BigInteger>>& node_counts) {
+  unsigned left, right, index;
+  const unsigned root = dfa->q[state];
+  LOAD_lri(&dfa->bddm->node_table[root], left, right, index);
+  // fast path, all assignments go to the same state
+  if (index == BDD_LEAF_INDEX) {
+    std::map<int, BigInteger> transition_counts;
+    transition_counts[left] = BigInteger(1) << number_of_bdd_variables;
+    return transition_counts;
+  }
+
+  // index of a leaf is treated as the number of bdd variables
+  auto get_index = [dfa, number_of_bdd_variables](const unsigned node) -> unsigned {
+    unsigned l, r, i;
+    LOAD_lri(&dfa->bddm->node_table[node], l, r, i);
+    return (i == BDD_LEAF_INDEX) ? number_of_bdd_variables : i;
+  };
+
+  // post-order traversal, pair.second is true when children are already processed
+  std::stack<std::pair<unsigned, bool>> bdd_node_stack;
+  bdd_node_stack.push(std::make_pair(root, false));
+  while (not bdd_node_stack.empty()) {
+    auto current = bdd_node_stack.top(); bdd_node_stack.pop();
+    if (node_counts.find(current.first) != node_counts.end()) {
+      continue;
+    }
+    LOAD_lri(&dfa->bddm->node_table[current.first], left, right, index);
+    if (index == BDD_LEAF_INDEX) {
+      node_counts[current.first][left] = 1;
+    } else if (current.second) {
+      std::map<int, BigInteger> counts;
+      // variables skipped between a node and its child are don't cares
+      const unsigned left_shift = get_index(left) - index - 1;
+      for (auto& entry : node_counts[left]) {
+        counts[entry.first] += (entry.second << left_shift);
+      }
+      const unsigned right_shift = get_index(right) - index - 1;
+      for (auto& entry : node_counts[right]) {
+        counts[entry.first] += (entry.second << right_shift);
+      }
+      node_counts[current.first] = std::move(counts);
+    } else {
+      bdd_node_stack.push(std::make_pair(current.first, true));
+      bdd_node_stack.push(std::make_pair(left, false));
+      bdd_node_stack.push(std::make_pair(right, false));
+    }
+  }
+
+  std::map<int, BigInteger> transition_counts = node_counts[root];
+  const unsigned root_shift = get_index(root);
+  if (root_shift > 0) {
+    for (auto& entry : transition_counts) {
+      entry.second <<= root_shift;
+    }
+  }
+  return transition_counts;
+}
+
+std::vector<std::map<int, BigInteger>> Automaton::DFAGetTransitionCounts(const DFA_ptr dfa, const int number_of_bdd_variables) {
+  std::vector<std::map<int, BigInteger>> transition_counts (dfa->ns);
+  std::unordered_map<unsigned, std::map<int, BigInteger>> node_counts;
+  for (int s = 0; s < dfa->ns; ++s) {
+    transition_counts[s] = DFAGetTransitionCounts(dfa, s, number_of_bdd_variables, node_counts);
+  }
+  return transition_counts;
+}
+
 DFA_ptr Automaton::DFAConcat(const DFA_ptr dfa1, const DFA_ptr dfa2, const int number_of_bdd_variables) {
   //LOG(FATAL) << "I'm broken, fix me! Use StringAutomaton::concat instead";
 
@@ -1452,56 +1910,63 @@ int* Automaton::CreateBddVariableIndices(const int number_of_bdd_variables) {
   return indices;
 }
 
-std::vector<char> Automaton::GetBinaryFormat(unsigned long number, int bit_length) {
-  unsigned subject = number;
-  std::vector<char> binary_str (bit_length + 1, '\0');
-  for (int index = bit_length - 1; index >= 0; --index) {
-    if (subject & 1) {
-      binary_str[index] = '1';
-    } else {
-      binary_str[index] = '0';
+/**
+ * Bits of all byte values, most significant bit first; formats are filled a byte at a time from that table
+ */
+static const std::array<std::array<char, 8>, 256>& GetByteBinaryFormats() {
+  static const std::array<std::array<char, 8>, 256> byte_binary_formats = []() {
+    std::array<std::array<char, 8>, 256> formats;
+    for (int byte = 0; byte < 256; ++byte) {
+      for (int bit = 0; bit < 8; ++bit) {
+        formats[byte][7 - bit] = ((byte >> bit) & 1) ? '1' : '0';
+      }
     }
-    if (subject > 0) {
-      subject >>= 1;
+    return formats;
+  }();
+  return byte_binary_formats;
+}
+
+void Automaton::FillBinaryFormat(unsigned long number, int bit_length, char* buffer) {
+  const auto& byte_binary_formats = GetByteBinaryFormats();
+  const int number_of_bits = sizeof(number) * CHAR_BIT;
+  int end = bit_length;
+  for (int shift = 0; end > 0; shift += 8, end -= 8) {
+    const int byte = (shift < number_of_bits) ? ((number >> shift) & 0xff) : 0;
+    const int length = std::min(end, 8);
+    std::memcpy(buffer + end - length, byte_binary_formats[byte].data() + 8 - length, length);
+  }
+  buffer[bit_length] = '\0';
+}
+
+void Automaton::FillReversedBinaryFormat(unsigned long number, int bit_length, char* buffer) {
+  const auto& byte_binary_formats = GetByteBinaryFormats();
+  const int number_of_bits = sizeof(number) * CHAR_BIT;
+  for (int index = 0; index < bit_length; index += 8) {
+    const int byte = (index < number_of_bits) ? ((number >> index) & 0xff) : 0;
+    const int length = std::min(bit_length - index, 8);
+    const char* byte_binary_format = byte_binary_formats[byte].data();
+    for (int bit = 0; bit < length; ++bit) {
+      buffer[index + bit] = byte_binary_format[7 - bit];
     }
   }
+  buffer[bit_length] = '\0';
+}
 
+std::vector<char> Automaton::GetBinaryFormat(unsigned long number, int bit_length) {
+  std::vector<char> binary_str (bit_length + 1);
+  FillBinaryFormat(number, bit_length, &binary_str[0]);
   return binary_str;
 }
 
 std::vector<char> Automaton::GetReversedBinaryFormat(unsigned long number, int bit_length) {
-  unsigned subject = number;
-  std::vector<char> binary_str (bit_length + 1, '\0');
-  for (int index = 0; index < bit_length; ++index) {
-    if (subject & 1) {
-      binary_str[index] = '1';
-    } else {
-      binary_str[index] = '0';
-    }
-    if (subject > 0) {
-      subject >>= 1;
-    }
-  }
-
+  std::vector<char> binary_str (bit_length + 1);
+  FillReversedBinaryFormat(number, bit_length, &binary_str[0]);
   return binary_str;
 }
 
 std::string Automaton::GetBinaryStringMSB(unsigned long number, int bit_length) {
-  int index = bit_length;
-  unsigned subject = number;
   std::string binary_string (bit_length + 1, '\0');
-
-  for (index--; index >= 0; index--) {
-    if (subject & 1) {
-      binary_string[index] = '1';
-    } else {
-      binary_string[index] = '0';
-    }
-    if (subject > 0) {
-      subject >>= 1;
-    }
-  }
-
+  FillBinaryFormat(number, bit_length, &binary_string[0]);
   return binary_string;
 }
 
@@ -1512,34 +1977,23 @@ std::string Automaton::GetBinaryStringMSB(unsigned long number, int bit_length)
  * @return binary representation of reserved word
  */
 std::vector<char> Automaton::getReservedWord(char last_char, int length, bool extra_bit) {
-  std::vector<char> reserved_word;
-
-  int i;
-  for (i = 0; i < length - 1; i++) {
-    reserved_word.push_back('1');
-  }
-  reserved_word.push_back(last_char);
-
-  if (extra_bit) {
-    reserved_word.push_back('1');
-  }
-
-  reserved_word.push_back('\0');
-
+  std::vector<char> reserved_word (length + (extra_bit ? 2 : 1), '1');
+  reserved_word[length - 1] = last_char;
+  reserved_word.back() = '\0';
   return reserved_word;
 }
 
 void Automaton::Minimize() {
-  DFA_ptr tmp = this->dfa_;
-  this->dfa_ = dfaMinimize(tmp);
-  dfaFree(tmp);
+  if (is_minimized_) {
+    DVLOG(VLOG_LEVEL) << this->id_ << " = [" << this->id_ << "]->minimize() already minimal";
+    return;
+  }
+  set_dfa(dfaMinimize(this->dfa_), true);
   DVLOG(VLOG_LEVEL) << this->id_ << " = [" << this->id_ << "]->minimize()";
 }
 
 void Automaton::ProjectAway(unsigned index) {
-  DFA_ptr tmp = this->dfa_;
-  this->dfa_ = dfaProject(tmp, index);
-  dfaFree(tmp);
+  DFA_ptr projected_dfa = dfaProject(this->dfa_, index);
 
   if (index < (unsigned)(this->num_of_bdd_variables_ - 1)) {
     int* indices_map = new int[this->num_of_bdd_variables_];
@@ -1549,15 +2003,281 @@ void Automaton::ProjectAway(unsigned index) {
         j++;
       }
     }
-    dfaReplaceIndices(this->dfa_, indices_map);
+    dfaReplaceIndices(projected_dfa, indices_map);
     delete[] indices_map;
   }
+  set_dfa(projected_dfa);
 
   this->num_of_bdd_variables_ = this->num_of_bdd_variables_ - 1;
 
   DVLOG(VLOG_LEVEL) << this->id_ << " = [" << this->id_ << "]->project(" << index << ")";
 }
 
+void Automaton::set_dfa(DFA_ptr dfa, const bool is_minimized) {
+  InvalidateMetadata();
+  dfa_ = dfa;
+  is_minimized_ = is_minimized;
+  if (dfa == nullptr) {
+    shared_dfa_.reset();
+  } else {
+    shared_dfa_ = std::shared_ptr<DFA>(dfa, dfaFree);
+  }
+}
+
+void Automaton::ShareDFA(const Automaton& other) {
+  dfa_ = other.dfa_;
+  shared_dfa_ = other.shared_dfa_;
+  is_minimized_ = other.is_minimized_;
+  metadata_ = other.metadata_;
+  char_range_index_ = other.char_range_index_;
+}
+
+void Automaton::ShareDFA(std::shared_ptr<DFA> dfa, const bool is_minimized) {
+  InvalidateMetadata();
+  dfa_ = dfa.get();
+  shared_dfa_ = dfa;
+  is_minimized_ = is_minimized;
+}
+
+std::shared_ptr<DFA> Automaton::GetOrComputeDFA(const OperationCache::Operation operation,
+                                                const std::vector<const Automaton*>& operands,
+                                                const std::vector<int>& parameters, std::function<DFA_ptr()> compute) {
+  if (IsMinimizationDeferred()) {
+    return std::shared_ptr<DFA>(compute(), dfaFree);
+  }
+  std::vector<std::shared_ptr<DFA>> operand_dfas;
+  for (auto automaton : operands) {
+    // a dfa that is swapped in temporarily is not shared, results on it are not cached
+    if (not automaton->shared_dfa_ or automaton->shared_dfa_.get() != automaton->dfa_) {
+      return std::shared_ptr<DFA>(compute(), dfaFree);
+    }
+    operand_dfas.push_back(automaton->shared_dfa_);
+  }
+  return OperationCache::Instance().GetOrCompute(operation, operand_dfas, parameters, compute);
+}
+
+void Automaton::MakeDFAUnique() {
+  if (shared_dfa_ and not shared_dfa_.unique()) {
+    set_dfa(dfaCopy(dfa_));
+  }
+  InvalidateMetadata();
+  is_minimized_ = false;
+}
+
+const Automaton::Metadata& Automaton::GetMetadata() const {
+  // the dfa pointer check also covers code that swaps dfa_ temporarily
+  if (metadata_ and metadata_->dfa == this->dfa_) {
+    return *metadata_;
+  }
+
+  auto metadata = std::make_shared<Metadata>();
+  const int number_of_states = this->dfa_->ns;
+  metadata->dfa = this->dfa_;
+  metadata->sink_state = Automaton::DFAGetSinkState(this->dfa_);
+  metadata->next_states.resize(number_of_states);
+  metadata->previous_states.resize(number_of_states);
+
+  unsigned p, l, r, index; // BDD traversal variables
+  std::stack<unsigned> nodes;
+  for (int s = 0; s < number_of_states; ++s) {
+    auto& next_states = metadata->next_states[s];
+    nodes.push(this->dfa_->q[s]);
+    while (not nodes.empty()) {
+      p = nodes.top();
+      nodes.pop();
+      LOAD_lri(&this->dfa_->bddm->node_table[p], l, r, index);
+      if (index == BDD_LEAF_INDEX) {
+        next_states.push_back(l);
+      } else {
+        nodes.push(l);
+        nodes.push(r);
+      }
+    }
+    std::sort(next_states.begin(), next_states.end());
+    next_states.erase(std::unique(next_states.begin(), next_states.end()), next_states.end());
+    for (int next_state : next_states) {
+      metadata->previous_states[next_state].push_back(s);
+    }
+  }
+
+  // forward reachability
+  std::queue<int> states;
+  metadata->is_reachable.resize(number_of_states, false);
+  metadata->is_reachable[this->dfa_->s] = true;
+  states.push(this->dfa_->s);
+  while (not states.empty()) {
+    const int state = states.front();
+    states.pop();
+    for (int next_state : metadata->next_states[state]) {
+      if (not metadata->is_reachable[next_state]) {
+        metadata->is_reachable[next_state] = true;
+        states.push(next_state);
+      }
+    }
+  }
+
+  // backward bfs from accepting states
+  metadata->distance_to_accepting.resize(number_of_states, INT_MAX);
+  for (int s = 0; s < number_of_states; ++s) {
+    if (this->dfa_->f[s] == 1) {
+      metadata->distance_to_accepting[s] = 0;
+      states.push(s);
+    }
+  }
+  while (not states.empty()) {
+    const int state = states.front();
+    states.pop();
+    for (int previous_state : metadata->previous_states[state]) {
+      if (metadata->distance_to_accepting[previous_state] == INT_MAX) {
+        metadata->distance_to_accepting[previous_state] = metadata->distance_to_accepting[state] + 1;
+        states.push(previous_state);
+      }
+    }
+  }
+
+  // iterative tarjan, components are numbered in reverse topological order
+  metadata->scc_ids.resize(number_of_states, -1);
+  metadata->is_in_cycle.resize(number_of_states, false);
+  std::vector<int> indices (number_of_states, -1), low_links (number_of_states, -1);
+  std::vector<bool> is_on_stack (number_of_states, false);
+  std::stack<int> component_stack;
+  std::stack<std::pair<int, std::size_t>> call_stack;
+  int next_index = 0, number_of_sccs = 0;
+  for (int root = 0; root < number_of_states; ++root) {
+    if (indices[root] != -1) {
+      continue;
+    }
+    call_stack.push(std::make_pair(root, 0));
+    while (not call_stack.empty()) {
+      const int state = call_stack.top().first;
+      const std::size_t next_position = call_stack.top().second;
+      if (next_position == 0) {
+        indices[state] = low_links[state] = next_index++;
+        component_stack.push(state);
+        is_on_stack[state] = true;
+      }
+
+      auto& next_states = metadata->next_states[state];
+      if (next_position < next_states.size()) {
+        call_stack.top().second++;
+        const int next_state = next_states[next_position];
+        if (indices[next_state] == -1) {
+          call_stack.push(std::make_pair(next_state, 0));
+        } else if (is_on_stack[next_state]) {
+          low_links[state] = std::min(low_links[state], indices[next_state]);
+        }
+        continue;
+      }
+
+      call_stack.pop();
+      if (not call_stack.empty()) {
+        const int parent_state = call_stack.top().first;
+        low_links[parent_state] = std::min(low_links[parent_state], low_links[state]);
+      }
+      if (low_links[state] == indices[state]) {
+        std::vector<int> component;
+        do {
+          component.push_back(component_stack.top());
+          component_stack.pop();
+          is_on_stack[component.back()] = false;
+          metadata->scc_ids[component.back()] = number_of_sccs;
+        } while (component.back() != state);
+
+        const bool has_self_loop = std::binary_search(next_states.begin(), next_states.end(), state);
+        if (component.size() > 1 or has_self_loop) {
+          for (int member_state : component) {
+            metadata->is_in_cycle[member_state] = true;
+          }
+        }
+        ++number_of_sccs;
+      }
+    }
+  }
+
+  metadata->is_cyclic = false;
+  for (int s = 0; s < number_of_states; ++s) {
+    if (metadata->is_reachable[s] and metadata->is_in_cycle[s] and s != metadata->sink_state) {
+      metadata->is_cyclic = true;
+      break;
+    }
+  }
+
+  metadata_ = metadata;
+  return *metadata_;
+}
+
+void Automaton::InvalidateMetadata() {
+  metadata_.reset();
+  char_range_index_.reset();
+}
+
+bool Automaton::UsesCharRanges() const {
+  return false;
+}
+
+/**
+ * Walks the bdd of each state with 0 branches first, a leaf reached after deciding some bits covers all symbols with
+ * that prefix, hence the intervals come out sorted; neighbor intervals with the same target are merged
+ */
+const std::vector<CharRange>& Automaton::GetCharRanges(const int state) const {
+  if (char_range_index_ and char_range_index_->dfa == this->dfa_) {
+    return char_range_index_->ranges[state];
+  }
+
+  CHECK_LE(num_of_bdd_variables_, MAX_CHAR_RANGE_BITS) << "char ranges are for automata with a few bits per symbol";
+  auto char_range_index = std::make_shared<CharRangeIndex>();
+  const int number_of_states = this->dfa_->ns;
+  const int number_of_bits = num_of_bdd_variables_;
+  char_range_index->dfa = this->dfa_;
+  char_range_index->ranges.resize(number_of_states);
+
+  struct Frame {
+    unsigned node;
+    int position;
+    unsigned prefix;
+  };
+  unsigned l, r, index; // BDD traversal variables
+  std::stack<Frame> frames;
+  for (int s = 0; s < number_of_states; ++s) {
+    auto& ranges = char_range_index->ranges[s];
+    frames.push({(unsigned)this->dfa_->q[s], 0, 0});
+    while (not frames.empty()) {
+      const Frame frame = frames.top();
+      frames.pop();
+      LOAD_lri(&this->dfa_->bddm->node_table[frame.node], l, r, index);
+      if (index == BDD_LEAF_INDEX) {
+        const int free_bits = number_of_bits - frame.position;
+        const unsigned first = frame.prefix << free_bits;
+        const unsigned last = first + ((1u << free_bits) - 1);
+        if (not ranges.empty() and ranges.back().next_state == (int)l) {
+          ranges.back().last = last;
+        } else {
+          ranges.push_back({first, last, (int)l});
+        }
+      } else if ((int)index == frame.position) {
+        frames.push({r, frame.position + 1, (frame.prefix << 1) | 1});
+        frames.push({l, frame.position + 1, frame.prefix << 1});
+      } else {
+        // bit is not tested on this path
+        frames.push({frame.node, frame.position + 1, (frame.prefix << 1) | 1});
+        frames.push({frame.node, frame.position + 1, frame.prefix << 1});
+      }
+    }
+  }
+
+  char_range_index_ = char_range_index;
+  return char_range_index_->ranges[state];
+}
+
+int Automaton::GetNextStateForChar(const int state, const unsigned symbol) const {
+  const std::vector<CharRange>& ranges = GetCharRanges(state);
+  auto it = std::lower_bound(ranges.begin(), ranges.end(), symbol, [](const CharRange& range, const unsigned value) {
+    return range.last < value;
+  });
+  CHECK(it != ranges.end()) << "symbol is out of range: " << symbol;
+  return it->next_state;
+}
+
 bool Automaton::hasIncomingTransition(int state) {
 	LOG(FATAL) << "implement me!";
 //  for (int i = 0; i < this->dfa_->ns; i++) {
@@ -1652,6 +2372,14 @@ int Automaton::getNextState(int state, std::vector<char>& exception) {
 
    CHECK_EQ(num_of_bdd_variables_, exception.size());
 
+   if (UsesCharRanges() and std::find(exception.begin(), exception.end(), 'X') == exception.end()) {
+     unsigned symbol = 0;
+     for (char bit : exception) {
+       symbol = (symbol << 1) | (bit == '1');
+     }
+     return GetNextStateForChar(state, symbol);
+   }
+
    p = this->dfa_->q[state];
 
    for (int i = 0; i < num_of_bdd_variables_; i++) {
@@ -1688,6 +2416,13 @@ std::set<int> Automaton::getNextStates(int state) {
   std::set<int> next_states;
   std::stack<unsigned> nodes;
 
+  if (UsesCharRanges()) {
+    for (auto& range : GetCharRanges(state)) {
+      next_states.insert(range.next_state);
+    }
+    return next_states;
+  }
+
   p = this->dfa_->q[state];
   nodes.push(p);
   while (not nodes.empty()) {
@@ -1805,34 +2540,13 @@ std::set<int> Automaton::getStatesReachableBy(int min_walk, int max_walk) {
 void Automaton::SetSymbolicCounter() {
   std::vector<Eigen::Triplet<BigInteger>> entries;
   const int sink_state = GetSinkState();
-  unsigned left, right, index;
+  // bdd nodes are shared among states, count assignments per node only once
+  std::unordered_map<unsigned, std::map<int, BigInteger>> node_counts;
   for (int s = 0; s < this->dfa_->ns; ++s) {
     if (sink_state != s) {
-      // Node is a pair<sbdd_node_id, bdd_depth>
-      Node current_bdd_node {dfa_->q[s], 0}, left_node, right_node;
-      std::stack<Node> bdd_node_stack;
-      bdd_node_stack.push(current_bdd_node);
-      while (not bdd_node_stack.empty()) {
-        current_bdd_node = bdd_node_stack.top(); bdd_node_stack.pop();
-        LOAD_lri(&dfa_->bddm->node_table[current_bdd_node.first], left, right, index);
-        if (index == BDD_LEAF_INDEX) {
-          if (sink_state != left) {
-            const int exponent = num_of_bdd_variables_ - current_bdd_node.second;
-            if (exponent == 0) {
-              entries.push_back(Eigen::Triplet<BigInteger>(s, left, 1));
-            } else if (exponent < 31) {
-              entries.push_back(Eigen::Triplet<BigInteger>(s, left, static_cast<int>(std::pow(2, exponent))));
-            } else {
-              entries.push_back(Eigen::Triplet<BigInteger>(s, left, boost::multiprecision::pow(boost::multiprecision::cpp_int(2), exponent)));
-            }
-          }
-        } else {
-          left_node.first = left;
-          left_node.second = current_bdd_node.second + 1;
-          right_node.first = right;
-          right_node.second = current_bdd_node.second + 1;
-          bdd_node_stack.push(left_node);
-          bdd_node_stack.push(right_node);
+      for (auto& entry : DFAGetTransitionCounts(dfa_, s, num_of_bdd_variables_, node_counts)) {
+        if (sink_state != entry.first) {
+          entries.push_back(Eigen::Triplet<BigInteger>(s, entry.first, entry.second));
         }
       }
 
@@ -1864,129 +2578,6 @@ void Automaton::decide_counting_schema(Eigen::SparseMatrix<BigInteger>& count_ma
   }
 }
 
-void Automaton::generateGFScript(int bound, std::ostream& out, bool count_less_than_or_equal_to_bound) {
-  LOG(FATAL) << "Refactor me with CountMatrix or add SparseCountMatrix";
-//  AdjacencyList adjacency_count_list = getAdjacencyCountList();
-//  unsigned node_size = adjacency_count_list.size();
-//  unsigned updated_node_size = node_size + 1;
-//  adjacency_count_list.resize(updated_node_size);
-//
-//  Node artificial;
-//
-//  // add a self-loop if we count up to bound (bound inclusive)
-//  if (count_less_than_or_equal_to_bound) {
-//    artificial.first = node_size;
-//    artificial.second = 1;
-//    adjacency_count_list[node_size].push_back(artificial);
-//  }
-//
-//  for (int i = 0; (unsigned)i < node_size; i++) {
-//    if (is_accepting_state(i)) {
-//      artificial.first = i;
-//      artificial.second = 1;
-//      adjacency_count_list[node_size].push_back(artificial);
-//    }
-//  }
-//
-//  out << "bound = " << bound + 2 << ";\n";
-//  out << "ID = IdentityMatrix[" << updated_node_size << "];\n\n";
-//  out << "A = SparseArray[ { ";
-//  std::string row_seperator = "";
-//  std::string col_seperator = "";
-//  int c = 0;
-//  for (auto& transitions : adjacency_count_list) {
-//    out << row_seperator;
-//    row_seperator = "";
-//    col_seperator = "";
-//    for(auto& node : transitions) {
-//      out << col_seperator;
-//      out << "{" << node.first + 1 << ", " << c + 1 << "} -> " << node.second;
-//      col_seperator = ", ";
-//      row_seperator = ", ";
-//    }
-//    c++;
-//  }
-//  out << "}];\n\n";
-//  out << "X = ID - A t;\n\n";
-//  out << "Xsubmatrix = X[[ {";
-//  std::string seperator = "";
-//  for(unsigned i = 1; i < updated_node_size; i++) {
-//    out << seperator << i;
-//    seperator = ",";
-//  }
-//  out << "},{";
-//  for(unsigned i = 1; i < updated_node_size - 1; i++){
-//    out << i << ",";
-//  }
-//
-//  out << updated_node_size << "}";
-//
-//  out << "]];\n";
-//
-//  out << "b = CoefficientList[-Det[Xsubmatrix],t];\n";
-//  out << "c = CoefficientList[Det[X],t];\n";
-//  out << "maxLen = Max[Map[Length, {b,c}]]\n";
-//  out << "bPadLen = Max[0, maxLen - Length[b]];\n";
-//  out << "cPadLen = Max[0, maxLen - Length[c]];\n";
-//  out << "b = ArrayPad[b, {0, bPadLen}];\n";
-//  out << "c = ArrayPad[c, {0, cPadLen}];\n";
-//  out << "p = -c[[ Range[2,maxLen] ]] / c[[1]];\n";
-//  out << "a = Table[0,{maxLen}];\n";
-//  out << "a[[1]] = b[[1]]/c[[1]];\n";
-//  out << "For[ i = 2, i <= maxLen, i++, a[[i]] = (b[[i]] - Total[c[[2;;i]]*a[[i-1;;1;;-1]]]) / c[[1]] ];\n";
-//  out << "numPaths = LinearRecurrence[p,a,{bound,bound}][[1]];\n";
-//  out << "Print[N[numPaths]];";
-//
-//  out << std::endl;
-}
-
-void Automaton::generateMatrixScript(int bound, std::ostream& out, bool count_less_than_or_equal_to_bound) {
-  LOG(FATAL) << "Refactor me with CountMatrix or add SparseCountMatrix";
-//  AdjacencyList adjacency_count_list = getAdjacencyCountList();
-//  unsigned node_size = adjacency_count_list.size();
-//  unsigned updated_node_size = node_size + 1;
-//  adjacency_count_list.resize(updated_node_size);
-//
-//  Node artificial;
-//
-//  // add a self-loop if we count up to bound (bound inclusive)
-//  if (count_less_than_or_equal_to_bound) {
-//    artificial.first = node_size;
-//    artificial.second = 1;
-//    adjacency_count_list[node_size].push_back(artificial);
-//  }
-//
-//  for (int i = 0; (unsigned)i < node_size; i++) {
-//    if (is_accepting_state(i)) {
-//      artificial.first = i;
-//      artificial.second = 1;
-//      adjacency_count_list[node_size].push_back(artificial);
-//    }
-//  }
-//
-//  out << "A = SparseArray[{";
-//  std::string row_seperator = "";
-//  std::string col_seperator = "";
-//  int c = 0;
-//  for (auto& transitions : adjacency_count_list) {
-//    out << row_seperator;
-//    row_seperator = "";
-//    col_seperator = "";
-//    for(auto& node : transitions) {
-//      out << col_seperator;
-//      out << "{" << node.first + 1 << ", " << c + 1 << "} -> " << node.second;
-//      col_seperator = ", ";
-//      row_seperator = ", ";
-//    }
-//    c++;
-//  }
-//  out << "}];\n";
-//  // state indexes are off by one
-//  out << "numPaths = MatrixPower[A, " << bound + 2 << "][[" << this->dfa_->s + 1 << ", " << this->dfa_->ns + 1 << "]];\n";
-//  out << "Print[N[numPaths]];";
-//  out << std::endl;
-}
-
 /**
  * TODO Reimplement, combine with toDot
  *
@@ -2136,16 +2727,9 @@ void Automaton::toDotAscii(bool print_sink, std::ostream& out) {
   out << "}" << std::endl;
 */
 
-  paths state_paths, pp;
-  trace_descr tp;
   DFA_ptr dfa = dfa_;
-
-  int i, j, k, l, size, maxexp, sink;
-  pCharPair *buffer; //array of charpairs references
-  char *character;
-  pCharPair **toTrans; //array for all states, each entry is an array of charpair references
-  int *toTransIndecies;
-  char** ranges;
+  int i, k, l, sink;
+  char range_label[10];
 
   print_sink = print_sink || (dfa->ns == 1 and dfa->f[0] == -1);
   sink = find_sink(dfa);
@@ -2184,133 +2768,45 @@ void Automaton::toDotAscii(bool print_sink, std::ostream& out) {
 
   out << "\n init [shape = plaintext, label = \"\"];\n" << " init -> " << dfa->s << ";\n";
 
-  int num_of_variables = this->num_of_bdd_variables_;
-  int* variable_indices = Automaton::GetBddVariableIndices(num_of_variables);
-
-  maxexp = 1 << num_of_variables;
-  //TODO convert into c++ style memory management
-  buffer = (pCharPair*) malloc(sizeof(pCharPair) * maxexp); //max no of chars from Si to Sj = 2^num_of_variables
-  character = (char*) malloc((num_of_variables + 1) * sizeof(char));
-  toTrans = (pCharPair**) malloc(sizeof(pCharPair*) * dfa->ns); //need this to gather all edges out to state Sj from Si
-  for (i = 0; i < dfa->ns; i++) {
-    toTrans[i] = (pCharPair*) malloc(maxexp * sizeof(pCharPair));
-  }
-  toTransIndecies = (int*) malloc(dfa->ns * sizeof(int)); //for a state Si, how many edges out to each state Sj
-
+  // labels are ascii chars for 8 bit symbols, symbol values otherwise
+  const bool is_ascii = (num_of_bdd_variables_ == 8);
   for (i = 0; i < dfa->ns; i++) {
-    //get transitions out from state i
-    state_paths = pp = make_paths(dfa->bddm, dfa->q[i]);
-
-    //init buffer
-    for (j = 0; j < dfa->ns; j++) {
-      toTransIndecies[j] = 0;
-    }
-
-    for (j = 0; j < maxexp; j++) {
-      for (k = 0; k < dfa->ns; k++) {
-        toTrans[k][j] = 0;
+    // group the char ranges out of state i by target, they stay sorted
+    std::map<int, std::vector<CharRange>> to_ranges;
+    for (auto& range : GetCharRanges(i)) {
+      if (range.next_state != sink or print_sink) {
+        to_ranges[range.next_state].push_back(range);
       }
-      buffer[j] = 0;
-    }
-
-    //gather transitions out from state i
-    //for each transition pp out from state i
-    while (pp) {
-      if (pp->to == (unsigned) sink && not print_sink) {
-        pp = pp->next;
-        continue;
-      }
-      //get mona character on transition pp
-      for (j = 0; j < num_of_variables; j++) {
-        for (tp = pp->trace; tp && (tp->index != (unsigned) variable_indices[j]); tp = tp->next)
-          ;
-
-        if (tp) {
-          if (tp->value)
-            character[j] = '1';
-          else
-            character[j] = '0';
-        } else
-          character[j] = 'X';
-      }
-      character[j] = '\0';
-      if (num_of_variables == 8) {
-        //break mona character into ranges of ascii chars (example: "0XXX000X" -> [\s-!], [0-1], [@-A], [P-Q])
-        size = 0;
-        getTransitionChars(character, num_of_variables, buffer, &size);
-        //get current index
-        k = toTransIndecies[pp->to];
-        //print ranges
-        for (l = 0; l < size; l++) {
-          toTrans[pp->to][k++] = buffer[l];
-          buffer[l] = 0;    //do not free just detach
-        }
-        toTransIndecies[pp->to] = k;
-      } else {
-//        k = toTransIndecies[pp->to];
-//        toTrans[pp->to][k] = (char*) malloc(sizeof(char) * (strlen(character) + 1));
-//        strcpy(toTrans[pp->to][k], character);
-//        toTransIndecies[pp->to] = k + 1;
-      }
-      pp = pp->next;
     }
 
     //print transitions out of state i
-    for (j = 0; j < dfa->ns; j++) {
-      size = toTransIndecies[j];
-      if (size == 0 || (sink == j && not print_sink)) {
-        continue;
-      }
-      ranges = mergeCharRanges(toTrans[j], &size);
-      //print edge from i to j
-      out << " " << i << " -> " << j << " [label=\"";
-      bool print_label = (j != sink || print_sink);
+    for (auto& entry : to_ranges) {
+      out << " " << i << " -> " << entry.first << " [label=\"";
+      const int size = entry.second.size();
       l = 0;    //to help breaking into new line
-      //for each trans k on char/range from i to j
       for (k = 0; k < size; k++) {
-        //print char/range
-        if (print_label) {
-          out << " " << ranges[k];
+        const CharRange& range = entry.second[k];
+        std::string label;
+        if (is_ascii) {
+          fillOutCharRange(range_label, (char)range.first, (char)range.last);
+          label = range_label;
+        } else if (range.first == range.last) {
+          label = std::to_string(range.first);
+        } else {
+          label = "[" + std::to_string(range.first) + "-" + std::to_string(range.last) + "]";
         }
-        l += strlen(ranges[k]);
+        out << " " << label;
+        l += label.size();
         if (l > 18) {
-          if (print_label) {
-            out << "\\n";
-          }
+          out << "\\n";
           l = 0;
         } else if (k < (size - 1)) {
-          if (print_label) {
-            out << ",";
-          }
+          out << ",";
         }
-        free(ranges[k]);
-      }      //for
-      out << "\"];\n";
-      if (size > 0)
-        free(ranges);
-    }
-    //for each state free charRange
-    //merge with loop above for better performance
-    for (j = 0; j < dfa->ns; j++) {
-      if (j == sink && not print_sink) {
-        continue;
-      }
-      size = toTransIndecies[j];
-      for (k = 0; k < size; k++) {
-        free(toTrans[j][k]);
       }
+      out << "\"];\n";
     }
-
-    kill_paths(state_paths);
-  }    //end for each state
-
-  free(character);
-  free(buffer);
-  for (i = 0; i < dfa->ns; i++) {
-    free(toTrans[i]);
   }
-  free(toTrans);
-  free(toTransIndecies);
 
   out << "}" << std::endl;
 
@@ -3226,29 +3722,11 @@ int Automaton::check_emptiness(DFA_ptr M1, int var, int* indices) {
 }
 
 int Automaton::check_intersection(DFA_ptr M1, DFA_ptr M2, int var, int* indices) {
-	DFA *M;
-	int result;
-	M = DFAIntersect(M1, M2);
-	result = 1 - check_emptiness(M, var, indices);
-	dfaFree(M);
-	return result;
+	return DFAIsIntersectionEmpty(M1, M2) ? 0 : 1;
 }
 
 int Automaton::check_equivalence(DFA_ptr M1, DFA_ptr M2, int var, int* indices) {
-	DFA *M[4];
-	int result, i;
-
-	M[0] = dfaProduct(M1, M2, dfaIMPL);
-	M[1] = dfaProduct(M2, M1, dfaIMPL);
-	M[2] = DFAIntersect(M[0], M[1]);
-	//M[3] = dfa_negate(M[2], var, indices);
-	M[3] = DFAComplement(M[2]);
-	result = check_emptiness(M[3], var, indices);
-
-	for (i = 0; i < 4; i++)
-		dfaFree(M[i]);
-
-	return result;
+	return DFAIsEqual(M1, M2) ? 1 : 0;
 }
 
 //Assume that 11111111(255) and 11111110(254) are reserved words in ASCII (the length depends on k)
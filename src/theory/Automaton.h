@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <array>
+#include <climits>
 #include <random>
 #include <ctime>
 #include <cmath>
@@ -19,11 +20,13 @@
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <stack>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <queue>
@@ -38,8 +41,12 @@
 #include "../utils/Math.h"
 #include "../boost/multiprecision/cpp_int.hpp"
 #include "../Eigen/SparseCore"
+#include "FactoryCache.h"
 #include "Graph.h"
 #include "GraphNode.h"
+#include "ModelIterator.h"
+#include "ModelRanker.h"
+#include "OperationCache.h"
 #include "options/Theory.h"
 #include "SymbolicCounter.h"
 #include "Formula.h"
@@ -55,6 +62,16 @@ using Node = std::pair<int ,int>; // pair.first = node id, pair.second node data
 using BigInteger = boost::multiprecision::cpp_int;
 using NextState = std::pair<int, std::vector<bool>>;
 
+/**
+ * Transition on an interval of symbols, bdd variable 0 is the most significant bit of a symbol, hence symbols of a
+ * single track string automaton are characters
+ */
+struct CharRange {
+  unsigned first;
+  unsigned last;
+  int next_state;
+};
+
 // for toDotAscii from libstranger
 typedef struct CharPair_ {
 	unsigned char first;
@@ -80,7 +97,7 @@ public:
   };
 
   Automaton(Automaton::Type type);
-  Automaton(Automaton::Type type, DFA_ptr dfa, int num_of_variables);
+  Automaton(Automaton::Type type, DFA_ptr dfa, int num_of_variables, const bool is_minimized = false);
   Automaton(const Automaton&);
   virtual ~Automaton();
   virtual Automaton_ptr clone() const = 0;
@@ -93,7 +110,7 @@ public:
   int get_number_of_bdd_variables();
 
   /**
-   * Checks if an automaton accepts nothing
+   * Checks if an automaton accepts nothing, dfas that are not minimized are searched for a reachable accepting state
    * @return
    */
   bool IsEmptyLanguage() const;
@@ -146,6 +163,20 @@ public:
    */
   bool IsEqual(const Automaton_ptr other_automaton) const;
 
+  /**
+   * Checks if the current automaton and the other automaton have no common accepted word, without building their product
+   * @param other_automaton
+   * @return
+   */
+  bool IsIntersectionEmpty(const Automaton_ptr other_automaton) const;
+
+  /**
+   * Checks if every word accepted by the current automaton is accepted by the other automaton
+   * @param other_automaton
+   * @return
+   */
+  bool IsSubsetOf(const Automaton_ptr other_automaton) const;
+
   /**
    * Gets the initial state id
    * @return
@@ -209,9 +240,62 @@ public:
   virtual BigInteger SymbolicCount(int bound, bool count_less_than_or_equal_to_bound = true);
   virtual BigInteger SymbolicCount(double bound, bool count_less_than_or_equal_to_bound = true);
   virtual std::map<std::string,std::vector<std::string>> GetModelsWithinBound(int num_models, int bound);
+
+  /**
+   * Gets an iterator over the accepted words in length-lexicographic order; iterator keeps the dfa alive, caller owns it
+   * @param bound maximum number of symbols in a word
+   * @return
+   */
+  virtual ModelIterator_ptr GetModelIterator(const unsigned long bound) const;
+
+  /**
+   * Gets a ranker over the models counted by the symbolic counter for the given bound; caller owns it
+   * @param bound
+   * @return
+   */
+  ModelRanker_ptr GetModelRanker(const unsigned long bound);
+
+  /**
+   * Decodes a word returned by a model iterator
+   * @param word
+   * @param model
+   * @return false if the word is not the canonical encoding of a model and has to be skipped
+   */
+  virtual bool DecodeModel(const std::vector<bool>& word, std::string& model) const;
+
+  /**
+   * Decodes any accepted word, default is the bits of the word
+   */
+  virtual std::string DecodeWord(const std::vector<bool>& word) const;
+
+  /**
+   * Encodes a model as a word
+   * @param model
+   * @param number_of_symbols length of the word when the encoding has a fixed length
+   * @param word
+   * @return false if the model cannot be encoded
+   */
+  virtual bool EncodeWord(const std::string& model, const unsigned long number_of_symbols, std::vector<bool>& word) const;
   SymbolicCounter GetSymbolicCounter();
   static void SetCountBoundExact(bool value);
 
+  /**
+   * While an instance is alive on a thread, DFAUnion and DFAIntersect skip minimization and the automata made from
+   * their results are not marked as minimized; a chain of products is then minimized once at the end. Scopes nest.
+   */
+  class MinimizationDeferral {
+   public:
+    MinimizationDeferral();
+    ~MinimizationDeferral();
+  };
+
+  static bool IsMinimizationDeferred();
+
+  /**
+   * Checks if the dfa is known to be minimal
+   */
+  bool IsMinimized() const;
+
   class Name {
   public:
     static const std::string NONE;
@@ -239,6 +323,27 @@ public:
 
 protected:
 
+  /**
+   * Kinds of witnesses searched in the product of two dfas
+   */
+  enum class ProductWitness : int {
+    INTERSECTION = 0, // accepted by both
+    DIFFERENCE,       // accepted by the first one only
+    SYMMETRIC_DIFFERENCE // accepted by exactly one of them
+  };
+
+  /**
+   * Explores the product of two dfas on the fly, breadth first from the pair of initial states, and stops
+   * at the first reachable state pair that is a witness. Product states are never allocated in mona, joint
+   * successors are enumerated by walking both bdds together. State pairs that cannot lead to a witness
+   * (rejecting sinks) are not expanded.
+   * @param dfa1
+   * @param dfa2
+   * @param witness
+   * @return true if a witness is reachable
+   */
+  static bool DFAHasProductWitness(const DFA_ptr dfa1, const DFA_ptr dfa2, const ProductWitness witness);
+
   /**
    * Checks if a minimized dfa accepts nothing
    * @param dfa
@@ -247,7 +352,7 @@ protected:
   static bool DFAIsMinimizedEmtpy(const DFA_ptr minimized_dfa);
 
   /**
-   * Checks if a dfa accepts nothing
+   * Checks if a dfa accepts nothing, i.e., no accepting state is reachable from the initial state
    * @param dfa
    * @return
    */
@@ -300,6 +405,22 @@ protected:
    */
   static bool DFAIsEqual(const DFA_ptr dfa1, const DFA_ptr dfa2);
 
+  /**
+   * Checks if the given two dfas have no common accepted word
+   * @param dfa1
+   * @param dfa2
+   * @return
+   */
+  static bool DFAIsIntersectionEmpty(const DFA_ptr dfa1, const DFA_ptr dfa2);
+
+  /**
+   * Checks if the language of the first dfa is included in the language of the second dfa
+   * @param dfa1
+   * @param dfa2
+   * @return
+   */
+  static bool DFAIsSubset(const DFA_ptr dfa1, const DFA_ptr dfa2);
+
   /**
    * Gets the initial state of the given dfa
    * @param dfa
@@ -342,6 +463,27 @@ protected:
    */
   static DFA_ptr DFAMakeEmpty(const int number_of_bdd_variables);
 
+  /**
+   * Makes a dfa from explicit transitions; symbols that are not in a range of a state go to a sink state that is added
+   * when needed
+   * @param transitions per state, sorted and disjoint char ranges
+   * @param is_accepting per state
+   * @param number_of_bdd_variables
+   * @return
+   */
+  static DFA_ptr DFAMakeFromCharRanges(const std::vector<std::vector<CharRange>>& transitions,
+                                       const std::vector<bool>& is_accepting, const int number_of_bdd_variables);
+
+  /**
+   * Splits an interval of symbols into aligned blocks, written as exceptions with don't cares for the low bits
+   * @param first
+   * @param last
+   * @param number_of_bdd_variables
+   * @return
+   */
+  static std::vector<std::string> GetCharRangeExceptions(const unsigned long first, const unsigned long last,
+                                                         const int number_of_bdd_variables);
+
   /**
    * Generates a dfa that accepts strings that are not accepted by the given dfa
    * @param
@@ -353,7 +495,7 @@ protected:
    * Generates a dfa with the union of the two given dfas
    * @param dfa1
    * @param dfa2
-   * @return
+   * @return a minimized dfa unless minimization is deferred
    */
   static DFA_ptr DFAUnion(const DFA_ptr dfa1, const DFA_ptr dfa2);
 
@@ -361,17 +503,25 @@ protected:
    * Generates a dfa with the intersection of the two given dfas
    * @param dfa1
    * @param dfa2
-   * @return
+   * @return a minimized dfa unless minimization is deferred
    */
   static DFA_ptr DFAIntersect(const DFA_ptr dfa1, const DFA_ptr dfa2);
 
   /**
-   * Generates a dfa that accepts strings that are accepted by dfa1 but not by dfa2
+   * Generates a dfa with the intersection of all given dfas. Products are taken in increasing order of number of states
+   * so that intermediate products stay small, each one is minimized and an empty intermediate result stops the rest.
+   * @param dfas
+   * @return
+   */
+  static DFA_ptr DFAIntersect(const std::vector<DFA_ptr>& dfas);
+
+  /**
+   * Generates a dfa that accepts strings that are accepted by dfa1 but not by dfa2, neither operand is changed
    * @param dfa1
    * @param dfa2
    * @return
    */
-  static DFA_ptr DFADifference(const DFA_ptr dfa1, DFA_ptr dfa2);
+  static DFA_ptr DFADifference(const DFA_ptr dfa1, const DFA_ptr dfa2);
 
   /**
    * Generates a dfa where the bdd variable in the given index of the given dfa projected away
@@ -385,6 +535,16 @@ protected:
 	 */
 	static DFA_ptr DFAProjectAway(const DFA_ptr dfa, std::vector<int> map, const std::vector<int> indices);
 
+  /**
+   * Generates a dfa where all bdd variables in the given indices are existentially quantified at once, i.e.,
+   * a single subset construction over the kept variables followed by a single minimization
+   * @param dfa
+   * @param number_of_bdd_variables
+   * @param indices
+   * @returns a minimized dfa, indices are not remapped
+   */
+  static DFA_ptr DFAProjectAwayIndices(const DFA_ptr dfa, const int number_of_bdd_variables, const std::vector<int> indices);
+
   /**
    * Generates a dfa where the bdd variable in the given index of the given dfa projected away and the index mapping is done again
    * @param dfa
@@ -429,6 +589,19 @@ protected:
    */
   static DFA_ptr DFAMakeAcceptingAnyAfterLength(const int length, const int number_of_bdd_variables);
 
+  /**
+   * Gets the memoized dfa that accepts any input that has length between start and end inclusive, the dfa is shared
+   * and must not be changed
+   */
+  static std::shared_ptr<DFA> DFAGetAcceptingAnyWithInRange(const int start, const int end,
+                                                            const int number_of_bdd_variables);
+
+  /**
+   * Gets the memoized dfa that accepts any input after reading the given number of inputs, the dfa is shared and must
+   * not be changed
+   */
+  static std::shared_ptr<DFA> DFAGetAcceptingAnyAfterLength(const int length, const int number_of_bdd_variables);
+
   /**
    * Gets set of transitions between two states
    * @param dfa
@@ -439,6 +612,27 @@ protected:
    */
   static std::set<std::string> DFAGetTransitionsFromTo(DFA_ptr dfa, const int from, const int to, const int num_of_variables);
 
+  /**
+   * Gets the number of bdd variable assignments that lead from the given state to each of its successors.
+   * Counts are computed bottom-up on the bdd; node_counts keeps the counts of visited bdd nodes so that
+   * nodes shared among states are processed only once.
+   * @param dfa
+   * @param state
+   * @param number_of_bdd_variables
+   * @param node_counts memo of bdd node id -> (successor state -> number of assignments from that node's index)
+   * @return successor state -> number of assignments
+   */
+  static std::map<int, BigInteger> DFAGetTransitionCounts(const DFA_ptr dfa, const int state, const int number_of_bdd_variables,
+                                                          std::unordered_map<unsigned, std::map<int, BigInteger>>& node_counts);
+
+  /**
+   * Gets the number of bdd variable assignments between all states and their successors.
+   * @param dfa
+   * @param number_of_bdd_variables
+   * @return for each state, successor state -> number of assignments
+   */
+  static std::vector<std::map<int, BigInteger>> DFAGetTransitionCounts(const DFA_ptr dfa, const int number_of_bdd_variables);
+
   /**
 	 * Generates a dfa that accepts that accepts the concatenated language of dfa1 and dfa2
 	 * @param dfa1
@@ -450,6 +644,10 @@ protected:
 
 
   bool isAcceptingSingleWord();
+  /**
+   * Runs the dfa on the first number_of_symbols symbols of the word
+   */
+  bool isAcceptingWord(const std::vector<bool>& word, const std::size_t number_of_symbols) const;
   // TODO update it to work for non-accepting inputs
   std::vector<bool>* getAnAcceptingWord(std::function<bool(unsigned& index)> next_node_heuristic = nullptr);
   std::vector<bool>* getAnAcceptingWordRandom(std::function<bool(unsigned& index)> next_node_heuristic = nullptr);
@@ -471,6 +669,18 @@ protected:
    */
   static int* CreateBddVariableIndices(const int number_of_bdd_variables);
 
+  /**
+   * Writes the bit_length least significant bits of n, most significant bit first, and a '\0' into the buffer.
+   * Does not allocate; builders reuse one buffer for all transitions they store with dfaStoreException.
+   * @param buffer has room for at least bit_length + 1 chars
+   */
+  static void FillBinaryFormat(unsigned long n, int bit_length, char* buffer);
+
+  /**
+   * Same as FillBinaryFormat, but least significant bit first
+   */
+  static void FillReversedBinaryFormat(unsigned long n, int bit_length, char* buffer);
+
   // TODO remove vector<char> version of binary format and use string version below
   static std::vector<char> GetBinaryFormat(unsigned long n, int bit_length);
   static std::vector<char> GetReversedBinaryFormat(unsigned long n, int bit_length);
@@ -482,6 +692,89 @@ protected:
   void Minimize();
   void ProjectAway(unsigned index);
 
+  /**
+   * Takes the ownership of the given dfa, previous dfa is freed if it is not shared anymore
+   * @param dfa
+   * @param is_minimized tells if the dfa is known to be minimal
+   */
+  void set_dfa(DFA_ptr dfa, const bool is_minimized = false);
+
+  /**
+   * Shares the dfa of the other automaton instead of copying it
+   */
+  void ShareDFA(const Automaton& other);
+
+  /**
+   * Shares a memoized dfa, it is copied only when the automaton changes it
+   */
+  void ShareDFA(std::shared_ptr<DFA> dfa, const bool is_minimized);
+
+  /**
+   * Gets the result of an operation on the dfas of the given automata from the operation cache, computes it if it is
+   * not cached. Results are shared with the cache, automata take them with ShareDFA. Only minimized results are
+   * cached, the cache is bypassed while minimization is deferred.
+   * @param compute computes the result
+   */
+  static std::shared_ptr<DFA> GetOrComputeDFA(const OperationCache::Operation operation,
+                                              const std::vector<const Automaton*>& operands,
+                                              const std::vector<int>& parameters, std::function<DFA_ptr()> compute);
+
+  /**
+   * Copies the dfa if it is shared with other automata (copy-on-write), drops the metadata index and the minimized
+   * mark since the dfa is about to change in place
+   */
+  void MakeDFAUnique();
+
+  /**
+   * Structural information about a dfa, built once and shared by the graph queries on the automaton
+   */
+  struct Metadata {
+    const DFA* dfa; // dfa the index is built for
+    int sink_state; // -1 if there is no sink state
+    bool is_cyclic; // a cycle other than the sink loop is reachable from the initial state
+    std::vector<std::vector<int>> next_states;
+    std::vector<std::vector<int>> previous_states;
+    std::vector<int> scc_ids; // in reverse topological order, i.e., successors have smaller or equal ids
+    std::vector<bool> is_in_cycle;
+    std::vector<int> distance_to_accepting; // one backward search from accepting states, INT_MAX if none is reachable
+    std::vector<bool> is_reachable; // from the initial state
+  };
+
+  /**
+   * Gets the metadata index of the current dfa, builds it on first use
+   */
+  const Metadata& GetMetadata() const;
+
+  /**
+   * Drops the metadata index, called whenever the dfa is replaced or about to be changed in place
+   */
+  void InvalidateMetadata();
+
+  /**
+   * Explicit transitions of a dfa, built once from the bdds and shared like the metadata index
+   */
+  struct CharRangeIndex {
+    const DFA* dfa; // dfa the index is built for
+    std::vector<std::vector<CharRange>> ranges; // per state, sorted and covering all symbols
+  };
+
+  /**
+   * Tells if single step traversals read the char range index instead of walking the bdds, only for automata with at
+   * most MAX_CHAR_RANGE_BITS bdd variables
+   */
+  virtual bool UsesCharRanges() const;
+
+  /**
+   * Gets the transitions of a state as sorted intervals that cover all symbols, neighbor intervals go to different
+   * states; the index is built for all states on first use
+   */
+  const std::vector<CharRange>& GetCharRanges(const int state) const;
+
+  /**
+   * Finds the target of a symbol with a binary search over the char ranges of the state
+   */
+  int GetNextStateForChar(const int state, const unsigned symbol) const;
+
   bool hasIncomingTransition(int state);
   // todo will remove temp function
   static bool TEMPisStartStateReachableFromAnAcceptingState(DFA_ptr dfa);
@@ -492,17 +785,12 @@ protected:
   std::vector<NextState> getNextStatesOrdered(int state, std::function<bool(unsigned& index)> next_node_heuristic = nullptr);
   std::set<int> getStatesReachableBy(int walk);
   std::set<int> getStatesReachableBy(int min_walk, int max_walk);
-  bool getAnAcceptingWord(NextState& state, std::map<int, bool>& is_stack_member, std::vector<bool>& path, std::function<bool(unsigned& index)> next_node_heuristic = nullptr);
   
 
   virtual void SetSymbolicCounter();
   virtual void decide_counting_schema(Eigen::SparseMatrix<BigInteger>& mm);
-  void generateGFScript(int bound, std::ostream& out = std::cout, bool count_less_than_or_equal_to_bound = true);
-  void generateMatrixScript(int bound, std::ostream& out = std::cout, bool count_less_than_or_equal_to_bound = true);
 
 
-  bool isCyclic(int state, std::map<int, bool>& is_discovered, std::map<int, bool>& is_stack_member);
-  bool isStateReachableFrom(int search_state, int from_state, std::map<int, bool>& is_stack_member);
 
   /*
    * Operations from LIBSTRANGER
@@ -641,16 +929,43 @@ protected:
   int num_of_bdd_variables_;
 
   /**
-   * Mona dfa pointer
+   * Mona dfa pointer, aliases the shared dfa for read access
    */
   DFA_ptr dfa_;
 
+  /**
+   * Reference counted dfa, copies of an automaton share it and the last one frees it.
+   * Use set_dfa to replace the dfa and MakeDFAUnique before changing it in place.
+   */
+  std::shared_ptr<DFA> shared_dfa_;
+
+  /**
+   * Dfa is known to be minimal, set only where the dfa is minimized
+   */
+  bool is_minimized_;
+
+  /**
+   * Lazily built metadata index of the dfa, shared with copies as long as they share the dfa
+   */
+  mutable std::shared_ptr<const Metadata> metadata_;
+
+  /**
+   * Lazily built char range index of the dfa, shared and dropped together with the metadata index
+   */
+  mutable std::shared_ptr<const CharRangeIndex> char_range_index_;
+
   /**
    * Model counter function
    */
   SymbolicCounter counter_;
 
   static bool count_bound_exact_;
+  static thread_local int minimization_deferral_depth_;
+
+  /**
+   * Char ranges are built for automata with at most this many bdd variables
+   */
+  static const int MAX_CHAR_RANGE_BITS;
 private:
   char* getAnExample(bool accepting=true); // MONA version
   // for debugging
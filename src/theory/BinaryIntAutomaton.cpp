@@ -27,8 +27,9 @@ BinaryIntAutomaton::BinaryIntAutomaton(DFA_ptr dfa, int num_of_variables, bool i
       formula_ { nullptr } {
 }
 
-BinaryIntAutomaton::BinaryIntAutomaton(DFA_ptr dfa, ArithmeticFormula_ptr formula, bool is_natural_number)
-    : Automaton(Automaton::Type::BINARYINT, dfa, formula->GetNumberOfVariables()),
+BinaryIntAutomaton::BinaryIntAutomaton(DFA_ptr dfa, ArithmeticFormula_ptr formula, bool is_natural_number,
+                                       const bool is_minimized)
+    : Automaton(Automaton::Type::BINARYINT, dfa, formula->GetNumberOfVariables(), is_minimized),
       is_natural_number_ { is_natural_number },
       formula_ { formula } {
 }
@@ -272,7 +273,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeAutomaton(SemilinearSet_ptr semil
     number_of_variables = number_of_variables - 1;
   }
 
-  auto binary_auto = new BinaryIntAutomaton(dfaMinimize(binary_dfa), formula, not add_leading_zeros);
+  auto binary_auto = new BinaryIntAutomaton(dfaMinimize(binary_dfa), formula, not add_leading_zeros, true);
   dfaFree(binary_dfa);
   binary_dfa = nullptr;
 
@@ -332,7 +333,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::Complement() {
 
   dfaNegation(complement_dfa);
 
-  auto tmp_auto = new BinaryIntAutomaton(complement_dfa, this->formula_->clone(), is_natural_number_);
+  auto tmp_auto = new BinaryIntAutomaton(complement_dfa, this->formula_->clone(), is_natural_number_, is_minimized_);
   // a complemented auto may have initial state accepting, we should be safely avoided from that
   auto any_int_auto = BinaryIntAutomaton::MakeAnyInt(this->formula_->clone(), is_natural_number_);
   auto complement_auto = any_int_auto->Intersect(tmp_auto);
@@ -345,7 +346,9 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::Complement() {
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::Intersect(BinaryIntAutomaton_ptr other_auto) {
-  auto intersect_dfa = Automaton::DFAIntersect(this->dfa_, other_auto->dfa_);
+  auto intersect_dfa = GetOrComputeDFA(OperationCache::Operation::INTERSECT, {this, other_auto}, {}, [this, other_auto]() {
+    return Automaton::DFAIntersect(this->dfa_, other_auto->dfa_);
+  });
   ArithmeticFormula_ptr intersect_formula = nullptr;
   if(formula_ != nullptr && other_auto->formula_ != nullptr) {
 		intersect_formula = formula_->Intersect(other_auto->formula_);
@@ -356,14 +359,41 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::Intersect(BinaryIntAutomaton_ptr othe
 	}
   intersect_formula->ResetCoefficients();
   intersect_formula->SetType(ArithmeticFormula::Type::INTERSECT);
-  auto intersect_auto = new BinaryIntAutomaton(intersect_dfa, intersect_formula, is_natural_number_);
+  auto intersect_auto = new BinaryIntAutomaton(nullptr, intersect_formula, is_natural_number_);
+  intersect_auto->ShareDFA(intersect_dfa, not IsMinimizationDeferred());
 
   DVLOG(VLOG_LEVEL) << intersect_auto->id_ << " = [" << this->id_ << "]->Intersect(" << other_auto->id_ << ")";
   return intersect_auto;
 }
 
+BinaryIntAutomaton_ptr BinaryIntAutomaton::Intersect(const std::vector<BinaryIntAutomaton_ptr>& automata) {
+  CHECK(not automata.empty());
+  BinaryIntAutomaton_ptr first_auto = automata.front();
+  std::vector<DFA_ptr> dfas;
+  ArithmeticFormula_ptr intersect_formula = first_auto->formula_->clone();
+  for (auto binary_auto : automata) {
+    dfas.push_back(binary_auto->dfa_);
+    if (binary_auto != first_auto and binary_auto->formula_ != nullptr) {
+      ArithmeticFormula_ptr tmp_formula = intersect_formula;
+      intersect_formula = tmp_formula->Intersect(binary_auto->formula_);
+      delete tmp_formula;
+    }
+  }
+  intersect_formula->ResetCoefficients();
+  intersect_formula->SetType(ArithmeticFormula::Type::INTERSECT);
+
+  // a single operand is copied as it is
+  const bool is_minimized = (dfas.size() > 1) ? not IsMinimizationDeferred() : first_auto->is_minimized_;
+  auto intersect_auto = new BinaryIntAutomaton(Automaton::DFAIntersect(dfas), intersect_formula,
+                                               first_auto->is_natural_number_, is_minimized);
+  DVLOG(VLOG_LEVEL) << intersect_auto->id_ << " = Intersect(<" << automata.size() << " automata>)";
+  return intersect_auto;
+}
+
 BinaryIntAutomaton_ptr BinaryIntAutomaton::Union(BinaryIntAutomaton_ptr other_auto) {
-  auto union_dfa = Automaton::DFAUnion(this->dfa_, other_auto->dfa_);
+  auto union_dfa = GetOrComputeDFA(OperationCache::Operation::UNION, {this, other_auto}, {}, [this, other_auto]() {
+    return Automaton::DFAUnion(this->dfa_, other_auto->dfa_);
+  });
   ArithmeticFormula_ptr union_formula = nullptr;
 	if(formula_ != nullptr && other_auto->formula_ != nullptr) {
 		union_formula = formula_->Union(other_auto->formula_);
@@ -374,7 +404,8 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::Union(BinaryIntAutomaton_ptr other_au
 	}
   union_formula->ResetCoefficients();
   union_formula->SetType(ArithmeticFormula::Type::UNION);
-  auto union_auto = new BinaryIntAutomaton(union_dfa, union_formula, is_natural_number_);
+  auto union_auto = new BinaryIntAutomaton(nullptr, union_formula, is_natural_number_);
+  union_auto->ShareDFA(union_dfa, not IsMinimizationDeferred());
 
   DVLOG(VLOG_LEVEL) << union_auto->id_ << " = [" << this->id_ << "]->Union(" << other_auto->id_ << ")";
   return union_auto;
@@ -390,8 +421,29 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::Difference(BinaryIntAutomaton_ptr oth
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::Exists(std::string var_name) {
-  LOG(FATAL)<< "implement me";
-  return nullptr;
+  CHECK_EQ(num_of_bdd_variables_, formula_->GetNumberOfVariables())<< "number of variables is not consistent with formula";
+  int bdd_var_index = formula_->GetVariableIndex(var_name);
+  // variables are ordered by name, the ones after the removed variable shift down by one
+  std::vector<int> indices_map;
+  for (int i = 0, j = 0; i < num_of_bdd_variables_; ++i) {
+    indices_map.push_back((i == bdd_var_index) ? (num_of_bdd_variables_ - 1) : j++);
+  }
+  std::vector<int> parameters {(int)indices_map.size()};
+  parameters.insert(parameters.end(), indices_map.begin(), indices_map.end());
+  parameters.push_back(bdd_var_index);
+  auto exists_dfa = GetOrComputeDFA(OperationCache::Operation::PROJECT_AWAY_AND_REMAP, {this}, parameters,
+      [this, &indices_map, bdd_var_index]() {
+    return Automaton::DFAProjectAway(this->dfa_, indices_map, {bdd_var_index});
+  });
+  auto exists_formula = formula_->clone();
+  exists_formula->RemoveVariable(var_name);
+  exists_formula->ResetCoefficients();
+  exists_formula->SetType(ArithmeticFormula::Type::INTERSECT);
+  auto exists_auto = new BinaryIntAutomaton(nullptr, exists_formula, is_natural_number_);
+  exists_auto->ShareDFA(exists_dfa, true);
+
+  DVLOG(VLOG_LEVEL) << exists_auto->id_ << " = [" << this->id_ << "]->Exists(" << var_name << ")";
+  return exists_auto;
 }
 
 BinaryIntAutomaton_ptr BinaryIntAutomaton::GetBinaryAutomatonFor(std::string var_name) {
@@ -435,6 +487,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::TrimLeadingZeros() {
   CHECK_EQ(1, num_of_bdd_variables_)<< "trimming is implemented for single track positive binary automaton";
 
   auto tmp_auto = this->clone();
+  tmp_auto->MakeDFAUnique();
 
   // identify leading zeros
   std::vector<char> exception = {'0'};
@@ -756,48 +809,113 @@ std::map<std::string, int> BinaryIntAutomaton::GetAnAcceptingIntForEachVar() {
   return var_values;
 }
 
-void BinaryIntAutomaton::decide_counting_schema(Eigen::SparseMatrix<BigInteger>& count_matrix) {
+/**
+ * Iterating the words of an integer automaton would return every encoding of the same value, and the encodings of a
+ * value are infinitely many, hence the iterator runs on words that cannot be shortened without changing the value.
+ */
+ModelIterator_ptr BinaryIntAutomaton::GetModelIterator(const unsigned long bound) const {
+  CHECK_EQ(1, num_of_bdd_variables_) << "models are iterated for a single variable";
+  auto canonical_helper_dfa = BinaryIntAutomaton::MakeCanonicalHelperDFA(is_natural_number_);
+  auto canonical_dfa = Automaton::DFAIntersect(this->dfa_, canonical_helper_dfa);
+  dfaFree(canonical_helper_dfa);
+  return new ModelIterator(std::shared_ptr<DFA>(canonical_dfa, dfaFree), num_of_bdd_variables_, bound);
+}
+
+/**
+ * Words are read least significant bit first, last bit is the sign bit for integers. An integer has many encodings
+ * since repeating the last bit (adding a leading zero for natural numbers) does not change its value; an encoding is
+ * skipped when its one bit shorter prefix also encodes the same value and is accepted, which the iterator has already
+ * returned since shorter words come first.
+ */
+bool BinaryIntAutomaton::DecodeModel(const std::vector<bool>& word, std::string& model) const {
+  CHECK_EQ(1, num_of_bdd_variables_) << "models are decoded for a single variable";
+  const std::size_t length = word.size();
   if (is_natural_number_) {
-    counter_.set_type(SymbolicCounter::Type::BINARYUNSIGNEDINT);
-  } else {
-    counter_.set_type(SymbolicCounter::Type::BINARYINT);
+    if (length > 0 and not word[length - 1] and isAcceptingWord(word, length - 1)) {
+      return false;
+    }
+  } else if (length == 0) {
+    return false;
+  } else if (length > 1 and word[length - 1] == word[length - 2] and isAcceptingWord(word, length - 1)) {
+    return false;
   }
+  model = DecodeWord(word);
+  return true;
 }
 
-BigInteger BinaryIntAutomaton::SymbolicCount(double bound, bool count_less_than_or_equal_to_bound) {
-  std::stringstream cmd;
-  std::string str_result;
-  std::string tmp_result_file = Option::Theory::TMP_PATH + "/arith_result.dot";
-  std::string math_script_path = Option::Theory::SCRIPT_PATH + "/count.m";
-
-  std::ofstream outfile(tmp_result_file.c_str());
-  if (!outfile.good()) {
-    std::cout << "cannot open file: " << tmp_result_file << std::endl;
-    exit(2);
+std::string BinaryIntAutomaton::DecodeWord(const std::vector<bool>& word) const {
+  CHECK_EQ(1, num_of_bdd_variables_) << "models are decoded for a single variable";
+  const std::size_t length = word.size();
+  const bool is_negative = (not is_natural_number_) and length > 0 and word[length - 1];
+  const std::size_t number_of_value_bits = (is_natural_number_ or length == 0) ? length : length - 1;
+  BigInteger value = 0;
+  for (std::size_t i = number_of_value_bits; i > 0; --i) {
+    value <<= 1;
+    if (word[i - 1]) {
+      value |= 1;
+    }
   }
+  if (is_negative) {
+    value -= BigInteger(1) << number_of_value_bits;
+  }
+  return value.str();
+}
 
-  this->ToDot(outfile, false);
-
-  cmd << "math -script " << math_script_path << " " << tmp_result_file << " ";
+/**
+ * Two's complement of the value with the given number of bits, sign bit included for integers; model is a decimal
+ * integer and it is rejected if it does not fit in the number of symbols
+ */
+bool BinaryIntAutomaton::EncodeWord(const std::string& model, const unsigned long number_of_symbols, std::vector<bool>& word) const {
+  CHECK_EQ(1, num_of_bdd_variables_) << "models are encoded for a single variable";
+  const std::size_t first_digit = (not model.empty() and model[0] == '-') ? 1 : 0;
+  if (first_digit == model.size() or model.find_first_not_of("0123456789", first_digit) != std::string::npos) {
+    DVLOG(VLOG_LEVEL) << "model is not an integer: " << model;
+    return false;
+  }
+  BigInteger value (model);
+  const unsigned long number_of_value_bits = is_natural_number_ ? number_of_symbols : number_of_symbols - 1;
+  const BigInteger limit = BigInteger(1) << number_of_value_bits;
+  if (is_natural_number_) {
+    if (value < 0 or value >= limit) {
+      DVLOG(VLOG_LEVEL) << "model does not fit in " << number_of_symbols << " bits: " << model;
+      return false;
+    }
+  } else {
+    if (number_of_symbols == 0 or value < -limit or value >= limit) {
+      DVLOG(VLOG_LEVEL) << "model does not fit in " << number_of_symbols << " bits: " << model;
+      return false;
+    }
+    if (value < 0) {
+      value += limit << 1;
+    }
+  }
 
-  if (not is_natural_number_) {
-    ++bound;  // consider sign bit
+  word.assign(number_of_symbols, false);
+  for (unsigned long i = 0; i < number_of_symbols; ++i) {
+    word[i] = boost::multiprecision::bit_test(value, i);
   }
+  return true;
+}
 
-  if (std::floor(bound) == bound) {
-    cmd << static_cast<int>(bound);
+void BinaryIntAutomaton::decide_counting_schema(Eigen::SparseMatrix<BigInteger>& count_matrix) {
+  if (is_natural_number_) {
+    counter_.set_type(SymbolicCounter::Type::BINARYUNSIGNEDINT);
   } else {
-    cmd << bound;
+    counter_.set_type(SymbolicCounter::Type::BINARYINT);
   }
+}
 
-  try {
-    DVLOG(VLOG_LEVEL) << "run_cmd(`" << cmd.str() << "`)";
-    str_result = Util::Cmd::run_cmd(cmd.str());
-  } catch (std::string& e) {
-    LOG(ERROR)<< e;
+/**
+ * Integers that fit in bound bits already include all integers with fewer bits,
+ * hence there is no distinction between exact and less than or equal to bound counts.
+ */
+BigInteger BinaryIntAutomaton::SymbolicCount(double bound, bool count_less_than_or_equal_to_bound) {
+  if (not is_counter_cached_) {
+    SetSymbolicCounter();
   }
-
-  return BigInteger(str_result);
+  BigInteger result = counter_.CountbyRecurrence(static_cast<unsigned long>(bound));
+  DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->symbolic_count(" << bound << ") : " << result;
+  return result;
 }
 
 std::map<std::string,std::vector<std::string>> BinaryIntAutomaton::GetModelsWithinBound(int num_models, int bound) {
@@ -817,52 +935,7 @@ std::map<std::string,std::vector<std::string>> BinaryIntAutomaton::GetModelsWith
 		bound = counter.GetMinBound(num_models);
 	}
 
-//	LOG(INFO) << "num_models : " << num_models;
-//	LOG(INFO) << "bound      : " << bound;
-
-  // compute BFS for unweighted graph (dfa)
-  std::queue<int> states_to_process;
-  std::vector<int> distances(this->dfa_->ns,INT_MAX);
-  std::set<int> final_states;
-
-  std::vector<int> shortest_accepting_path(this->dfa_->ns,INT_MAX);
-  for(int start_state = 0; start_state < this->dfa_->ns; start_state++) {
-  	distances[start_state] = 0;
-		states_to_process.push(start_state);
-
-		while(not states_to_process.empty()) {
-			int s = states_to_process.front();
-			states_to_process.pop();
-			// mark final states for later
-			if(this->dfa_->f[s] == 1) {
-				final_states.insert(s);
-			}
-
-			for(auto iter : getNextStates(s)) {
-				if(distances[iter] == INT_MAX) {
-					states_to_process.push(iter);
-					distances[iter] = distances[s] + 1;
-				}
-			}
-		}
-
-		int shortest = INT_MAX;
-		for(auto final : final_states) {
-			if(distances[final] < shortest) {
-				shortest = distances[final];
-			}
-		}
-		shortest_accepting_path[start_state] = shortest;
-
-
-		distances = std::vector<int>(this->dfa_->ns,INT_MAX);
-  }
-
-//  for(int i = 0; i < this->dfa_->ns; i++) {
-//  	LOG(INFO) << "shortest path for state " << i << " = " << shortest_accepting_path[i];
-//  }
-//
-//  LOG(INFO) << "Done computing shortest paths to final state";
+  const std::vector<int>& shortest_accepting_path = GetMetadata().distance_to_accepting;
 
   // assume num_tracks > 1; Otherwise, juse call normal version
   int models_so_far = 0;
@@ -1363,6 +1436,16 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEquality(ArithmeticFormula_ptr
   CHECK_LT(active_num_variables, 64);
   // TODO instead of doing shift, try to update algorithm
   unsigned long transitions = 1 << active_num_variables;  //number of transitions from each state
+  // exceptions are filled in place, only the bits of the active variables change between transitions
+  std::vector<int> active_variable_indices;
+  for (int i = 0; i < total_num_variables; ++i) {
+    if (coeffs[i] != 0) {
+      active_variable_indices.push_back(i);
+    }
+  }
+  std::vector<char> binary_string (active_num_variables + 1, '\0');
+  std::vector<char> current_exception (total_num_variables + 1, 'X');
+  current_exception.back() = '\0';
 
   int* indices = GetBddVariableIndices(total_num_variables);
   dfaSetup(num_of_states, total_num_variables, indices);
@@ -1394,14 +1477,9 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEquality(ArithmeticFormula_ptr
     for (unsigned long j = 0; j < transitions; j++) {
       result = next_label + formula->CountOnes(j);
       if (not (result & 1)) {
-        std::vector<char> binary_string = GetReversedBinaryFormat(j, active_num_variables);
-        std::vector<char> current_exception(total_num_variables, 'X');
-        current_exception.push_back('\0');
-        for (int i = 0, k = 0; i < total_num_variables; i++) {
-          if (coeffs[i] != 0) {
-            current_exception[i] = binary_string[k];
-            ++k;
-          }
+        FillReversedBinaryFormat(j, active_num_variables, &binary_string[0]);
+        for (int k = 0; k < active_num_variables; ++k) {
+          current_exception[active_variable_indices[k]] = binary_string[k];
         }
         for (auto& it : boolean_variables) {
         	int temp_index = coeffs_map[it.first];
@@ -1499,7 +1577,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntEquality(ArithmeticFormula_ptr
   //delete[] indices;
   delete[] statuses;
 
-  auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, false);
+  auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, false, true);
   CHECK_EQ(false, equality_auto->IsInitialStateAccepting());
 
   DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeIntEquality(" << *formula << ")";
@@ -1547,6 +1625,16 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticF
   CHECK_LT(active_num_variables, 64);
   // TODO instead of doing shift, try to update algorithm
   unsigned long transitions = 1 << active_num_variables;  //number of transitions from each state
+  // exceptions are filled in place, only the bits of the active variables change between transitions
+  std::vector<int> active_variable_indices;
+  for (int i = 0; i < total_num_variables; ++i) {
+    if (coeffs[i] != 0) {
+      active_variable_indices.push_back(i);
+    }
+  }
+  std::vector<char> binary_string (active_num_variables + 1, '\0');
+  std::vector<char> current_exception (total_num_variables + 1, 'X');
+  current_exception.back() = '\0';
 
   int* indices = GetBddVariableIndices(total_num_variables);
   dfaSetup(num_of_states, total_num_variables, indices);
@@ -1580,14 +1668,9 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticF
           carry_map[target].i = next_index;
         }
 
-        std::vector<char> binary_string = GetReversedBinaryFormat(j, active_num_variables);
-        std::vector<char> current_exception(total_num_variables, 'X');
-        current_exception.push_back('\0');
-        for (int i = 0, k = 0; i < total_num_variables; i++) {
-          if (coeffs[i] != 0) {
-            current_exception[i] = binary_string[k];
-            ++k;
-          }
+        FillReversedBinaryFormat(j, active_num_variables, &binary_string[0]);
+        for (int k = 0; k < active_num_variables; ++k) {
+          current_exception[active_variable_indices[k]] = binary_string[k];
         }
         for (auto& it : boolean_variables) {
 					int temp_index = coeffs_map[it.first];
@@ -1668,7 +1751,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberEquality(ArithmeticF
   //delete[] indices;
   delete[] statuses;
 
-  auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, true);
+  auto equality_auto = new BinaryIntAutomaton(equality_dfa, formula, true, true);
   CHECK_EQ(false, equality_auto->IsInitialStateAccepting());
 
   DVLOG(VLOG_LEVEL) << equality_auto->id_ << " = MakeNaturalNumberEquality(" << *formula << ")";
@@ -1718,6 +1801,16 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr
   CHECK_LT(active_num_variables, 64);
   // TODO instead of doing shift, try to update algorithm
   unsigned long transitions = 1 << active_num_variables;  //number of transitions from each state
+  // exceptions are filled in place, only the bits of the active variables change between transitions
+  std::vector<int> active_variable_indices;
+  for (int i = 0; i < total_num_variables; ++i) {
+    if (coeffs[i] != 0) {
+      active_variable_indices.push_back(i);
+    }
+  }
+  std::vector<char> binary_string (active_num_variables + 1, '\0');
+  std::vector<char> current_exception (total_num_variables + 1, 'X');
+  current_exception.back() = '\0';
 
   int* indices = GetBddVariableIndices(total_num_variables);
   dfaSetup(num_of_states, total_num_variables, indices);
@@ -1765,14 +1858,9 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr
         write1 = result & 1;
       }
 
-      std::vector<char> binary_string = GetReversedBinaryFormat(j, active_num_variables);
-      std::vector<char> current_exception(total_num_variables, 'X');
-      current_exception.push_back('\0');
-      for (int i = 0, k = 0; i < total_num_variables; i++) {
-        if (coeffs[i] != 0) {
-          current_exception[i] = binary_string[k];
-          ++k;
-        }
+      FillReversedBinaryFormat(j, active_num_variables, &binary_string[0]);
+      for (int k = 0; k < active_num_variables; ++k) {
+        current_exception[active_variable_indices[k]] = binary_string[k];
       }
       for (auto& it : boolean_variables) {
 				int temp_index = coeffs_map[it.first];
@@ -1836,7 +1924,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeIntLessThan(ArithmeticFormula_ptr
   //delete[] indices;
   delete[] statuses;
 
-  auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, false);
+  auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, false, true);
   CHECK_EQ(false, less_than_auto->IsInitialStateAccepting());
 
   DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeIntLessThan(" << *formula << ")";
@@ -1879,6 +1967,16 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticF
   CHECK_LT(active_num_variables, 64);
   // TODO instead of allocating that many of transitions, try to reduce them with a preprocessing
   unsigned long transitions = 1 << active_num_variables;  //number of transitions from each state
+  // exceptions are filled in place, only the bits of the active variables change between transitions
+  std::vector<int> active_variable_indices;
+  for (int i = 0; i < total_num_variables; ++i) {
+    if (coeffs[i] != 0) {
+      active_variable_indices.push_back(i);
+    }
+  }
+  std::vector<char> binary_string (active_num_variables + 1, '\0');
+  std::vector<char> current_exception (total_num_variables + 1, 'X');
+  current_exception.back() = '\0';
 
   int* indices = GetBddVariableIndices(total_num_variables);
   dfaSetup(num_of_states, total_num_variables, indices);
@@ -1914,14 +2012,9 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticF
         carry_map[target].i = next_index;
       }
 
-      std::vector<char> binary_string = GetReversedBinaryFormat(j, active_num_variables);
-      std::vector<char> current_exception(total_num_variables, 'X');
-      current_exception.push_back('\0');
-      for (int i = 0, k = 0; i < total_num_variables; i++) {
-        if (coeffs[i] != 0) {
-          current_exception[i] = binary_string[k];
-          ++k;
-        }
+      FillReversedBinaryFormat(j, active_num_variables, &binary_string[0]);
+      for (int k = 0; k < active_num_variables; ++k) {
+        current_exception[active_variable_indices[k]] = binary_string[k];
       }
       for (auto& it : boolean_variables) {
 				int temp_index = coeffs_map[it.first];
@@ -1994,7 +2087,7 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeNaturalNumberLessThan(ArithmeticF
   //delete[] indices;
   delete[] statuses;
 
-  auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, true);
+  auto less_than_auto = new BinaryIntAutomaton(less_than_dfa, formula, true, true);
   CHECK_EQ(false, less_than_auto->IsInitialStateAccepting());
 
   DVLOG(VLOG_LEVEL) << less_than_auto->id_ << " = MakeNaturalNumberLessThan(" << *formula << ")";
@@ -2089,6 +2182,41 @@ BinaryIntAutomaton_ptr BinaryIntAutomaton::MakeTrimHelperAuto(int var_index, int
   return trim_helper_auto;
 }
 
+DFA_ptr BinaryIntAutomaton::MakeCanonicalHelperDFA(const bool is_natural_number) {
+  char exception[] = "1";
+  int* indices = GetBddVariableIndices(1);
+  DFA_ptr canonical_helper_dfa = nullptr;
+  if (is_natural_number) {
+    // 0: no bit, 1: "0", 2: last bit is 1, 3: last bit is a leading zero
+    char statuses[5] = { '+', '+', '+', '-', '\0' };
+    int on_zero[4] = { 1, 3, 3, 3 };
+    int on_one[4] = { 2, 2, 2, 2 };
+    dfaSetup(4, 1, indices);
+    for (int s = 0; s < 4; s++) {
+      dfaAllocExceptions(1);
+      dfaStoreException(on_one[s], exception);
+      dfaStoreState(on_zero[s]);
+    }
+    canonical_helper_dfa = dfaBuild(statuses);
+  } else {
+    // 0: no bit, 1: "0", 2: "1", 3: "00", 4: "11", 5: ends with 10, 6: ends with 01,
+    // 7: ends with 00 and longer than two bits, 8: ends with 11 and longer than two bits
+    char statuses[10] = { '+', '+', '+', '+', '+', '+', '+', '-', '-', '\0' };
+    int on_zero[9] = { 1, 3, 5, 7, 5, 7, 5, 7, 5 };
+    int on_one[9] = { 2, 6, 4, 6, 8, 6, 8, 6, 8 };
+    dfaSetup(9, 1, indices);
+    for (int s = 0; s < 9; s++) {
+      dfaAllocExceptions(1);
+      dfaStoreException(on_one[s], exception);
+      dfaStoreState(on_zero[s]);
+    }
+    canonical_helper_dfa = dfaBuild(statuses);
+  }
+
+  DVLOG(VLOG_LEVEL) << "[BinaryIntAutomaton]->MakeCanonicalHelperDFA(" << std::boolalpha << is_natural_number << ")";
+  return canonical_helper_dfa;
+}
+
 void BinaryIntAutomaton::ComputeBinaryStates(std::vector<BinaryState_ptr>& binary_states,
                                                SemilinearSet_ptr semilinear_set) {
   if (semilinear_set->get_period() == 0) {
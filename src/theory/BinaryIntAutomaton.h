@@ -49,7 +49,7 @@ public:
 
   BinaryIntAutomaton(bool is_natural_number);
   BinaryIntAutomaton(DFA_ptr, int num_of_variables, bool is_natural_number);
-  BinaryIntAutomaton(DFA_ptr, ArithmeticFormula_ptr formula, bool is_natural_number);
+  BinaryIntAutomaton(DFA_ptr, ArithmeticFormula_ptr formula, bool is_natural_number, const bool is_minimized = false);
   BinaryIntAutomaton(const BinaryIntAutomaton&);
   virtual ~BinaryIntAutomaton();
 
@@ -71,6 +71,11 @@ public:
   bool HasNegative1();
   BinaryIntAutomaton_ptr Complement();
   BinaryIntAutomaton_ptr Intersect(BinaryIntAutomaton_ptr);
+
+  /**
+   * Intersects all given automata in increasing order of size, stops as soon as an intermediate result is empty.
+   */
+  static BinaryIntAutomaton_ptr Intersect(const std::vector<BinaryIntAutomaton_ptr>& automata);
   BinaryIntAutomaton_ptr Union(BinaryIntAutomaton_ptr);
   BinaryIntAutomaton_ptr Difference(BinaryIntAutomaton_ptr);
   BinaryIntAutomaton_ptr Exists(std::string var_name);
@@ -86,6 +91,10 @@ public:
 
   BigInteger SymbolicCount(double bound, bool count_less_than_or_equal_to_bound = false) override;
   std::map<std::string,std::vector<std::string>> GetModelsWithinBound(int num_models, int bound) override;
+  ModelIterator_ptr GetModelIterator(const unsigned long bound) const override;
+  bool DecodeModel(const std::vector<bool>& word, std::string& model) const override;
+  std::string DecodeWord(const std::vector<bool>& word) const override;
+  bool EncodeWord(const std::string& model, const unsigned long number_of_symbols, std::vector<bool>& word) const override;
 
 protected:
   BinaryIntAutomaton(ArithmeticFormula_ptr formula);
@@ -101,6 +110,12 @@ protected:
   static BinaryIntAutomaton_ptr MakeGreaterThan(ArithmeticFormula_ptr, bool is_natural_number);
   static BinaryIntAutomaton_ptr MakeGreaterThanOrEqual(ArithmeticFormula_ptr, bool is_natural_number);
   static BinaryIntAutomaton_ptr MakeTrimHelperAuto(int var_index, int number_of_variables);
+  /**
+   * Single variable dfa that accepts the words that do not end with a redundant bit, i.e., words whose last two bits
+   * differ for integers and words that end with 1 for natural numbers; shortest words are accepted as well, such as "00"
+   * and "0", since the automaton may not accept fewer bits
+   */
+  static DFA_ptr MakeCanonicalHelperDFA(const bool is_natural_number);
   static void ComputeBinaryStates(std::vector<BinaryState_ptr>& binary_states,
           SemilinearSet_ptr semilinear_set);
   static void AddBinaryState(std::vector<BinaryState_ptr>& binary_states,
@@ -0,0 +1,116 @@
+/*
+ * FactoryCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "FactoryCache.h"
+
+#include <cstdint>
+#include <sstream>
+
+namespace Vlab {
+namespace Theory {
+
+const int FactoryCache::VLOG_LEVEL = 20;
+
+const std::size_t FactoryCache::DEFAULT_CAPACITY = 512;
+
+FactoryCache::FactoryCache() : capacity_(DEFAULT_CAPACITY), hits_(0), misses_(0), evictions_(0) {
+}
+
+FactoryCache::~FactoryCache() {
+  Clear();
+}
+
+FactoryCache& FactoryCache::Instance() {
+  static FactoryCache factory_cache;
+  return factory_cache;
+}
+
+std::shared_ptr<DFA> FactoryCache::GetOrMake(const Factory factory, const std::vector<int>& parameters,
+                                             std::function<DFA*()> make) {
+  Key key {factory, parameters};
+  {
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      ++hits_;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      DVLOG(VLOG_LEVEL) << "factory cache hit: " << static_cast<int>(factory);
+      return it->second->second;
+    }
+    ++misses_;
+  }
+
+  // made outside of the lock, concurrent misses on the same key keep the first result
+  std::shared_ptr<DFA> result (make(), dfaFree);
+  std::lock_guard<std::mutex> lock (mutex_);
+  if (capacity_ == 0) {
+    return result;
+  }
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    return it->second->second;
+  }
+  entries_.push_front(std::make_pair(key, result));
+  index_[key] = entries_.begin();
+  Evict();
+  return result;
+}
+
+void FactoryCache::set_capacity(const std::size_t capacity) {
+  std::lock_guard<std::mutex> lock (mutex_);
+  capacity_ = capacity;
+  Evict();
+}
+
+FactoryCache::Statistics FactoryCache::GetStatistics() const {
+  std::lock_guard<std::mutex> lock (mutex_);
+  return Statistics {hits_, misses_, evictions_, entries_.size(), capacity_};
+}
+
+/**
+ * Dfas that are still shared with automata are freed with the last of them
+ */
+void FactoryCache::Clear() {
+  std::lock_guard<std::mutex> lock (mutex_);
+  entries_.clear();
+  index_.clear();
+}
+
+std::string FactoryCache::str() const {
+  auto statistics = GetStatistics();
+  std::stringstream ss;
+  ss << "factory cache: " << statistics.hits << " hits, " << statistics.misses << " misses, " << statistics.evictions
+     << " evictions, " << statistics.size << "/" << statistics.capacity << " entries";
+  return ss.str();
+}
+
+/**
+ * Expects the mutex to be held
+ */
+void FactoryCache::Evict() {
+  while (entries_.size() > capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+    ++evictions_;
+  }
+}
+
+bool FactoryCache::Key::operator==(const Key& other) const {
+  return factory == other.factory and parameters == other.parameters;
+}
+
+std::size_t FactoryCache::KeyHash::operator()(const Key& key) const {
+  std::uint64_t hash = 0xcbf29ce484222325ULL ^ static_cast<std::uint64_t>(key.factory);
+  for (int parameter : key.parameters) {
+    hash ^= static_cast<std::uint32_t>(parameter);
+    hash *= 0x100000001b3ULL;
+    hash ^= hash >> 29;
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
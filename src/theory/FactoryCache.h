@@ -0,0 +1,105 @@
+/*
+ * FactoryCache.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_THEORY_FACTORYCACHE_H_
+#define SRC_THEORY_FACTORYCACHE_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+#include <mona/bdd.h>
+#include <mona/dfa.h>
+
+namespace Vlab {
+namespace Theory {
+
+/**
+ * Process wide, size bounded LRU memo of the dfas made by parametric factories, e.g., length and char range automata.
+ * Entries are keyed by the factory and its parameters, which include the track layout. Memoized dfas are minimized,
+ * immutable and shared with the automata made from them; automata copy a shared dfa before changing it.
+ */
+class FactoryCache {
+ public:
+  enum class Factory
+    : int {
+      ACCEPTING_ANY_WITH_IN_RANGE, ACCEPTING_ANY_AFTER_LENGTH, CHAR_RANGE, BINARY_RELATION, BINARY_ALIGNED,
+    ANY_STRING_ALIGNED
+  };
+
+  struct Statistics {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    std::size_t size;
+    std::size_t capacity;
+  };
+
+  static FactoryCache& Instance();
+
+  /**
+   * Gets the dfa of the factory for the given parameters if it is memoized, makes and memoizes it otherwise.
+   * @param make makes the minimized dfa, cache takes its ownership
+   * @return a dfa that must not be changed or freed
+   */
+  std::shared_ptr<DFA> GetOrMake(const Factory factory, const std::vector<int>& parameters,
+                                 std::function<DFA*()> make);
+
+  /**
+   * Sets the maximum number of memoized dfas, 0 disables memoization.
+   */
+  void set_capacity(const std::size_t capacity);
+  Statistics GetStatistics() const;
+  void Clear();
+  std::string str() const;
+
+  static const std::size_t DEFAULT_CAPACITY;
+
+ protected:
+  FactoryCache();
+  ~FactoryCache();
+  FactoryCache(const FactoryCache&) = delete;
+  FactoryCache& operator=(const FactoryCache&) = delete;
+
+  struct Key {
+    Factory factory;
+    std::vector<int> parameters;
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  using Entry = std::pair<Key, std::shared_ptr<DFA>>;
+
+  void Evict();
+
+  mutable std::mutex mutex_;
+  std::size_t capacity_;
+  unsigned long hits_;
+  unsigned long misses_;
+  unsigned long evictions_;
+  /**
+   * Most recently used entries are at the front
+   */
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_FACTORYCACHE_H_ */
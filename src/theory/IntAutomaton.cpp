@@ -233,6 +233,7 @@ IntAutomaton_ptr IntAutomaton::makeInts(std::vector<int> values, int num_of_vari
     auto max = std::max_element(values.begin(), values.end());
 
     int_auto = IntAutomaton::makeInt(*max, num_of_variables);
+    int_auto->MakeDFAUnique();
 
     for (int i : values) {
       if (i < 0) {
@@ -0,0 +1,264 @@
+/*
+ * ModelIterator.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "ModelIterator.h"
+
+#include <algorithm>
+#include <queue>
+#include <stack>
+
+namespace Vlab {
+namespace Theory {
+
+const int ModelIterator::VLOG_LEVEL = 20;
+
+ModelIterator::ModelIterator(std::shared_ptr<DFA> dfa, const int number_of_bdd_variables, const unsigned long bound)
+    : dfa_(dfa),
+      number_of_bdd_variables_(number_of_bdd_variables),
+      bound_(bound),
+      is_started_(false),
+      is_done_(false),
+      length_(0) {
+  CHECK(dfa_ != nullptr) << "model iterator needs a dfa";
+  const int number_of_states = dfa_->ns;
+  std::vector<std::vector<int>> next_states (number_of_states);
+  unsigned p, l, r, index; // BDD traversal variables
+  std::stack<unsigned> nodes;
+  for (int s = 0; s < number_of_states; ++s) {
+    nodes.push(dfa_->q[s]);
+    while (not nodes.empty()) {
+      p = nodes.top();
+      nodes.pop();
+      LOAD_lri(&dfa_->bddm->node_table[p], l, r, index);
+      if (index == BDD_LEAF_INDEX) {
+        next_states[s].push_back(l);
+      } else {
+        nodes.push(l);
+        nodes.push(r);
+      }
+    }
+    std::sort(next_states[s].begin(), next_states[s].end());
+    next_states[s].erase(std::unique(next_states[s].begin(), next_states[s].end()), next_states[s].end());
+  }
+
+  // states that are not reachable would keep layers alive without ever producing a word
+  std::vector<bool> is_reachable (number_of_states, false);
+  std::queue<int> states;
+  is_reachable[dfa_->s] = true;
+  states.push(dfa_->s);
+  while (not states.empty()) {
+    const int state = states.front();
+    states.pop();
+    for (int next_state : next_states[state]) {
+      if (not is_reachable[next_state]) {
+        is_reachable[next_state] = true;
+        states.push(next_state);
+      }
+    }
+  }
+
+  previous_states_.resize(number_of_states);
+  std::vector<bool> accepting_states (number_of_states, false);
+  bool has_accepting_state = false;
+  for (int s = 0; s < number_of_states; ++s) {
+    if (not is_reachable[s]) {
+      continue;
+    }
+    for (int next_state : next_states[s]) {
+      previous_states_[next_state].push_back(s);
+    }
+    if (dfa_->f[s] == 1) {
+      accepting_states[s] = true;
+      has_accepting_state = true;
+    }
+  }
+  layers_.push_back(accepting_states);
+  is_layer_empty_.push_back(not has_accepting_state);
+}
+
+ModelIterator::~ModelIterator() {
+}
+
+bool ModelIterator::Next(std::vector<bool>& word) {
+  if (is_done_) {
+    return false;
+  }
+
+  if (is_started_) {
+    // backtrack to the last symbol that can be replaced with a greater one
+    for (unsigned long i = length_; i > 0; --i) {
+      const unsigned long position = i - 1;
+      std::vector<bool> lower_bound (word_.begin() + position * number_of_bdd_variables_,
+                                     word_.begin() + (position + 1) * number_of_bdd_variables_);
+      word_.resize(position * number_of_bdd_variables_);
+      states_.resize(position + 1);
+
+      bool has_greater_symbol = false;
+      for (int b = number_of_bdd_variables_ - 1; b >= 0; --b) {
+        if (lower_bound[b]) {
+          lower_bound[b] = false;
+        } else {
+          lower_bound[b] = true;
+          has_greater_symbol = true;
+          break;
+        }
+      }
+      if (not has_greater_symbol) {
+        continue;
+      }
+
+      std::vector<bool> symbol;
+      int next_state = -1;
+      if (FindSymbol(states_[position], lower_bound, GetLayer(length_ - position - 1), symbol, next_state)) {
+        word_.insert(word_.end(), symbol.begin(), symbol.end());
+        states_.push_back(next_state);
+        Complete();
+        word = word_;
+        return true;
+      }
+    }
+
+    if (length_ == bound_) {
+      is_done_ = true;
+      return false;
+    }
+    ++length_;
+  } else {
+    is_started_ = true;
+    length_ = 0;
+  }
+
+  // smallest word of the next length that has one
+  while (true) {
+    const std::vector<bool>& layer = GetLayer(length_);
+    if (is_layer_empty_[length_]) {
+      // no state accepts with this many symbols, hence there is no longer word either
+      break;
+    } else if (layer[dfa_->s]) {
+      word_.clear();
+      states_.assign(1, dfa_->s);
+      Complete();
+      word = word_;
+      return true;
+    } else if (length_ == bound_) {
+      break;
+    }
+    ++length_;
+  }
+
+  is_done_ = true;
+  return false;
+}
+
+const std::vector<bool>& ModelIterator::GetCursor() const {
+  return word_;
+}
+
+void ModelIterator::ResumeFrom(const std::vector<bool>& word) {
+  CHECK(number_of_bdd_variables_ > 0 and word.size() % number_of_bdd_variables_ == 0) << "cursor is not a sequence of symbols";
+  length_ = word.size() / number_of_bdd_variables_;
+  CHECK_LE(length_, bound_) << "cursor is longer than the bound";
+
+  word_ = word;
+  states_.assign(1, dfa_->s);
+  unsigned p, l, r, index; // BDD traversal variables
+  for (unsigned long i = 0; i < length_; ++i) {
+    p = dfa_->q[states_.back()];
+    LOAD_lri(&dfa_->bddm->node_table[p], l, r, index);
+    while (index != BDD_LEAF_INDEX) {
+      p = word_[i * number_of_bdd_variables_ + index] ? r : l;
+      LOAD_lri(&dfa_->bddm->node_table[p], l, r, index);
+    }
+    states_.push_back(l);
+  }
+
+  is_started_ = true;
+  is_done_ = false;
+  DVLOG(VLOG_LEVEL) << "model iterator resumed at length " << length_;
+}
+
+const std::vector<bool>& ModelIterator::GetLayer(const unsigned long number_of_symbols) {
+  while (layers_.size() <= number_of_symbols) {
+    std::vector<bool> layer (dfa_->ns, false);
+    bool is_empty = true;
+    const std::vector<bool>& previous_layer = layers_.back();
+    for (int s = 0; s < dfa_->ns; ++s) {
+      if (previous_layer[s]) {
+        for (int previous_state : previous_states_[s]) {
+          layer[previous_state] = true;
+          is_empty = false;
+        }
+      }
+    }
+    layers_.push_back(std::move(layer));
+    is_layer_empty_.push_back(is_empty);
+  }
+  return layers_[number_of_symbols];
+}
+
+void ModelIterator::Complete() {
+  std::vector<bool> lower_bound (number_of_bdd_variables_, false);
+  std::vector<bool> symbol;
+  int next_state = -1;
+  for (unsigned long position = states_.size() - 1; position < length_; ++position) {
+    const bool is_found = FindSymbol(states_[position], lower_bound, GetLayer(length_ - position - 1), symbol, next_state);
+    CHECK(is_found) << "state " << states_[position] << " cannot complete a word of length " << length_;
+    word_.insert(word_.end(), symbol.begin(), symbol.end());
+    states_.push_back(next_state);
+  }
+}
+
+bool ModelIterator::FindSymbol(const int state, const std::vector<bool>& lower_bound, const std::vector<bool>& target_layer,
+                               std::vector<bool>& symbol, int& next_state) {
+  symbol.assign(number_of_bdd_variables_, false);
+  failed_nodes_.clear();
+  return FindSymbol(dfa_->q[state], 0, true, lower_bound, target_layer, symbol, next_state);
+}
+
+/**
+ * Depth first over the bdd with 0 branches first. While the prefix equals the lower bound the search is tight and
+ * may not go below it, afterwards any value is allowed and failures are remembered per node and position.
+ */
+bool ModelIterator::FindSymbol(const unsigned node, const int position, const bool is_tight,
+                               const std::vector<bool>& lower_bound, const std::vector<bool>& target_layer,
+                               std::vector<bool>& symbol, int& next_state) {
+  unsigned l, r, index; // BDD traversal variables
+  LOAD_lri(&dfa_->bddm->node_table[node], l, r, index);
+  if (index == BDD_LEAF_INDEX) {
+    if (not target_layer[l]) {
+      return false;
+    }
+    // remaining bits are don't cares, take the smallest allowed value
+    for (int i = position; i < number_of_bdd_variables_; ++i) {
+      symbol[i] = is_tight ? lower_bound[i] : false;
+    }
+    next_state = l;
+    return true;
+  }
+
+  CHECK_LT(position, number_of_bdd_variables_) << "bdd variable index is out of range";
+  const unsigned long key = (unsigned long)node * (number_of_bdd_variables_ + 1) + position;
+  if (not is_tight and failed_nodes_.find(key) != failed_nodes_.end()) {
+    return false;
+  }
+
+  for (int bit = (is_tight and lower_bound[position]) ? 1 : 0; bit <= 1; ++bit) {
+    symbol[position] = bit;
+    const unsigned child = ((int)index == position) ? (bit ? r : l) : node;
+    if (FindSymbol(child, position + 1, is_tight and (bit == lower_bound[position]), lower_bound, target_layer, symbol,
+                   next_state)) {
+      return true;
+    }
+  }
+
+  if (not is_tight) {
+    failed_nodes_.insert(key);
+  }
+  return false;
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,121 @@
+/*
+ * ModelIterator.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_THEORY_MODELITERATOR_H_
+#define SRC_THEORY_MODELITERATOR_H_
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <glog/logging.h>
+#include <mona/bdd.h>
+#include <mona/dfa.h>
+
+namespace Vlab {
+namespace Theory {
+
+class ModelIterator;
+using ModelIterator_ptr = ModelIterator*;
+
+/**
+ * Pull based enumeration of the words accepted by a dfa in length-lexicographic order, i.e., shorter words first and
+ * words of the same length in lexicographic order of their bits (bdd variable 0 is the most significant bit of a symbol).
+ * Only the current word is kept, the next one is found by backtracking over it. A state is extended only if it can
+ * reach an accepting state with exactly the remaining number of symbols, these state layers are computed once per length
+ * with a backward sweep from the accepting states, hence no dead end is explored.
+ */
+class ModelIterator {
+ public:
+  /**
+   * @param dfa shared with the automaton, kept alive by the iterator
+   * @param number_of_bdd_variables bits per symbol
+   * @param bound maximum number of symbols in a word
+   */
+  ModelIterator(std::shared_ptr<DFA> dfa, const int number_of_bdd_variables, const unsigned long bound);
+  virtual ~ModelIterator();
+
+  /**
+   * Gets the next accepted word
+   * @param word bits of the word, symbol by symbol
+   * @return false if there is no more word within the bound
+   */
+  bool Next(std::vector<bool>& word);
+
+  /**
+   * Gets the last word returned, iteration can continue from it later with ResumeFrom
+   */
+  const std::vector<bool>& GetCursor() const;
+
+  /**
+   * Positions the iterator at the given word, Next returns the words after it
+   * @param word a cursor; does not have to be accepted
+   */
+  void ResumeFrom(const std::vector<bool>& word);
+
+ protected:
+  /**
+   * Gets states that have an accepting path with exactly the given number of symbols
+   */
+  const std::vector<bool>& GetLayer(const unsigned long number_of_symbols);
+
+  /**
+   * Extends the current word with the smallest symbols until the word has length_ symbols
+   */
+  void Complete();
+
+  /**
+   * Finds the smallest symbol that is greater than or equal to the lower bound and leads to a state in the target layer
+   * @param state
+   * @param lower_bound
+   * @param target_layer
+   * @param symbol set to the symbol found
+   * @param next_state set to the state reached with the symbol
+   * @return false if there is no such symbol
+   */
+  bool FindSymbol(const int state, const std::vector<bool>& lower_bound, const std::vector<bool>& target_layer,
+                  std::vector<bool>& symbol, int& next_state);
+  bool FindSymbol(const unsigned node, const int position, const bool is_tight, const std::vector<bool>& lower_bound,
+                  const std::vector<bool>& target_layer, std::vector<bool>& symbol, int& next_state);
+
+  std::shared_ptr<DFA> dfa_;
+  const int number_of_bdd_variables_;
+  const unsigned long bound_;
+
+  bool is_started_;
+  bool is_done_;
+
+  /**
+   * Number of symbols in the current word
+   */
+  unsigned long length_;
+
+  /**
+   * Current word and the states visited while reading it, states_[i] is the state before the i-th symbol
+   */
+  std::vector<bool> word_;
+  std::vector<int> states_;
+
+  /**
+   * Reverse transitions restricted to the states reachable from the initial state
+   */
+  std::vector<std::vector<int>> previous_states_;
+  std::vector<std::vector<bool>> layers_;
+  std::vector<bool> is_layer_empty_;
+
+  /**
+   * Bdd nodes visited without being restricted by the lower bound that lead to no target state, per symbol search
+   */
+  std::unordered_set<unsigned long> failed_nodes_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_MODELITERATOR_H_ */
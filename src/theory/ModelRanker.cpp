@@ -0,0 +1,204 @@
+/*
+ * ModelRanker.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "ModelRanker.h"
+
+namespace Vlab {
+namespace Theory {
+
+const int ModelRanker::VLOG_LEVEL = 20;
+
+ModelRanker::ModelRanker(std::shared_ptr<DFA> dfa, const int number_of_bdd_variables, const SymbolicCounter& counter,
+                         const unsigned long bound)
+    : dfa_(dfa),
+      number_of_bdd_variables_(number_of_bdd_variables),
+      bound_(bound) {
+  CHECK(dfa_ != nullptr) << "model ranker needs a dfa";
+  count_vectors_ = counter.GetCountVectors(bound);
+  number_of_models_ = count_vectors_.back().coeff(dfa_->s);
+  DVLOG(VLOG_LEVEL) << "model ranker for bound " << bound << " over " << number_of_models_ << " models";
+}
+
+ModelRanker::~ModelRanker() {
+}
+
+unsigned long ModelRanker::GetBound() const {
+  return bound_;
+}
+
+unsigned long ModelRanker::GetMaxLength() const {
+  return count_vectors_.size() - 1;
+}
+
+const BigInteger& ModelRanker::GetNumberOfModels() const {
+  return number_of_models_;
+}
+
+/**
+ * Adds the number of models that leave the path of the word earlier at each step, ending the word before the current
+ * symbol or taking a smaller symbol
+ */
+bool ModelRanker::Rank(const std::vector<bool>& word, BigInteger& rank) const {
+  if (word.size() % number_of_bdd_variables_ != 0) {
+    DVLOG(VLOG_LEVEL) << "word is not a sequence of symbols";
+    return false;
+  }
+  const std::size_t number_of_symbols = word.size() / number_of_bdd_variables_;
+  if (number_of_symbols >= count_vectors_.size()) {
+    DVLOG(VLOG_LEVEL) << "word is longer than the bound";
+    return false;
+  }
+  std::unordered_map<unsigned long, BigInteger> weights;
+  rank = 0;
+  int state = dfa_->s;
+  unsigned long steps = count_vectors_.size();
+  unsigned l, r, index; // BDD traversal variables
+  for (std::size_t i = 0; i < number_of_symbols; ++i) {
+    rank += GetStopCount(state, steps);
+    weights.clear();
+    unsigned node = dfa_->q[state];
+    for (int position = 0; position < number_of_bdd_variables_; ++position) {
+      const bool bit = word[i * number_of_bdd_variables_ + position];
+      if (bit) {
+        rank += GetSymbolWeight(GetChild(node, position, false), position + 1, steps - 1, weights);
+      }
+      node = GetChild(node, position, bit);
+    }
+    LOAD_lri(&dfa_->bddm->node_table[node], l, r, index);
+    state = l;
+    --steps;
+  }
+  if (GetStopCount(state, steps) == 0) {
+    DVLOG(VLOG_LEVEL) << "word is not a model within the bound";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Chooses between ending the word and each symbol in order, skipping the number of models each choice covers
+ */
+bool ModelRanker::Unrank(BigInteger index, std::vector<bool>& word) const {
+  if (index < 0 or index >= number_of_models_) {
+    DVLOG(VLOG_LEVEL) << "rank is out of range: " << index;
+    return false;
+  }
+  std::unordered_map<unsigned long, BigInteger> weights;
+  word.clear();
+  int state = dfa_->s;
+  unsigned long steps = count_vectors_.size();
+  unsigned l, r, bdd_index; // BDD traversal variables
+  while (true) {
+    const BigInteger stop_count = GetStopCount(state, steps);
+    if (index < stop_count) {
+      break;
+    }
+    index -= stop_count;
+
+    weights.clear();
+    unsigned node = dfa_->q[state];
+    for (int position = 0; position < number_of_bdd_variables_; ++position) {
+      const unsigned zero_child = GetChild(node, position, false);
+      const BigInteger zero_weight = GetSymbolWeight(zero_child, position + 1, steps - 1, weights);
+      if (index < zero_weight) {
+        word.push_back(false);
+        node = zero_child;
+      } else {
+        index -= zero_weight;
+        word.push_back(true);
+        node = GetChild(node, position, true);
+      }
+    }
+    LOAD_lri(&dfa_->bddm->node_table[node], l, r, bdd_index);
+    state = l;
+    --steps;
+  }
+  return true;
+}
+
+/**
+ * Draws an index with rejection sampling on random bits, less than two draws are needed on average
+ */
+bool ModelRanker::Sample(std::mt19937_64& generator, std::vector<bool>& word) const {
+  if (number_of_models_ == 0) {
+    DVLOG(VLOG_LEVEL) << "there is no model to sample";
+    return false;
+  }
+  const unsigned number_of_bits = boost::multiprecision::msb(number_of_models_) + 1;
+  const BigInteger mask = (BigInteger(1) << number_of_bits) - 1;
+  BigInteger index;
+  do {
+    index = 0;
+    for (unsigned b = 0; b < number_of_bits; b += 64) {
+      index <<= 64;
+      index |= generator();
+    }
+    index &= mask;
+  } while (index >= number_of_models_);
+  return Unrank(index, word);
+}
+
+/**
+ * Count vector k gives the paths with k + 1 steps; the artificial accepting state is the only target of a path
+ */
+BigInteger ModelRanker::GetPathCount(const int state, const unsigned long steps) const {
+  if (steps == 0) {
+    return (state == dfa_->ns) ? 1 : 0;
+  }
+  return count_vectors_[steps - 1].coeff(state);
+}
+
+BigInteger ModelRanker::GetStopCount(const int state, const unsigned long steps) const {
+  if (steps == 0) {
+    return 0;
+  }
+  const BigInteger stop_weight = count_vectors_[0].coeff(state);
+  if (stop_weight == 0) {
+    return 0;
+  }
+  return stop_weight * GetPathCount(dfa_->ns, steps - 1);
+}
+
+BigInteger ModelRanker::GetSymbolWeight(const unsigned node, const int position, const unsigned long steps,
+                                        std::unordered_map<unsigned long, BigInteger>& weights) const {
+  unsigned l, r, index; // BDD traversal variables
+  LOAD_lri(&dfa_->bddm->node_table[node], l, r, index);
+  if (index == BDD_LEAF_INDEX) {
+    // remaining bits are don't cares
+    BigInteger weight = GetPathCount(l, steps);
+    if (weight != 0) {
+      weight <<= (number_of_bdd_variables_ - position);
+    }
+    return weight;
+  }
+
+  const unsigned long key = (unsigned long)node * (number_of_bdd_variables_ + 1) + position;
+  auto it = weights.find(key);
+  if (it != weights.end()) {
+    return it->second;
+  }
+
+  BigInteger weight;
+  if ((int)index == position) {
+    weight = GetSymbolWeight(l, position + 1, steps, weights) + GetSymbolWeight(r, position + 1, steps, weights);
+  } else {
+    weight = GetSymbolWeight(node, position + 1, steps, weights) << 1;
+  }
+  weights[key] = weight;
+  return weight;
+}
+
+unsigned ModelRanker::GetChild(const unsigned node, const int position, const bool bit) const {
+  unsigned l, r, index; // BDD traversal variables
+  LOAD_lri(&dfa_->bddm->node_table[node], l, r, index);
+  if (index == BDD_LEAF_INDEX or (int)index != position) {
+    return node;
+  }
+  return bit ? r : l;
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
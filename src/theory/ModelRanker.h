@@ -0,0 +1,128 @@
+/*
+ * ModelRanker.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_THEORY_MODELRANKER_H_
+#define SRC_THEORY_MODELRANKER_H_
+
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <glog/logging.h>
+#include <mona/bdd.h>
+#include <mona/dfa.h>
+
+#include "../boost/multiprecision/cpp_int.hpp"
+#include "../Eigen/SparseCore"
+#include "SymbolicCounter.h"
+
+namespace Vlab {
+namespace Theory {
+
+class ModelRanker;
+using ModelRanker_ptr = ModelRanker*;
+
+/**
+ * Bijection between the models counted by a symbolic counter for a bound and the integers from 0 to the count.
+ * A model is a path from the initial state to the artificial accepting state of the count matrix; the count vectors
+ * of the counter give the number of such paths from every state with a given number of steps, hence the i-th model
+ * is found by skipping whole groups of paths symbol by symbol. Models are ordered lexicographically, a word comes before
+ * its extensions. Sampling an index uniformly gives a uniform sample of the models.
+ */
+class ModelRanker {
+ public:
+  /**
+   * @param dfa shared with the automaton, kept alive by the ranker
+   * @param number_of_bdd_variables bits per symbol
+   * @param counter symbolic counter of the same dfa
+   * @param bound bound as given to the counter
+   */
+  ModelRanker(std::shared_ptr<DFA> dfa, const int number_of_bdd_variables, const SymbolicCounter& counter,
+              const unsigned long bound);
+  virtual ~ModelRanker();
+
+  unsigned long GetBound() const;
+
+  /**
+   * Gets the maximum number of symbols in a model, models of integer automata have exactly this many symbols
+   */
+  unsigned long GetMaxLength() const;
+
+  /**
+   * Gets the number of models, same as the count of the counter for the bound
+   */
+  const BigInteger& GetNumberOfModels() const;
+
+  /**
+   * Gets the rank of a model
+   * @param word bits of the model, symbol by symbol
+   * @param rank number of models that come before it
+   * @return false if the word is not a model within the bound
+   */
+  bool Rank(const std::vector<bool>& word, BigInteger& rank) const;
+
+  /**
+   * Gets the model with the given rank
+   * @param index
+   * @param word bits of the model, symbol by symbol
+   * @return false if the index is not less than the number of models
+   */
+  bool Unrank(BigInteger index, std::vector<bool>& word) const;
+
+  /**
+   * Draws a model uniformly at random
+   * @param generator
+   * @param word bits of the model, symbol by symbol
+   * @return false if there is no model
+   */
+  bool Sample(std::mt19937_64& generator, std::vector<bool>& word) const;
+
+ protected:
+  /**
+   * Number of paths with exactly the given number of steps from the state to the artificial accepting state
+   */
+  BigInteger GetPathCount(const int state, const unsigned long steps) const;
+
+  /**
+   * Number of paths that leave the state with the artificial transition to the accepting state, i.e., that end the word
+   */
+  BigInteger GetStopCount(const int state, const unsigned long steps) const;
+
+  /**
+   * Sums the path counts of the target states over all symbols that pass through the bdd node at the given position
+   * @param node
+   * @param position bits of the symbol that are already decided
+   * @param steps remaining steps after the symbol
+   * @param weights memo for the current symbol
+   */
+  BigInteger GetSymbolWeight(const unsigned node, const int position, const unsigned long steps,
+                             std::unordered_map<unsigned long, BigInteger>& weights) const;
+
+  /**
+   * Follows a bit of the symbol, node stays the same if the bdd does not test the bit
+   */
+  unsigned GetChild(const unsigned node, const int position, const bool bit) const;
+
+  std::shared_ptr<DFA> dfa_;
+  const int number_of_bdd_variables_;
+  const unsigned long bound_;
+
+  /**
+   * Count vectors of the counter for all powers up to the one of the bound, vector 0 is the last column of the count
+   * matrix, hence it also gives the transitions to the artificial accepting state
+   */
+  std::vector<Eigen::SparseVector<BigInteger>> count_vectors_;
+  BigInteger number_of_models_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_MODELRANKER_H_ */
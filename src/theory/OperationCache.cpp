@@ -0,0 +1,215 @@
+/*
+ * OperationCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "OperationCache.h"
+
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <stack>
+#include <unordered_set>
+
+namespace Vlab {
+namespace Theory {
+
+const int OperationCache::VLOG_LEVEL = 20;
+
+const std::size_t OperationCache::DEFAULT_CAPACITY = 1 << 22;
+
+namespace {
+
+inline std::uint64_t mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+inline std::uint64_t combine(const std::uint64_t seed, const std::uint64_t value) {
+  return mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+} /* namespace */
+
+OperationCache::OperationCache() : capacity_(DEFAULT_CAPACITY), size_(0), hits_(0), misses_(0), evictions_(0) {
+}
+
+OperationCache::~OperationCache() {
+  Clear();
+}
+
+OperationCache& OperationCache::Instance() {
+  static OperationCache operation_cache;
+  return operation_cache;
+}
+
+bool OperationCache::IsStructurallyEqual(const DFA* dfa1, const DFA* dfa2) {
+  if (dfa1->ns != dfa2->ns or dfa1->s != dfa2->s) {
+    return false;
+  }
+  for (int s = 0; s < dfa1->ns; ++s) {
+    if (dfa1->f[s] != dfa2->f[s]) {
+      return false;
+    }
+  }
+
+  // pairs of bdd nodes that are compared or scheduled to be compared
+  std::unordered_set<std::uint64_t> node_pairs;
+  std::stack<std::pair<unsigned, unsigned>> bdd_node_stack;
+  for (int s = 0; s < dfa1->ns; ++s) {
+    bdd_node_stack.push(std::make_pair(dfa1->q[s], dfa2->q[s]));
+  }
+  while (not bdd_node_stack.empty()) {
+    auto current = bdd_node_stack.top(); bdd_node_stack.pop();
+    if (not node_pairs.insert((static_cast<std::uint64_t>(current.first) << 32) | current.second).second) {
+      continue;
+    }
+    unsigned left1, right1, index1, left2, right2, index2;
+    LOAD_lri(&dfa1->bddm->node_table[current.first], left1, right1, index1);
+    LOAD_lri(&dfa2->bddm->node_table[current.second], left2, right2, index2);
+    if (index1 != index2) {
+      return false;
+    } else if (index1 == BDD_LEAF_INDEX) {
+      if (left1 != left2) {
+        return false;
+      }
+    } else {
+      bdd_node_stack.push(std::make_pair(left1, left2));
+      bdd_node_stack.push(std::make_pair(right1, right2));
+    }
+  }
+  return true;
+}
+
+std::size_t OperationCache::GetSize(const DFA* dfa) {
+  return dfa->ns + bdd_size(dfa->bddm);
+}
+
+std::shared_ptr<DFA> OperationCache::GetOrCompute(const Operation operation,
+                                                  const std::vector<std::shared_ptr<DFA>>& operands,
+                                                  const std::vector<int>& parameters, std::function<DFA*()> compute) {
+  Key key {operation, {}, parameters};
+  for (auto& dfa : operands) {
+    key.operands.push_back(std::make_pair(dfa->ns, dfa->s));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto it = Find(key, operands);
+    if (it != entries_.end()) {
+      ++hits_;
+      entries_.splice(entries_.begin(), entries_, it);
+      DVLOG(VLOG_LEVEL) << "operation cache hit: " << static_cast<int>(operation);
+      return it->result;
+    }
+    ++misses_;
+  }
+
+  // computed outside of the lock, concurrent misses on the same operands keep the first result
+  std::shared_ptr<DFA> result (compute(), dfaFree);
+  std::size_t size = GetSize(result.get());
+  for (auto& dfa : operands) {
+    size += GetSize(dfa.get());
+  }
+
+  std::lock_guard<std::mutex> lock (mutex_);
+  if (size <= capacity_ and Find(key, operands) == entries_.end()) {
+    entries_.push_front(Entry {key, operands, result, size});
+    index_.insert(std::make_pair(key, entries_.begin()));
+    size_ += size;
+    Evict();
+  }
+  return result;
+}
+
+void OperationCache::set_capacity(const std::size_t capacity) {
+  std::lock_guard<std::mutex> lock (mutex_);
+  capacity_ = capacity;
+  Evict();
+}
+
+OperationCache::Statistics OperationCache::GetStatistics() const {
+  std::lock_guard<std::mutex> lock (mutex_);
+  return Statistics {hits_, misses_, evictions_, size_, capacity_};
+}
+
+void OperationCache::Clear() {
+  std::lock_guard<std::mutex> lock (mutex_);
+  entries_.clear();
+  index_.clear();
+  size_ = 0;
+}
+
+std::string OperationCache::str() const {
+  auto statistics = GetStatistics();
+  std::stringstream ss;
+  ss << "operation cache: " << statistics.hits << " hits, " << statistics.misses << " misses, " << statistics.evictions
+     << " evictions, " << statistics.size << "/" << statistics.capacity << " states and bdd nodes";
+  return ss.str();
+}
+
+std::list<OperationCache::Entry>::iterator OperationCache::Find(const Key& key,
+                                                                const std::vector<std::shared_ptr<DFA>>& operands) {
+  auto range = index_.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (IsSameOperands(operands, *it->second)) {
+      return it->second;
+    }
+  }
+  return entries_.end();
+}
+
+/**
+ * Expects the mutex to be held
+ */
+void OperationCache::Evict() {
+  while (size_ > capacity_) {
+    auto last = std::prev(entries_.end());
+    auto range = index_.equal_range(last->key);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == last) {
+        index_.erase(it);
+        break;
+      }
+    }
+    size_ -= last->size;
+    entries_.pop_back();
+    ++evictions_;
+  }
+}
+
+bool OperationCache::IsSameOperands(const std::vector<std::shared_ptr<DFA>>& operands, const Entry& entry) {
+  if (operands.size() != entry.operands.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < operands.size(); ++i) {
+    if (operands[i] != entry.operands[i] and not IsStructurallyEqual(operands[i].get(), entry.operands[i].get())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool OperationCache::Key::operator==(const Key& other) const {
+  return operation == other.operation and operands == other.operands and parameters == other.parameters;
+}
+
+std::size_t OperationCache::KeyHash::operator()(const Key& key) const {
+  std::uint64_t hash = static_cast<std::uint64_t>(key.operation);
+  for (auto& operand : key.operands) {
+    hash = combine(hash, static_cast<std::uint64_t>(operand.first));
+    hash = combine(hash, static_cast<std::uint64_t>(operand.second));
+  }
+  for (int parameter : key.parameters) {
+    hash = combine(hash, static_cast<std::uint64_t>(parameter));
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,139 @@
+/*
+ * OperationCache.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_THEORY_OPERATIONCACHE_H_
+#define SRC_THEORY_OPERATIONCACHE_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+#include <mona/bdd.h>
+#include <mona/dfa.h>
+
+namespace Vlab {
+namespace Theory {
+
+/**
+ * Process wide LRU cache of dfa operation results, bounded by the total size of the cached dfas. Entries are keyed by
+ * the operation, a signature of each operand dfa and extra integer parameters; the signature is the number of states
+ * and the initial state, so a lookup costs nothing for operands that cannot hit. A hit requires the operands to be the
+ * same dfas as the cached ones or structurally equal to them. Operands and results are immutable dfas shared with the
+ * automata that hold them, the cache keeps them alive instead of copying them.
+ */
+class OperationCache {
+ public:
+  enum class Operation
+    : int {
+      UNION, INTERSECT, CONCAT, PROJECT_AWAY_AND_REMAP
+  };
+
+  struct Statistics {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    std::size_t size;
+    std::size_t capacity;
+  };
+
+  static OperationCache& Instance();
+
+  /**
+   * Compares number of states, initial state, state kinds and the bdd of each state node by node, i.e., tells if the
+   * dfas are the same up to bdd node ids.
+   */
+  static bool IsStructurallyEqual(const DFA* dfa1, const DFA* dfa2);
+
+  /**
+   * Size of a dfa as counted against the capacity, its number of states and bdd nodes
+   */
+  static std::size_t GetSize(const DFA* dfa);
+
+  /**
+   * Gets the result of the given operation if it is cached, computes and caches it otherwise.
+   * @param operands shared dfas that are not changed anymore
+   * @param compute computes the result, cache takes its ownership
+   * @return a dfa that must not be changed, automata share it
+   */
+  std::shared_ptr<DFA> GetOrCompute(const Operation operation, const std::vector<std::shared_ptr<DFA>>& operands,
+                                    const std::vector<int>& parameters, std::function<DFA*()> compute);
+
+  /**
+   * Sets the maximum total size of the cached operands and results, 0 disables caching.
+   */
+  void set_capacity(const std::size_t capacity);
+  Statistics GetStatistics() const;
+  void Clear();
+  std::string str() const;
+
+  static const std::size_t DEFAULT_CAPACITY;
+
+ protected:
+  OperationCache();
+  ~OperationCache();
+  OperationCache(const OperationCache&) = delete;
+  OperationCache& operator=(const OperationCache&) = delete;
+
+  /**
+   * Number of states and initial state of a dfa
+   */
+  using Signature = std::pair<int, int>;
+
+  struct Key {
+    Operation operation;
+    std::vector<Signature> operands;
+    std::vector<int> parameters;
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    Key key;
+    std::vector<std::shared_ptr<DFA>> operands;
+    std::shared_ptr<DFA> result;
+    std::size_t size;
+  };
+
+  static bool IsSameOperands(const std::vector<std::shared_ptr<DFA>>& operands, const Entry& entry);
+
+  /**
+   * Expects the mutex to be held
+   */
+  std::list<Entry>::iterator Find(const Key& key, const std::vector<std::shared_ptr<DFA>>& operands);
+  void Evict();
+
+  mutable std::mutex mutex_;
+  std::size_t capacity_;
+  /**
+   * Total size of the entries
+   */
+  std::size_t size_;
+  unsigned long hits_;
+  unsigned long misses_;
+  unsigned long evictions_;
+  /**
+   * Most recently used entries are at the front
+   */
+  std::list<Entry> entries_;
+  std::unordered_multimap<Key, std::list<Entry>::iterator, KeyHash> index_;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_OPERATIONCACHE_H_ */
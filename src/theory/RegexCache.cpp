@@ -0,0 +1,291 @@
+/*
+ * RegexCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "RegexCache.h"
+
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+
+#include "../cereal/archives/binary.hpp"
+#include "../cereal/types/string.hpp"
+#include "../cereal/types/vector.hpp"
+
+namespace Vlab {
+namespace Theory {
+
+const int RegexCache::VLOG_LEVEL = 20;
+
+const std::string RegexCache::FILE_MAGIC = "abc-regex-cache";
+
+const int RegexCache::FILE_VERSION = 1;
+
+const std::size_t RegexCache::DEFAULT_CAPACITY = 1024;
+
+const int RegexCache::MAX_NUMBER_OF_BDD_VARIABLES = 64;
+
+const int RegexCache::MAX_NUMBER_OF_STATES = 1 << 24;
+
+RegexCache::RegexCache()
+    : capacity_(DEFAULT_CAPACITY), hits_(0), misses_(0), evictions_(0), has_unsaved_entries_(false) {
+}
+
+RegexCache::~RegexCache() {
+  Clear();
+}
+
+RegexCache& RegexCache::Instance() {
+  static RegexCache regex_cache;
+  return regex_cache;
+}
+
+StringAutomaton_ptr RegexCache::GetOrCompute(const std::string& regex, const int syntax_flags,
+                                             const int number_of_bdd_variables,
+                                             std::function<StringAutomaton_ptr()> compute) {
+  Key key {regex, syntax_flags, number_of_bdd_variables};
+  {
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      ++hits_;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      DVLOG(VLOG_LEVEL) << "regex cache hit: " << regex;
+      return it->second->second->clone();
+    }
+    ++misses_;
+  }
+
+  // computed outside of the lock, concurrent misses on the same key keep the first result
+  StringAutomaton_ptr result = compute();
+  std::lock_guard<std::mutex> lock (mutex_);
+  if (capacity_ > 0 and index_.find(key) == index_.end()) {
+    Insert(key, result->clone());
+    has_unsaved_entries_ = true;
+  }
+  return result;
+}
+
+void RegexCache::set_capacity(const std::size_t capacity) {
+  std::lock_guard<std::mutex> lock (mutex_);
+  capacity_ = capacity;
+  Evict();
+}
+
+bool RegexCache::Save(const std::string& file_name) {
+  std::lock_guard<std::mutex> lock (mutex_);
+  std::ofstream out (file_name, std::ios::binary | std::ios::trunc);
+  if (not out.good()) {
+    LOG(ERROR) << "cannot write regex cache: " << file_name;
+    return false;
+  }
+
+  {
+    cereal::BinaryOutputArchive ar(out);
+    ar(FILE_MAGIC, FILE_VERSION, entries_.size());
+    for (auto& entry : entries_) {
+      const int number_of_bdd_variables = std::get<2>(entry.first);
+      SerializedDFA serialized_dfa = SerializeDFA(entry.second->getDFA(), number_of_bdd_variables);
+      ar(std::get<0>(entry.first), std::get<1>(entry.first), number_of_bdd_variables);
+      ar(serialized_dfa.number_of_states, serialized_dfa.initial_state, serialized_dfa.statuses,
+         serialized_dfa.number_of_paths, serialized_dfa.targets, serialized_dfa.cubes);
+    }
+  }
+  has_unsaved_entries_ = false;
+  DVLOG(VLOG_LEVEL) << "saved " << entries_.size() << " regex automata to " << file_name;
+  return true;
+}
+
+/**
+ * A file that cannot be read is reported and ignored, regexes in it are compiled again on use
+ */
+bool RegexCache::Load(const std::string& file_name) {
+  std::ifstream in (file_name, std::ios::binary);
+  if (not in.good()) {
+    DVLOG(VLOG_LEVEL) << "regex cache file does not exist: " << file_name;
+    return false;
+  }
+
+  std::vector<std::pair<Key, SerializedDFA>> loaded_entries;
+  try {
+    cereal::BinaryInputArchive ar(in);
+    std::string magic;
+    int version = 0;
+    std::size_t number_of_entries = 0;
+    ar(magic, version, number_of_entries);
+    if (magic != FILE_MAGIC or version != FILE_VERSION) {
+      LOG(ERROR) << "not a regex cache file or unsupported version: " << file_name;
+      return false;
+    }
+    for (std::size_t i = 0; i < number_of_entries; ++i) {
+      Key key;
+      SerializedDFA serialized_dfa;
+      ar(std::get<0>(key), std::get<1>(key), std::get<2>(key));
+      ar(serialized_dfa.number_of_states, serialized_dfa.initial_state, serialized_dfa.statuses,
+         serialized_dfa.number_of_paths, serialized_dfa.targets, serialized_dfa.cubes);
+      loaded_entries.push_back(std::make_pair(std::move(key), std::move(serialized_dfa)));
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "cannot read regex cache: " << file_name << ": " << e.what();
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock (mutex_);
+  for (auto& entry : loaded_entries) {
+    if (index_.size() >= capacity_) {
+      break;
+    } else if (index_.find(entry.first) != index_.end()) {
+      continue;
+    }
+    const int number_of_bdd_variables = std::get<2>(entry.first);
+    DFA* dfa = DeserializeDFA(entry.second, number_of_bdd_variables);
+    if (dfa == nullptr) {
+      LOG(ERROR) << "corrupted regex cache entry: " << std::get<0>(entry.first);
+      continue;
+    }
+    // entries are saved most recently used first, loaded ones are less recent than the cached ones
+    entries_.push_back(std::make_pair(entry.first, new StringAutomaton(dfa, number_of_bdd_variables)));
+    index_[entry.first] = std::prev(entries_.end());
+  }
+  DVLOG(VLOG_LEVEL) << "loaded " << loaded_entries.size() << " regex automata from " << file_name;
+  return true;
+}
+
+bool RegexCache::HasUnsavedEntries() const {
+  std::lock_guard<std::mutex> lock (mutex_);
+  return has_unsaved_entries_;
+}
+
+RegexCache::Statistics RegexCache::GetStatistics() const {
+  std::lock_guard<std::mutex> lock (mutex_);
+  return Statistics {hits_, misses_, evictions_, entries_.size(), capacity_};
+}
+
+void RegexCache::Clear() {
+  std::lock_guard<std::mutex> lock (mutex_);
+  for (auto& entry : entries_) {
+    delete entry.second;
+  }
+  entries_.clear();
+  index_.clear();
+  has_unsaved_entries_ = false;
+}
+
+std::string RegexCache::str() const {
+  auto statistics = GetStatistics();
+  std::stringstream ss;
+  ss << "regex cache: " << statistics.hits << " hits, " << statistics.misses << " misses, " << statistics.evictions
+     << " evictions, " << statistics.size << "/" << statistics.capacity << " entries";
+  return ss.str();
+}
+
+/**
+ * Expects the mutex to be held
+ */
+void RegexCache::Insert(const Key& key, StringAutomaton_ptr regex_auto) {
+  entries_.push_front(std::make_pair(key, regex_auto));
+  index_[key] = entries_.begin();
+  Evict();
+}
+
+/**
+ * Expects the mutex to be held
+ */
+void RegexCache::Evict() {
+  while (entries_.size() > capacity_) {
+    index_.erase(entries_.back().first);
+    delete entries_.back().second;
+    entries_.pop_back();
+    ++evictions_;
+  }
+}
+
+/**
+ * Bdd indices of the automata are the bit positions, a path sets the bits it tests
+ */
+RegexCache::SerializedDFA RegexCache::SerializeDFA(const DFA* dfa, const int number_of_bdd_variables) {
+  SerializedDFA serialized_dfa;
+  serialized_dfa.number_of_states = dfa->ns;
+  serialized_dfa.initial_state = dfa->s;
+  serialized_dfa.statuses.assign(dfa->f, dfa->f + dfa->ns);
+  paths state_paths, pp;
+  trace_descr tp;
+  for (int s = 0; s < dfa->ns; ++s) {
+    int number_of_paths = 0;
+    state_paths = pp = make_paths(dfa->bddm, dfa->q[s]);
+    while (pp) {
+      std::string cube(number_of_bdd_variables, 'X');
+      for (tp = pp->trace; tp; tp = tp->next) {
+        cube[tp->index] = tp->value ? '1' : '0';
+      }
+      serialized_dfa.targets.push_back(pp->to);
+      serialized_dfa.cubes += cube;
+      ++number_of_paths;
+      pp = pp->next;
+    }
+    kill_paths(state_paths);
+    serialized_dfa.number_of_paths.push_back(number_of_paths);
+  }
+  return serialized_dfa;
+}
+
+/**
+ * Paths of a state are disjoint and cover all symbols, the last one is stored as the default transition. Everything
+ * is checked before the dfa is set up, mona does not check its input.
+ */
+DFA* RegexCache::DeserializeDFA(const SerializedDFA& serialized_dfa, const int number_of_bdd_variables) {
+  const int number_of_states = serialized_dfa.number_of_states;
+  if (number_of_states <= 0 or number_of_states > MAX_NUMBER_OF_STATES or number_of_bdd_variables <= 0
+      or number_of_bdd_variables > MAX_NUMBER_OF_BDD_VARIABLES or serialized_dfa.initial_state < 0
+      or serialized_dfa.initial_state >= number_of_states
+      or serialized_dfa.statuses.size() != (std::size_t)number_of_states
+      or serialized_dfa.number_of_paths.size() != (std::size_t)number_of_states
+      or serialized_dfa.cubes.size() != serialized_dfa.targets.size() * number_of_bdd_variables
+      or std::accumulate(serialized_dfa.number_of_paths.begin(), serialized_dfa.number_of_paths.end(), 0ul)
+          != serialized_dfa.targets.size()) {
+    return nullptr;
+  }
+  for (int target : serialized_dfa.targets) {
+    if (target < 0 or target >= number_of_states) {
+      return nullptr;
+    }
+  }
+  for (int number_of_paths : serialized_dfa.number_of_paths) {
+    if (number_of_paths <= 0) {
+      return nullptr;
+    }
+  }
+  for (char bit : serialized_dfa.cubes) {
+    if (bit != '0' and bit != '1' and bit != 'X') {
+      return nullptr;
+    }
+  }
+
+  std::vector<int> indices(number_of_bdd_variables);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::vector<char> statuses(number_of_states + 1, '\0');
+  std::string cube;
+  dfaSetup(number_of_states, number_of_bdd_variables, indices.data());
+  std::size_t path = 0;
+  for (int s = 0; s < number_of_states; ++s) {
+    const int number_of_paths = serialized_dfa.number_of_paths[s];
+    dfaAllocExceptions(number_of_paths - 1);
+    for (int i = 0; i < number_of_paths - 1; ++i, ++path) {
+      cube = serialized_dfa.cubes.substr(path * number_of_bdd_variables, number_of_bdd_variables);
+      dfaStoreException(serialized_dfa.targets[path], &cube[0]);
+    }
+    dfaStoreState(serialized_dfa.targets[path]);
+    ++path;
+    const int status = serialized_dfa.statuses[s];
+    statuses[s] = (status == 1) ? '+' : ((status == -1) ? '-' : '0');
+  }
+  DFA* dfa = dfaBuild(&statuses[0]);
+  dfa->s = serialized_dfa.initial_state;
+  return dfa;
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
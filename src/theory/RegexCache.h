@@ -0,0 +1,144 @@
+/*
+ * RegexCache.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_THEORY_REGEXCACHE_H_
+#define SRC_THEORY_REGEXCACHE_H_
+
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <glog/logging.h>
+#include <mona/bdd.h>
+#include <mona/dfa.h>
+
+#include "StringAutomaton.h"
+
+namespace Vlab {
+namespace Theory {
+
+/**
+ * Process wide, size bounded LRU cache of regular expression automata keyed by the regular expression, the syntax
+ * flags it is parsed with and the number of bits per char. Cached automata are owned by the cache, lookups return
+ * copies that share the dfa with the cached automaton. The cache can be saved to a file and loaded in another process; a dfa is saved as
+ * flat arrays of states, paths and targets, so loading does not parse or compose anything.
+ */
+class RegexCache {
+ public:
+  struct Statistics {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    std::size_t size;
+    std::size_t capacity;
+  };
+
+  static RegexCache& Instance();
+
+  /**
+   * Gets the automaton of the regular expression if it is cached, computes and caches it otherwise.
+   * @param compute computes the automaton, cache keeps a copy
+   * @return an automaton owned by the caller
+   */
+  StringAutomaton_ptr GetOrCompute(const std::string& regex, const int syntax_flags, const int number_of_bdd_variables,
+                                   std::function<StringAutomaton_ptr()> compute);
+
+  /**
+   * Sets the maximum number of cached automata, 0 disables caching.
+   */
+  void set_capacity(const std::size_t capacity);
+
+  /**
+   * Writes all cached automata to the file
+   * @return false if the file cannot be written
+   */
+  bool Save(const std::string& file_name);
+
+  /**
+   * Adds the automata in the file to the cache up to its capacity, cached automata are kept. Corrupted entries are
+   * reported and skipped.
+   * @return false if the file does not exist or is not a cache file
+   */
+  bool Load(const std::string& file_name);
+
+  /**
+   * Tells if automata are added since the cache is loaded or saved
+   */
+  bool HasUnsavedEntries() const;
+  Statistics GetStatistics() const;
+  void Clear();
+  std::string str() const;
+
+  static const std::size_t DEFAULT_CAPACITY;
+
+ protected:
+  RegexCache();
+  ~RegexCache();
+  RegexCache(const RegexCache&) = delete;
+  RegexCache& operator=(const RegexCache&) = delete;
+
+  /**
+   * regex, syntax flags, number of bdd variables
+   */
+  using Key = std::tuple<std::string, int, int>;
+
+  /**
+   * A dfa as flat arrays, the transitions of a state are bdd paths of the state, i.e., a target and a cube over the
+   * bdd variables with '0', '1' and 'X' per variable
+   */
+  struct SerializedDFA {
+    int number_of_states;
+    int initial_state;
+    std::vector<int> statuses;
+    std::vector<int> number_of_paths;
+    std::vector<int> targets;
+    std::string cubes;
+  };
+
+  using Entry = std::pair<Key, StringAutomaton_ptr>;
+
+  static SerializedDFA SerializeDFA(const DFA* dfa, const int number_of_bdd_variables);
+
+  /**
+   * @return nullptr if the serialized dfa is not consistent or too large
+   */
+  static DFA* DeserializeDFA(const SerializedDFA& serialized_dfa, const int number_of_bdd_variables);
+
+  /**
+   * Adds an entry as the most recently used one unless the key is cached, takes the ownership of the automaton
+   */
+  void Insert(const Key& key, StringAutomaton_ptr regex_auto);
+  void Evict();
+
+  mutable std::mutex mutex_;
+  std::size_t capacity_;
+  unsigned long hits_;
+  unsigned long misses_;
+  unsigned long evictions_;
+  bool has_unsaved_entries_;
+  /**
+   * Most recently used entries are at the front
+   */
+  std::list<Entry> entries_;
+  std::map<Key, std::list<Entry>::iterator> index_;
+
+  static const std::string FILE_MAGIC;
+  static const int FILE_VERSION;
+  static const int MAX_NUMBER_OF_BDD_VARIABLES;
+  static const int MAX_NUMBER_OF_STATES;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_REGEXCACHE_H_ */
@@ -0,0 +1,306 @@
+/*
+ * RegexCompiler.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "RegexCompiler.h"
+
+#include <algorithm>
+
+namespace Vlab {
+namespace Theory {
+
+const int RegexCompiler::VLOG_LEVEL = 20;
+
+const unsigned long RegexCompiler::MAX_NUMBER_OF_POSITIONS = 4096;
+
+RegexCompiler::RegexCompiler(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables)
+    : number_of_bdd_variables_(number_of_bdd_variables) {
+  CHECK(IsSupported(regular_expression)) << "regular expression cannot be compiled directly: " << *regular_expression;
+  Fragment fragment = Build(regular_expression);
+  Determinize(fragment);
+  DVLOG(VLOG_LEVEL) << "compiled " << position_chars_.size() - 1 << " positions into " << transitions_.size()
+                    << " states: " << *regular_expression;
+}
+
+RegexCompiler::~RegexCompiler() {
+}
+
+bool RegexCompiler::IsSupported(Util::RegularExpression_ptr regular_expression) {
+  return HasSupportedOperators(regular_expression) and CountPositions(regular_expression) <= MAX_NUMBER_OF_POSITIONS;
+}
+
+const std::vector<std::vector<CharRange>>& RegexCompiler::GetTransitions() const {
+  return transitions_;
+}
+
+const std::vector<bool>& RegexCompiler::GetAcceptingStates() const {
+  return is_accepting_;
+}
+
+RegexCompiler::Fragment RegexCompiler::Build(Util::RegularExpression_ptr regular_expression) {
+  const unsigned max_symbol = (1u << number_of_bdd_variables_) - 1;
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION: {
+      Fragment left = Build(regular_expression->get_expr1());
+      return Union(left, Build(regular_expression->get_expr2()));
+    }
+    case Util::RegularExpression::Type::CONCATENATION: {
+      Fragment left = Build(regular_expression->get_expr1());
+      return Concat(left, Build(regular_expression->get_expr2()));
+    }
+    case Util::RegularExpression::Type::OPTIONAL:
+      return Optional(Build(regular_expression->get_expr1()));
+    case Util::RegularExpression::Type::REPEAT_STAR:
+      return Optional(Plus(Build(regular_expression->get_expr1())));
+    case Util::RegularExpression::Type::REPEAT_PLUS:
+      return Plus(Build(regular_expression->get_expr1()));
+    case Util::RegularExpression::Type::REPEAT_MIN: {
+      const unsigned long min = regular_expression->get_min();
+      if (min == 0) {
+        return Optional(Plus(Build(regular_expression->get_expr1())));
+      }
+      Fragment fragment = Repeat(regular_expression->get_expr1(), min - 1, min - 1);
+      return Concat(fragment, Plus(Build(regular_expression->get_expr1())));
+    }
+    case Util::RegularExpression::Type::REPEAT_MINMAX:
+      return Repeat(regular_expression->get_expr1(), regular_expression->get_min(), regular_expression->get_max());
+    case Util::RegularExpression::Type::CHAR: {
+      const unsigned char c = regular_expression->get_character();
+      return MakePosition(c, c);
+    }
+    case Util::RegularExpression::Type::CHAR_RANGE: {
+      unsigned char from = regular_expression->get_from_character();
+      unsigned char to = regular_expression->get_to_character();
+      if (from > to) {
+        std::swap(from, to);
+      }
+      return MakePosition(from, to);
+    }
+    case Util::RegularExpression::Type::ANYCHAR:
+      return MakePosition(0, max_symbol);
+    case Util::RegularExpression::Type::EMPTY:
+      return {false, {}, {}};
+    case Util::RegularExpression::Type::STRING: {
+      Fragment fragment {true, {}, {}};
+      for (unsigned char c : regular_expression->get_string()) {
+        fragment = Concat(fragment, MakePosition(c, c));
+      }
+      return fragment;
+    }
+    case Util::RegularExpression::Type::ANYSTRING:
+      return Optional(Plus(MakePosition(0, max_symbol)));
+    default:
+      LOG(FATAL) << "Unsupported regular expression" << *regular_expression;
+      break;
+  }
+  return {false, {}, {}};
+}
+
+RegexCompiler::Fragment RegexCompiler::MakePosition(const unsigned first, const unsigned last) {
+  const int position = position_chars_.size();
+  position_chars_.push_back({first, last, -1});
+  follow_positions_.push_back(std::vector<int>());
+  is_last_position_.push_back(false);
+  return {false, {position}, {position}};
+}
+
+RegexCompiler::Fragment RegexCompiler::Concat(const Fragment& left, const Fragment& right) {
+  for (int position : left.last_positions) {
+    auto& follow_positions = follow_positions_[position];
+    follow_positions.insert(follow_positions.end(), right.first_positions.begin(), right.first_positions.end());
+  }
+
+  Fragment fragment {left.is_nullable and right.is_nullable, left.first_positions, right.last_positions};
+  if (left.is_nullable) {
+    fragment.first_positions.insert(fragment.first_positions.end(), right.first_positions.begin(),
+                                    right.first_positions.end());
+  }
+  if (right.is_nullable) {
+    fragment.last_positions.insert(fragment.last_positions.end(), left.last_positions.begin(),
+                                   left.last_positions.end());
+  }
+  return fragment;
+}
+
+RegexCompiler::Fragment RegexCompiler::Union(const Fragment& left, const Fragment& right) {
+  Fragment fragment {left.is_nullable or right.is_nullable, left.first_positions, left.last_positions};
+  fragment.first_positions.insert(fragment.first_positions.end(), right.first_positions.begin(),
+                                  right.first_positions.end());
+  fragment.last_positions.insert(fragment.last_positions.end(), right.last_positions.begin(),
+                                 right.last_positions.end());
+  return fragment;
+}
+
+RegexCompiler::Fragment RegexCompiler::Plus(const Fragment& fragment) {
+  for (int position : fragment.last_positions) {
+    auto& follow_positions = follow_positions_[position];
+    follow_positions.insert(follow_positions.end(), fragment.first_positions.begin(), fragment.first_positions.end());
+  }
+  return fragment;
+}
+
+RegexCompiler::Fragment RegexCompiler::Optional(const Fragment& fragment) {
+  Fragment optional_fragment = fragment;
+  optional_fragment.is_nullable = true;
+  return optional_fragment;
+}
+
+/**
+ * Optional copies are nested, e.g., e{1,3} is e(e(e)?)?, so that each copy is followed by the next one only
+ */
+RegexCompiler::Fragment RegexCompiler::Repeat(Util::RegularExpression_ptr regular_expression, const unsigned long min,
+                                              const unsigned long max) {
+  if (min > max) {
+    return {false, {}, {}};
+  }
+
+  Fragment fragment {true, {}, {}};
+  for (unsigned long i = 0; i < min; ++i) {
+    fragment = Concat(fragment, Build(regular_expression));
+  }
+
+  Fragment optional_fragment {true, {}, {}};
+  for (unsigned long i = min; i < max; ++i) {
+    Fragment copy = Build(regular_expression);
+    optional_fragment = Optional(Concat(copy, optional_fragment));
+  }
+  return Concat(fragment, optional_fragment);
+}
+
+/**
+ * The initial state is a virtual position that is followed by the first positions. Char ranges of the positions that
+ * can follow a state are split at their bounds, each piece goes to the set of positions that contain it.
+ */
+void RegexCompiler::Determinize(const Fragment& fragment) {
+  for (int position : fragment.last_positions) {
+    is_last_position_[position] = true;
+  }
+  const int start_position = position_chars_.size();
+  position_chars_.push_back({0, 0, -1});
+  follow_positions_.push_back(fragment.first_positions);
+  is_last_position_.push_back(false);
+
+  std::map<std::vector<int>, int> state_ids;
+  std::vector<std::vector<int>> states;
+  states.push_back({start_position});
+  state_ids[states.back()] = 0;
+
+  std::vector<int> next_positions;
+  std::vector<unsigned long> bounds;
+  std::vector<int> target;
+  for (std::size_t id = 0; id < states.size(); ++id) {
+    bool is_accepting = (id == 0 and fragment.is_nullable);
+    next_positions.clear();
+    for (int position : states[id]) {
+      is_accepting = is_accepting or is_last_position_[position];
+      next_positions.insert(next_positions.end(), follow_positions_[position].begin(), follow_positions_[position].end());
+    }
+    std::sort(next_positions.begin(), next_positions.end());
+    next_positions.erase(std::unique(next_positions.begin(), next_positions.end()), next_positions.end());
+
+    bounds.clear();
+    for (int position : next_positions) {
+      bounds.push_back(position_chars_[position].first);
+      bounds.push_back((unsigned long)position_chars_[position].last + 1);
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    std::vector<CharRange> ranges;
+    for (std::size_t i = 0; i + 1 < bounds.size(); ++i) {
+      const unsigned first = bounds[i];
+      const unsigned last = bounds[i + 1] - 1;
+      target.clear();
+      for (int position : next_positions) {
+        if (position_chars_[position].first <= first and first <= position_chars_[position].last) {
+          target.push_back(position);
+        }
+      }
+      if (target.empty()) {
+        continue;
+      }
+
+      int next_state = -1;
+      auto it = state_ids.find(target);
+      if (it == state_ids.end()) {
+        next_state = states.size();
+        state_ids[target] = next_state;
+        states.push_back(target);
+      } else {
+        next_state = it->second;
+      }
+
+      if (not ranges.empty() and ranges.back().next_state == next_state and ranges.back().last + 1 == first) {
+        ranges.back().last = last;
+      } else {
+        ranges.push_back({first, last, next_state});
+      }
+    }
+    transitions_.push_back(std::move(ranges));
+    is_accepting_.push_back(is_accepting);
+  }
+}
+
+bool RegexCompiler::HasSupportedOperators(Util::RegularExpression_ptr regular_expression) {
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION:
+    case Util::RegularExpression::Type::CONCATENATION:
+      return HasSupportedOperators(regular_expression->get_expr1())
+          and HasSupportedOperators(regular_expression->get_expr2());
+    case Util::RegularExpression::Type::OPTIONAL:
+    case Util::RegularExpression::Type::REPEAT_STAR:
+    case Util::RegularExpression::Type::REPEAT_PLUS:
+    case Util::RegularExpression::Type::REPEAT_MIN:
+    case Util::RegularExpression::Type::REPEAT_MINMAX:
+      return HasSupportedOperators(regular_expression->get_expr1());
+    case Util::RegularExpression::Type::CHAR:
+    case Util::RegularExpression::Type::CHAR_RANGE:
+    case Util::RegularExpression::Type::ANYCHAR:
+    case Util::RegularExpression::Type::EMPTY:
+    case Util::RegularExpression::Type::STRING:
+    case Util::RegularExpression::Type::ANYSTRING:
+      return true;
+    default:
+      return false;
+  }
+}
+
+unsigned long RegexCompiler::CountPositions(Util::RegularExpression_ptr regular_expression) {
+  auto saturate = [](const unsigned long count) {
+    return std::min(count, MAX_NUMBER_OF_POSITIONS + 1);
+  };
+  auto multiply = [&saturate](const unsigned long count, const unsigned long times) {
+    return (count == 0) ? 0 : ((times > MAX_NUMBER_OF_POSITIONS) ? MAX_NUMBER_OF_POSITIONS + 1 : saturate(count * times));
+  };
+
+  switch (regular_expression->type()) {
+    case Util::RegularExpression::Type::UNION:
+    case Util::RegularExpression::Type::CONCATENATION:
+      return saturate(CountPositions(regular_expression->get_expr1()) + CountPositions(regular_expression->get_expr2()));
+    case Util::RegularExpression::Type::OPTIONAL:
+    case Util::RegularExpression::Type::REPEAT_STAR:
+    case Util::RegularExpression::Type::REPEAT_PLUS:
+      return CountPositions(regular_expression->get_expr1());
+    case Util::RegularExpression::Type::REPEAT_MIN:
+      return multiply(CountPositions(regular_expression->get_expr1()), std::max(regular_expression->get_min(), 1ul));
+    case Util::RegularExpression::Type::REPEAT_MINMAX:
+      if (regular_expression->get_min() > regular_expression->get_max()) {
+        return 0;
+      }
+      return multiply(CountPositions(regular_expression->get_expr1()), regular_expression->get_max());
+    case Util::RegularExpression::Type::CHAR:
+    case Util::RegularExpression::Type::CHAR_RANGE:
+    case Util::RegularExpression::Type::ANYCHAR:
+    case Util::RegularExpression::Type::ANYSTRING:
+      return 1;
+    case Util::RegularExpression::Type::STRING:
+      return saturate(regular_expression->get_string().size());
+    default:
+      return 0;
+  }
+}
+
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,101 @@
+/*
+ * RegexCompiler.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_THEORY_REGEXCOMPILER_H_
+#define SRC_THEORY_REGEXCOMPILER_H_
+
+#include <map>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../utils/RegularExpression.h"
+#include "Automaton.h"
+
+namespace Vlab {
+namespace Theory {
+
+/**
+ * Compiles a regular expression into explicit dfa transitions in one pass, without building an automaton per node.
+ * Every char, char class and any char of the expression is a position (Glushkov construction); bounded repetitions
+ * are unrolled into copies of their operand. Positions that can follow each other are linked while the expression is
+ * traversed, then a single subset construction over the positions splits the alphabet into char ranges.
+ * Intersection, complement, named automata and intervals are not supported.
+ */
+class RegexCompiler {
+ public:
+  /**
+   * @param regular_expression must be supported
+   * @param number_of_bdd_variables bits per char
+   */
+  RegexCompiler(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables);
+  virtual ~RegexCompiler();
+
+  /**
+   * Checks if the expression can be compiled directly, i.e., it has only supported operators and a bounded number of
+   * positions after unrolling repetitions
+   */
+  static bool IsSupported(Util::RegularExpression_ptr regular_expression);
+
+  /**
+   * Gets transitions of the dfa, state 0 is the initial state; symbols without a range go to a rejecting sink
+   */
+  const std::vector<std::vector<CharRange>>& GetTransitions() const;
+
+  const std::vector<bool>& GetAcceptingStates() const;
+
+ protected:
+  /**
+   * Positions an expression can start and end with, and whether it accepts the empty string
+   */
+  struct Fragment {
+    bool is_nullable;
+    std::vector<int> first_positions;
+    std::vector<int> last_positions;
+  };
+
+  Fragment Build(Util::RegularExpression_ptr regular_expression);
+  Fragment MakePosition(const unsigned first, const unsigned last);
+  Fragment Concat(const Fragment& left, const Fragment& right);
+  Fragment Union(const Fragment& left, const Fragment& right);
+  Fragment Plus(const Fragment& fragment);
+  Fragment Optional(const Fragment& fragment);
+  Fragment Repeat(Util::RegularExpression_ptr regular_expression, const unsigned long min, const unsigned long max);
+
+  /**
+   * Subset construction, a state is a sorted set of positions that the input read so far can end at
+   */
+  void Determinize(const Fragment& fragment);
+
+  static bool HasSupportedOperators(Util::RegularExpression_ptr regular_expression);
+
+  /**
+   * Number of positions after unrolling, saturates above the maximum
+   */
+  static unsigned long CountPositions(Util::RegularExpression_ptr regular_expression);
+
+  const int number_of_bdd_variables_;
+
+  /**
+   * Char range of each position, next_state is not used
+   */
+  std::vector<CharRange> position_chars_;
+  std::vector<std::vector<int>> follow_positions_;
+  std::vector<bool> is_last_position_;
+
+  std::vector<std::vector<CharRange>> transitions_;
+  std::vector<bool> is_accepting_;
+
+  static const unsigned long MAX_NUMBER_OF_POSITIONS;
+
+ private:
+  static const int VLOG_LEVEL;
+};
+
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* SRC_THEORY_REGEXCOMPILER_H_ */
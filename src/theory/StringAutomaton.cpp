@@ -7,6 +7,10 @@
 
 #include "StringAutomaton.h"
 
+#include "FactoryCache.h"
+#include "RegexCache.h"
+#include "RegexCompiler.h"
+
 namespace Vlab {
 namespace Theory {
 
@@ -15,8 +19,8 @@ bool StringAutomaton::debug = false;
 
 StringAutomaton::TransitionTable StringAutomaton::TRANSITION_TABLE;
 
-StringAutomaton::StringAutomaton(const DFA_ptr dfa, const int number_of_bdd_variables)
-		:	Automaton(Automaton::Type::MULTITRACK, dfa, number_of_bdd_variables),
+StringAutomaton::StringAutomaton(const DFA_ptr dfa, const int number_of_bdd_variables, const bool is_minimized)
+		:	Automaton(Automaton::Type::MULTITRACK, dfa, number_of_bdd_variables, is_minimized),
 			num_tracks_(number_of_bdd_variables > DEFAULT_NUM_OF_VARIABLES ? number_of_bdd_variables / VAR_PER_TRACK : 1),
 			formula_(new StringFormula()) {
 
@@ -135,12 +139,13 @@ StringAutomaton::StringAutomaton(const DFA_ptr dfa, const int i_track, const int
 	result = temp;
 
 	delete[] statuses;
-	this->dfa_ = result;
+	set_dfa(result, true);
 }
 
 // TODO: Find better solution for figuring out num_tracks_
-StringAutomaton::StringAutomaton(const DFA_ptr dfa, StringFormula_ptr formula, const int number_of_bdd_variables)
-		:	Automaton(Automaton::Type::MULTITRACK, dfa, number_of_bdd_variables) {
+StringAutomaton::StringAutomaton(const DFA_ptr dfa, StringFormula_ptr formula, const int number_of_bdd_variables,
+		const bool is_minimized)
+		:	Automaton(Automaton::Type::MULTITRACK, dfa, number_of_bdd_variables, is_minimized) {
 	if(formula == nullptr) {
 		LOG(FATAL) << "formula is nullptr!";
 	}
@@ -215,9 +220,11 @@ StringAutomaton_ptr StringAutomaton::MakeString(const std::string str, const int
 
   dfaSetup(number_of_states, number_of_bdd_variables, GetBddVariableIndices(number_of_bdd_variables));
 
+  std::vector<char> exception (number_of_bdd_variables + 1);
   for (int i = 0; i < str_length; i++) {
     dfaAllocExceptions(1);
-    dfaStoreException(i + 1, const_cast<char*>(GetBinaryStringMSB((unsigned long) str[i], number_of_bdd_variables).data()));
+    FillBinaryFormat((unsigned long) str[i], number_of_bdd_variables, &exception[0]);
+    dfaStoreException(i + 1, &exception[0]);
     dfaStoreState(str_length + 1);
     statuses[i] = '-';
   }
@@ -269,31 +276,40 @@ StringAutomaton_ptr StringAutomaton::MakeCharRange(const char from, const char t
     std::swap(from_char, to_char);
   }
 
-  char statuses[3] { '-', '+', '-' };
-  int* variable_indices = GetBddVariableIndices(number_of_bdd_variables);
+  auto range_dfa = FactoryCache::Instance().GetOrMake(FactoryCache::Factory::CHAR_RANGE,
+      {static_cast<int>(from_char), static_cast<int>(to_char), number_of_bdd_variables},
+      [from_char, to_char, number_of_bdd_variables]() {
+    char statuses[3] { '-', '+', '-' };
+    int* variable_indices = GetBddVariableIndices(number_of_bdd_variables);
 
-  dfaSetup(3, number_of_bdd_variables, variable_indices);
+    dfaSetup(3, number_of_bdd_variables, variable_indices);
 
-  int initial_state = to_char - from_char;
+    int initial_state = to_char - from_char;
 
-  //state 0
-  dfaAllocExceptions(initial_state + 1);
-  for (unsigned long index = from_char; index <= to_char; index++) {
-    std::vector<char> v = GetBinaryFormat(index,number_of_bdd_variables);
-    dfaStoreException(1, const_cast<char*>(GetBinaryStringMSB(index, number_of_bdd_variables).data()));
-  }
-  dfaStoreState(2);
+    //state 0
+    dfaAllocExceptions(initial_state + 1);
+    std::vector<char> exception (number_of_bdd_variables + 1);
+    for (unsigned long index = from_char; index <= to_char; index++) {
+      FillBinaryFormat(index, number_of_bdd_variables, &exception[0]);
+      dfaStoreException(1, &exception[0]);
+    }
+    dfaStoreState(2);
 
-  //state 1
-  dfaAllocExceptions(0);
-  dfaStoreState(2);
+    //state 1
+    dfaAllocExceptions(0);
+    dfaStoreState(2);
 
-  //state 2
-  dfaAllocExceptions(0);
-  dfaStoreState(2);
+    //state 2
+    dfaAllocExceptions(0);
+    dfaStoreState(2);
 
-  DFA_ptr range_dfa = dfaBuild(statuses);
-  StringAutomaton_ptr range_auto = new StringAutomaton(range_dfa, number_of_bdd_variables);
+    DFA_ptr result_dfa = dfaBuild(statuses);
+    DFA_ptr minimized_dfa = dfaMinimize(result_dfa);
+    dfaFree(result_dfa);
+    return minimized_dfa;
+  });
+  StringAutomaton_ptr range_auto = new StringAutomaton(nullptr, number_of_bdd_variables);
+  range_auto->ShareDFA(range_dfa, true);
 
   DVLOG(VLOG_LEVEL) << range_auto->id_ << " = MakeCharRange('" << from << "', '" << to << "')";
 
@@ -307,26 +323,69 @@ StringAutomaton_ptr StringAutomaton::MakeAnyChar(const int number_of_bdd_variabl
 }
 
 StringAutomaton_ptr StringAutomaton::MakeRegexAuto(const std::string regex, const int number_of_bdd_variables) {
-  Util::RegularExpression regular_expression (regex);
-  StringAutomaton_ptr regex_auto = StringAutomaton::MakeRegexAuto(&regular_expression, number_of_bdd_variables);
+  // parsing depends on the syntax flags, they are part of the key
+  StringAutomaton_ptr regex_auto = RegexCache::Instance().GetOrCompute(regex, Util::RegularExpression::DEFAULT,
+      number_of_bdd_variables, [&regex, number_of_bdd_variables]() {
+    Util::RegularExpression regular_expression (regex);
+    return StringAutomaton::MakeRegexAuto(&regular_expression, number_of_bdd_variables);
+  });
   DVLOG(VLOG_LEVEL) << regex_auto->id_ << " = MakeRegexAuto(" << regex << ")";
 
   return regex_auto;
 }
 
 StringAutomaton_ptr StringAutomaton::MakeRegexAuto(Util::RegularExpression_ptr regular_expression, const int number_of_bdd_variables) {
+  // compile supported (sub)expressions into a single dfa, compose automata only for the rest
+  if (number_of_bdd_variables == DEFAULT_NUM_OF_VARIABLES and RegexCompiler::IsSupported(regular_expression)) {
+    RegexCompiler regex_compiler(regular_expression, number_of_bdd_variables);
+    DFA_ptr regex_dfa = Automaton::DFAMakeFromCharRanges(regex_compiler.GetTransitions(),
+                                                         regex_compiler.GetAcceptingStates(), number_of_bdd_variables);
+    DFA_ptr minimized_dfa = dfaMinimize(regex_dfa);
+    dfaFree(regex_dfa);
+    return new StringAutomaton(minimized_dfa, number_of_bdd_variables, true);
+  }
+
   StringAutomaton_ptr regex_auto = nullptr;
   StringAutomaton_ptr regex_expr1_auto = nullptr;
   StringAutomaton_ptr regex_expr2_auto = nullptr;
 
   switch (regular_expression->type()) {
   case Util::RegularExpression::Type::UNION:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
-    regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables);
-    regex_auto = regex_expr1_auto->Union(regex_expr2_auto);
-    delete regex_expr1_auto;
-    delete regex_expr2_auto;
+  case Util::RegularExpression::Type::INTERSECTION: {
+    // operands of a chain of the same operation are made first, the products of the chain are minimized once
+    const auto chain_type = regular_expression->type();
+    std::vector<StringAutomaton_ptr> operand_autos;
+    std::stack<Util::RegularExpression_ptr> expressions;
+    expressions.push(regular_expression);
+    while (not expressions.empty()) {
+      auto expression = expressions.top();
+      expressions.pop();
+      if (expression == regular_expression or (expression->type() == chain_type and
+          not (number_of_bdd_variables == DEFAULT_NUM_OF_VARIABLES and RegexCompiler::IsSupported(expression)))) {
+        expressions.push(expression->get_expr2());
+        expressions.push(expression->get_expr1());
+      } else {
+        operand_autos.push_back(StringAutomaton::MakeRegexAuto(expression, number_of_bdd_variables));
+      }
+    }
+
+    {
+      Automaton::MinimizationDeferral minimization_deferral;
+      regex_auto = operand_autos.front();
+      for (auto it = operand_autos.begin() + 1; it != operand_autos.end(); ++it) {
+        StringAutomaton_ptr tmp_auto = regex_auto;
+        if (chain_type == Util::RegularExpression::Type::UNION) {
+          regex_auto = tmp_auto->Union(*it);
+        } else {
+          regex_auto = tmp_auto->Intersect(*it);
+        }
+        delete tmp_auto;
+        delete *it;
+      }
+    }
+    regex_auto->Minimize();
     break;
+  }
   case Util::RegularExpression::Type::CONCATENATION:
     regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
     regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables);
@@ -334,13 +393,6 @@ StringAutomaton_ptr StringAutomaton::MakeRegexAuto(Util::RegularExpression_ptr r
     delete regex_expr1_auto;
     delete regex_expr2_auto;
     break;
-  case Util::RegularExpression::Type::INTERSECTION:
-    regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
-    regex_expr2_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr2(), number_of_bdd_variables);
-    regex_auto = regex_expr1_auto->Intersect(regex_expr2_auto);
-    delete regex_expr1_auto;
-    delete regex_expr2_auto;
-    break;
   case Util::RegularExpression::Type::OPTIONAL:
     regex_expr1_auto = StringAutomaton::MakeRegexAuto(regular_expression->get_expr1(), number_of_bdd_variables);
     regex_auto = regex_expr1_auto->Optional();
@@ -404,43 +456,43 @@ StringAutomaton_ptr StringAutomaton::MakeRegexAuto(Util::RegularExpression_ptr r
 }
 
 StringAutomaton_ptr StringAutomaton::MakeAnyStringLengthEqualTo(const int length, const int number_of_bdd_variables) {
-  DFA_ptr length_dfa = Automaton::DFAMakeAcceptingAnyWithInRange(length, length, number_of_bdd_variables);
-  StringAutomaton_ptr length_auto = new StringAutomaton(length_dfa, number_of_bdd_variables);
+  StringAutomaton_ptr length_auto = new StringAutomaton(nullptr, number_of_bdd_variables);
+  length_auto->ShareDFA(Automaton::DFAGetAcceptingAnyWithInRange(length, length, number_of_bdd_variables), true);
   DVLOG(VLOG_LEVEL) << length_auto->id_ << " = MakeAnyStringLengthEqualTo(" << length <<  ")";
   return length_auto;
 }
 
 StringAutomaton_ptr StringAutomaton::MakeAnyStringLengthLessThan(const int length, const int number_of_bdd_variables){
-  DFA_ptr length_dfa = Automaton::DFAMakeAcceptingAnyWithInRange(0, length-1, number_of_bdd_variables);
-  StringAutomaton_ptr length_auto = new StringAutomaton(length_dfa, number_of_bdd_variables);
+  StringAutomaton_ptr length_auto = new StringAutomaton(nullptr, number_of_bdd_variables);
+  length_auto->ShareDFA(Automaton::DFAGetAcceptingAnyWithInRange(0, length - 1, number_of_bdd_variables), true);
   DVLOG(VLOG_LEVEL) << length_auto->id_ << " = MakeAnyStringLengthLessThan(" << length <<  ")";
   return length_auto;
 }
 
 StringAutomaton_ptr StringAutomaton::MakeAnyStringLengthLessThanOrEqualTo(const int length, const int number_of_bdd_variables){
-  DFA_ptr length_dfa = Automaton::DFAMakeAcceptingAnyWithInRange(0, length, number_of_bdd_variables);
-  StringAutomaton_ptr length_auto = new StringAutomaton(length_dfa, number_of_bdd_variables);
+  StringAutomaton_ptr length_auto = new StringAutomaton(nullptr, number_of_bdd_variables);
+  length_auto->ShareDFA(Automaton::DFAGetAcceptingAnyWithInRange(0, length, number_of_bdd_variables), true);
   DVLOG(VLOG_LEVEL) << length_auto->id_ << " = MakeAnyStringLengthLessThanOrEqualTo(" << length <<  ")";
   return length_auto;
 }
 
 StringAutomaton_ptr StringAutomaton::MakeAnyStringLengthGreaterThan(const int length, const int number_of_bdd_variables) {
-  DFA_ptr length_dfa = Automaton::DFAMakeAcceptingAnyAfterLength(length + 1, number_of_bdd_variables);
-  StringAutomaton_ptr length_auto = new StringAutomaton(length_dfa, number_of_bdd_variables);
+  StringAutomaton_ptr length_auto = new StringAutomaton(nullptr, number_of_bdd_variables);
+  length_auto->ShareDFA(Automaton::DFAGetAcceptingAnyAfterLength(length + 1, number_of_bdd_variables), true);
   DVLOG(VLOG_LEVEL) << length_auto->id_ << " = MakeAnyStringLengthGreaterThan(" << length <<  ")";
   return length_auto;
 }
 
 StringAutomaton_ptr StringAutomaton::MakeAnyStringLengthGreaterThanOrEqualTo(const int length, const int number_of_bdd_variables) {
-  DFA_ptr length_dfa = Automaton::DFAMakeAcceptingAnyAfterLength(length, number_of_bdd_variables);
-  StringAutomaton_ptr length_auto = new StringAutomaton(length_dfa, number_of_bdd_variables);
+  StringAutomaton_ptr length_auto = new StringAutomaton(nullptr, number_of_bdd_variables);
+  length_auto->ShareDFA(Automaton::DFAGetAcceptingAnyAfterLength(length, number_of_bdd_variables), true);
   DVLOG(VLOG_LEVEL) << length_auto->id_ << " = MakeAnyStringLengthGreaterThanOrEqualTo(" << length <<  ")";
   return length_auto;
 }
 
 StringAutomaton_ptr StringAutomaton::MakeAnyStringWithLengthInRange(const int start, const int end, const int number_of_bdd_variables) {
-  DFA_ptr length_dfa = Automaton::DFAMakeAcceptingAnyWithInRange(start, end, number_of_bdd_variables);
-  StringAutomaton_ptr length_auto = new StringAutomaton(length_dfa, number_of_bdd_variables);
+  StringAutomaton_ptr length_auto = new StringAutomaton(nullptr, number_of_bdd_variables);
+  length_auto->ShareDFA(Automaton::DFAGetAcceptingAnyWithInRange(start, end, number_of_bdd_variables), true);
   DVLOG(VLOG_LEVEL) << length_auto->id_ << " = MakeAnyStringWithLengthInRange(" << start << "," << end <<  ")";
   return length_auto;
 }
@@ -584,7 +636,7 @@ StringAutomaton_ptr StringAutomaton::MakeBegins(StringFormula_ptr formula) {
 	temp_dfa = dfaBuild("--+-");
 	result_dfa = dfaMinimize(temp_dfa);
 	dfaFree(temp_dfa);
-	result_auto = new StringAutomaton(result_dfa,formula,var*num_tracks);
+	result_auto = new StringAutomaton(result_dfa,formula,var*num_tracks,true);
 	DVLOG(VLOG_LEVEL) << result_auto->id_ << " = MakeBegins(" << formula->str() << ")";
 	return result_auto;
 }
@@ -750,7 +802,7 @@ StringAutomaton_ptr StringAutomaton::MakeNotBegins(StringFormula_ptr formula) {
 	temp_dfa = dfaBuild("---+--");
 	result_dfa = dfaMinimize(temp_dfa);
 	dfaFree(temp_dfa);
-	result_auto = new StringAutomaton(result_dfa,formula,var*num_tracks);
+	result_auto = new StringAutomaton(result_dfa,formula,var*num_tracks,true);
 	DVLOG(VLOG_LEVEL) << result_auto->id_ << " = MakeNotBegins(" << formula->str() << ")";
 	return result_auto;
 }
@@ -1154,7 +1206,7 @@ StringAutomaton_ptr StringAutomaton::MakeAnyStringUnaligned(StringFormula_ptr fo
   result = dfaMinimize(temp);
   dfaFree(temp);
   //delete[] mindices;
-  result_auto = new StringAutomaton(result, formula,len);
+  result_auto = new StringAutomaton(result, formula,len,true);
   return result_auto;
 }
 
@@ -1168,27 +1220,35 @@ StringAutomaton_ptr StringAutomaton::MakeAnyStringAligned(StringFormula_ptr form
     return result_auto;
   }
 
-  StringAutomaton_ptr aligned_auto = nullptr, any_auto = nullptr, temp_auto = nullptr;
-  StringAutomaton_ptr any_string_auto = nullptr;
-
-  aligned_auto = MakeAnyStringUnaligned(formula);
-  any_string_auto = StringAutomaton::MakeAnyString();
+  // the aligned universe depends only on the number of tracks
   const int number_of_string_vars = formula->GetNumberOfVariables();
-  for(unsigned i = 0; i < number_of_string_vars; i++) {
-    any_auto = new StringAutomaton(any_string_auto->getDFA(), i, number_of_string_vars, DEFAULT_NUM_OF_VARIABLES);
-    temp_auto = aligned_auto->Intersect(any_auto);
+  auto aligned_dfa = FactoryCache::Instance().GetOrMake(FactoryCache::Factory::ANY_STRING_ALIGNED,
+      {number_of_string_vars}, [formula, number_of_string_vars]() {
+    StringAutomaton_ptr aligned_auto = nullptr, any_auto = nullptr, temp_auto = nullptr;
+    StringAutomaton_ptr any_string_auto = nullptr;
+
+    aligned_auto = MakeAnyStringUnaligned(formula->clone());
+    any_string_auto = StringAutomaton::MakeAnyString();
+    for(unsigned i = 0; i < number_of_string_vars; i++) {
+      any_auto = new StringAutomaton(any_string_auto->getDFA(), i, number_of_string_vars, DEFAULT_NUM_OF_VARIABLES);
+      temp_auto = aligned_auto->Intersect(any_auto);
+      delete aligned_auto;
+      delete any_auto;
+      aligned_auto = temp_auto;
+    }
+    delete any_string_auto;
+    DFA_ptr result_dfa = dfaMinimize(aligned_auto->getDFA());
     delete aligned_auto;
-    delete any_auto;
-    aligned_auto = temp_auto;
-  }
-  result_auto = aligned_auto;
-  delete any_string_auto;
+    return result_dfa;
+  });
+  result_auto = new StringAutomaton(nullptr, formula, number_of_string_vars * VAR_PER_TRACK);
+  result_auto->ShareDFA(aligned_dfa, true);
   return result_auto;
 }
 
 StringAutomaton_ptr StringAutomaton::Complement() {
 	auto complement_dfa = Automaton::DFAComplement(dfa_);
-	auto temp_auto = new StringAutomaton(complement_dfa, formula_->Complement(),num_of_bdd_variables_);
+	auto temp_auto = new StringAutomaton(complement_dfa, formula_->Complement(),num_of_bdd_variables_,is_minimized_);
 	StringAutomaton_ptr complement_auto = temp_auto;
 
 	if(num_tracks_ > 1) {
@@ -1243,7 +1303,9 @@ StringAutomaton_ptr StringAutomaton::Intersect(StringAutomaton_ptr other_auto) {
     delete relation_other_auto;
     return intersect_auto;
   }
-	auto intersect_dfa = Automaton::DFAIntersect(this->dfa_, other_auto->dfa_);
+	auto intersect_dfa = GetOrComputeDFA(OperationCache::Operation::INTERSECT, {this, other_auto}, {}, [this, other_auto]() {
+	  return Automaton::DFAIntersect(this->dfa_, other_auto->dfa_);
+	});
   StringFormula_ptr intersect_formula = nullptr;
   if(formula_ != nullptr && other_auto->formula_ != nullptr) {
     intersect_formula = formula_->Intersect(other_auto->formula_);
@@ -1253,17 +1315,58 @@ StringAutomaton_ptr StringAutomaton::Intersect(StringAutomaton_ptr other_auto) {
     intersect_formula = nullptr;
   }
 
-	auto intersect_auto = new StringAutomaton(intersect_dfa,intersect_formula,this->num_of_bdd_variables_);
+	auto intersect_auto = new StringAutomaton(nullptr,intersect_formula,this->num_of_bdd_variables_);
+	intersect_auto->ShareDFA(intersect_dfa, not IsMinimizationDeferred());
 
   DVLOG(VLOG_LEVEL) << intersect_auto->id_ << " = [" << this->id_ << "]->Intersect(" << other_auto->id_ << ")";
 	return intersect_auto;
 }
 
+StringAutomaton_ptr StringAutomaton::Intersect(const std::vector<StringAutomaton_ptr>& automata) {
+  CHECK(not automata.empty());
+  StringAutomaton_ptr first_auto = automata.front();
+  bool has_same_tracks = true;
+  for (auto string_auto : automata) {
+    has_same_tracks = has_same_tracks and (string_auto->num_tracks_ == first_auto->num_tracks_);
+  }
+
+  if (not has_same_tracks) {
+    StringAutomaton_ptr intersect_auto = first_auto->clone();
+    for (auto it = automata.begin() + 1; it != automata.end() and not intersect_auto->IsEmptyLanguage(); ++it) {
+      StringAutomaton_ptr tmp_auto = intersect_auto;
+      intersect_auto = tmp_auto->Intersect(*it);
+      delete tmp_auto;
+    }
+    return intersect_auto;
+  }
+
+  std::vector<DFA_ptr> dfas;
+  StringFormula_ptr intersect_formula = (first_auto->formula_ == nullptr) ? nullptr : first_auto->formula_->clone();
+  for (auto string_auto : automata) {
+    dfas.push_back(string_auto->dfa_);
+    if (string_auto != first_auto and intersect_formula != nullptr and string_auto->formula_ != nullptr) {
+      StringFormula_ptr tmp_formula = intersect_formula;
+      intersect_formula = tmp_formula->Intersect(string_auto->formula_);
+      delete tmp_formula;
+    }
+  }
+
+  // a single operand is copied as it is
+  const bool is_minimized = (dfas.size() > 1) ? not IsMinimizationDeferred() : first_auto->is_minimized_;
+  auto intersect_auto = new StringAutomaton(Automaton::DFAIntersect(dfas), intersect_formula,
+                                            first_auto->num_of_bdd_variables_, is_minimized);
+  DVLOG(VLOG_LEVEL) << intersect_auto->id_ << " = Intersect(<" << automata.size() << " automata>)";
+  return intersect_auto;
+}
+
 StringAutomaton_ptr StringAutomaton::Union(StringAutomaton_ptr other_auto) {
 	CHECK_EQ(this->num_tracks_,other_auto->num_tracks_);
-	auto union_dfa = Automaton::DFAUnion(this->dfa_, other_auto->dfa_);
+	auto union_dfa = GetOrComputeDFA(OperationCache::Operation::UNION, {this, other_auto}, {}, [this, other_auto]() {
+	  return Automaton::DFAUnion(this->dfa_, other_auto->dfa_);
+	});
 	auto union_formula = this->formula_->Union(other_auto->formula_);
-	auto union_auto = new StringAutomaton(union_dfa,union_formula,this->num_of_bdd_variables_);
+	auto union_auto = new StringAutomaton(nullptr,union_formula,this->num_of_bdd_variables_);
+	union_auto->ShareDFA(union_dfa, not IsMinimizationDeferred());
 
 	DVLOG(VLOG_LEVEL) << union_auto->id_ << " = [" << this->id_ << "]->union(" << other_auto->id_ << ")";
 	return union_auto;
@@ -1284,8 +1387,12 @@ StringAutomaton_ptr StringAutomaton::Concat(StringAutomaton_ptr other_auto) {
 //  this->Minimize();
 //  other_auto->Minimize();
 //  StringAutomaton_ptr concat_auto = static_cast<StringAutomaton_ptr>(Automaton::Concat(other_auto));
-  auto concat_dfa = StringAutomaton::concat(dfa_, other_auto->dfa_,this->num_of_bdd_variables_);
-  auto concat_auto = new StringAutomaton(concat_dfa,this->num_of_bdd_variables_);
+  auto concat_dfa = GetOrComputeDFA(OperationCache::Operation::CONCAT, {this, other_auto}, {this->num_of_bdd_variables_},
+      [this, other_auto]() {
+    return StringAutomaton::concat(dfa_, other_auto->dfa_,this->num_of_bdd_variables_);
+  });
+  auto concat_auto = new StringAutomaton(nullptr,this->num_of_bdd_variables_);
+  concat_auto->ShareDFA(concat_dfa, true);
   return concat_auto;
 }
 
@@ -1414,7 +1521,7 @@ StringAutomaton_ptr StringAutomaton::Closure() {
   result_dfa = dfaMinimize(temp_dfa);
   dfaFree(temp_dfa);
 
-  result_auto = new StringAutomaton(result_dfa, num_of_bdd_variables_);
+  result_auto = new StringAutomaton(result_dfa, num_of_bdd_variables_, true);
   //delete[] indices;
   delete[] statuses;
   DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->closure()";
@@ -1445,11 +1552,8 @@ StringAutomaton_ptr StringAutomaton::Repeat(unsigned min) {
   } else if (min == 1) {
     repeated_auto = this->Closure();
   } else {
-    StringAutomaton_ptr closure_auto = this->Closure();
-    StringAutomaton_ptr range_auto = StringAutomaton::MakeAnyStringLengthGreaterThanOrEqualTo(min);
-    repeated_auto = closure_auto->Intersect(range_auto);
-    delete range_auto; range_auto = nullptr;
-    delete closure_auto; closure_auto = nullptr;
+    repeated_auto = new StringAutomaton(this->DFARepeat(min, 0, false), num_of_bdd_variables_);
+    repeated_auto->Minimize();
   }
 
   DVLOG(VLOG_LEVEL) << repeated_auto->id_ << " = [" << this->id_ << "]->repeat(" << min << ")";
@@ -1461,18 +1565,15 @@ StringAutomaton_ptr StringAutomaton::Repeat(unsigned min, unsigned max) {
 	CHECK_EQ(this->num_tracks_,1);
   StringAutomaton_ptr repeated_auto = nullptr;
 
-  if (min == 0) {
-    repeated_auto = this->KleeneClosure();
+  if (min > max) {
+    repeated_auto = StringAutomaton::MakePhi(num_of_bdd_variables_);
+  } else if (max == 0) {
+    repeated_auto = StringAutomaton::MakeEmptyString(num_of_bdd_variables_);
   } else {
-    repeated_auto = this->Closure();
+    repeated_auto = new StringAutomaton(this->DFARepeat(min, max, true), num_of_bdd_variables_);
+    repeated_auto->Minimize();
   }
 
-  StringAutomaton_ptr range_auto = StringAutomaton::MakeAnyStringWithLengthInRange(min, max);
-  StringAutomaton_ptr tmp_auto = repeated_auto;
-  repeated_auto = tmp_auto->Intersect(range_auto);
-  delete range_auto; range_auto = nullptr;
-  delete tmp_auto; tmp_auto = nullptr;
-
   DVLOG(VLOG_LEVEL) << repeated_auto->id_ << " = [" << this->id_ << "]->repeat(" << min << ", " << max << ")";
 
   return repeated_auto;
@@ -1606,7 +1707,7 @@ StringAutomaton_ptr StringAutomaton::Suffixes() {
   DFA_ptr result_dfa = dfaBuild(statuses);
   //delete[] indices;
   delete[] statuses;
-  suffixes_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables);
+  suffixes_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables, true);
   dfaFree(result_dfa); result_dfa = nullptr;
 
   while (number_of_extra_bits_needed > 0) {
@@ -1790,7 +1891,7 @@ StringAutomaton_ptr StringAutomaton::SuffixesFromTo(int start, int end) {
   DFA_ptr result_dfa = dfaBuild(statuses);
   //delete[] indices;
   delete[] statuses;
-  suffixes_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables);
+  suffixes_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables, true);
   dfaFree(result_dfa); result_dfa = nullptr;
   for ( int i = 0; i < number_of_extra_bits_needed; ++i) {
     suffixes_auto->ProjectAway((unsigned)(suffixes_auto->num_of_bdd_variables_ - 1));
@@ -1803,6 +1904,7 @@ StringAutomaton_ptr StringAutomaton::SuffixesFromTo(int start, int end) {
 StringAutomaton_ptr StringAutomaton::Prefixes() {
 	CHECK_EQ(this->num_tracks_,1);
   StringAutomaton_ptr prefix_auto = this->clone();
+  prefix_auto->MakeDFAUnique();
   int sink_state = prefix_auto->GetSinkState();
 
 
@@ -1879,83 +1981,21 @@ StringAutomaton_ptr StringAutomaton::CharAt(const int index) {
     return charat_auto;
   }
 
-  // if number of variables are too large for mona, implement an algorithm that find suffixes by finding
-  // sub suffixes and union them
-  const int number_of_variables = this->num_of_bdd_variables_ + std::ceil(std::log2(max)), // number of variables required
-          sink_state = this->GetSinkState();
-  int* indices = GetBddVariableIndices(number_of_variables);
-
-  unsigned extra_bits_value = 0;
-
-  const int number_of_extra_bits_needed = number_of_variables - this->num_of_bdd_variables_;
-
-  std::vector<char>* current_exception = nullptr;
-  std::set<std::vector<char>*> exceptions;
-
-  paths state_paths = nullptr, pp = nullptr;
-  trace_descr tp = nullptr;
+  // chars that leave a state at the index to a state other than the sink
+  const int sink_state = this->GetSinkState();
+  std::vector<CharRange> char_ranges;
   for (int s : states_at_index) {
-    state_paths = pp = make_paths(this->dfa_->bddm, this->dfa_->q[s]);
-    while (pp) {
-      if (pp->to != (unsigned)sink_state) {
-        current_exception = new std::vector<char>();
-        for (int j = 0; j < this->num_of_bdd_variables_; j++) {
-          for (tp = pp->trace; tp && (tp->index != (unsigned)indices[j]); tp = tp->next);
-          if (tp) {
-            if (tp->value) {
-              current_exception->push_back('1');
-            } else {
-              current_exception->push_back('0');
-            }
-          } else {
-            current_exception->push_back('X');
-          }
-        }
-
-        auto extra_bit_binary_format = GetBinaryFormat(extra_bits_value, number_of_extra_bits_needed);
-        for (int i = 0; i < number_of_extra_bits_needed; i++) {
-          current_exception->push_back(extra_bit_binary_format[i]); // collected transition
-        }
-        current_exception->push_back('\0');
-        exceptions.insert(current_exception);
-        current_exception = nullptr;
+    for (auto& range : GetCharRanges(s)) {
+      if (range.next_state != sink_state) {
+        char_ranges.push_back(range);
       }
-      tp = nullptr;
-      pp = pp->next;
     }
-    ++extra_bits_value;
-    kill_paths(state_paths);
-    state_paths = pp = nullptr;
-  }
-
-  char statuses[3] = {'-', '+', '-'};
-  dfaSetup(3, number_of_variables, indices);
-  // 0 -> 1
-  dfaAllocExceptions(exceptions.size());
-  for (auto it = exceptions.begin(); it != exceptions.end();) {
-    auto ex = *it;
-    dfaStoreException(1, &(*ex->begin()));
-    it = exceptions.erase(it);
-    delete ex;
   }
-  dfaStoreState(2); // 0 -> 2
-
-  dfaAllocExceptions(0);
-  dfaStoreState(2); // 1 -> 2
 
-  dfaAllocExceptions(0);
-  dfaStoreState(2); // 2 -> 2
-
-  DFA_ptr result_dfa = dfaBuild(statuses);
-  //delete[] indices;
-  auto charat_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables);
+  DFA_ptr result_dfa = StringAutomaton::MakeCharRangesDfa(char_ranges, this->num_of_bdd_variables_);
+  auto charat_auto = new StringAutomaton(dfaMinimize(result_dfa), this->num_of_bdd_variables_, true);
   dfaFree(result_dfa); result_dfa = nullptr;
 
-  for ( int i = 0; i < number_of_extra_bits_needed; ++i) {
-    charat_auto->ProjectAway((unsigned)(charat_auto->num_of_bdd_variables_ - 1));
-    charat_auto->Minimize();
-  }
-
   DVLOG(VLOG_LEVEL) << charat_auto->id_ << " = [" << this->id_ << "]->CharAt(" << index << ")";
   return charat_auto;
 }
@@ -1969,10 +2009,10 @@ StringAutomaton_ptr StringAutomaton::CharAt(IntAutomaton_ptr index_auto) {
   }
 
   StringAutomaton_ptr prefixes_auto = this->Prefixes();
-  StringAutomaton_ptr string_length_auto = new StringAutomaton(index_auto->getDFA(),index_auto->get_number_of_bdd_variables());
+  StringAutomaton_ptr string_length_auto = new StringAutomaton(nullptr,index_auto->get_number_of_bdd_variables());
+  string_length_auto->ShareDFA(*index_auto);
   StringAutomaton_ptr any_char_auto = StringAutomaton::MakeAnyChar();
   StringAutomaton_ptr tmp_length_auto = string_length_auto->Concat(any_char_auto);
-  string_length_auto->dfa_ = nullptr; //TODO avoid this in the future by better using unary auto instead of int auto
   delete string_length_auto;
   delete any_char_auto;
   StringAutomaton_ptr charat_indexes_auto = prefixes_auto->Intersect(tmp_length_auto);
@@ -1981,38 +2021,19 @@ StringAutomaton_ptr StringAutomaton::CharAt(IntAutomaton_ptr index_auto) {
 
   const int number_of_variables = charat_indexes_auto->num_of_bdd_variables_;
 
-  std::set<std::string> exceptions;
+  // chars that lead to an accepting state
+  std::vector<CharRange> char_ranges;
   for (int s = 0; s < charat_indexes_auto->dfa_->ns; ++s) {
-    for (int next : charat_indexes_auto->getNextStates(s)) {
-      if (charat_indexes_auto->IsAcceptingState(next)) {
-        // extract transitions
-        auto transitions = Automaton::DFAGetTransitionsFromTo(charat_indexes_auto->dfa_, s, next, number_of_variables);
-        exceptions.insert(transitions.begin(), transitions.end());
+    for (auto& range : charat_indexes_auto->GetCharRanges(s)) {
+      if (charat_indexes_auto->IsAcceptingState(range.next_state)) {
+        char_ranges.push_back(range);
       }
     }
   }
+  delete charat_indexes_auto;
 
-  const int number_of_exceptions = exceptions.size();
-  dfaSetup(3, number_of_variables, GetBddVariableIndices(number_of_variables));
-  char statuses[3] { '-', '+', '-' };
-  //state 0
-  dfaAllocExceptions(number_of_exceptions);
-  for (std::string exception : exceptions) {
-    dfaStoreException(1, &exception[0]);
-  }
-  dfaStoreState(2);
-
-  //state 1
-  dfaAllocExceptions(0);
-  dfaStoreState(2);
-
-  //state 2
-  dfaAllocExceptions(0);
-  dfaStoreState(2);
-
-  DFA_ptr result_dfa = dfaBuild(statuses);
-
-  StringAutomaton_ptr charat_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables);
+  DFA_ptr result_dfa = StringAutomaton::MakeCharRangesDfa(char_ranges, number_of_variables);
+  StringAutomaton_ptr charat_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables, true);
   dfaFree(result_dfa); result_dfa = nullptr;
 
 
@@ -2537,7 +2558,7 @@ StringAutomaton_ptr StringAutomaton::ToUpperCase() {
   DFA_ptr temp_dfa = Automaton::DFAProjectAway(upper_case_dfa,var);
   dfaFree(upper_case_dfa);
 
-  upper_case_auto = new StringAutomaton(temp_dfa,var);
+  upper_case_auto = new StringAutomaton(temp_dfa,var,true);
 
 
   DVLOG(VLOG_LEVEL) << upper_case_auto->id_ << " = [" << this->id_ << "]->toUpperCase()";
@@ -2561,7 +2582,7 @@ StringAutomaton_ptr StringAutomaton::ToLowerCase() {
 
 	DFA_ptr temp_dfa = Automaton::DFAProjectAway(lower_case_dfa,var);
 	dfaFree(lower_case_dfa);
-	lower_case_auto = new StringAutomaton(temp_dfa, var);
+	lower_case_auto = new StringAutomaton(temp_dfa, var, true);
 
   DVLOG(VLOG_LEVEL) << lower_case_auto->id_ << " = [" << this->id_ << "]->toLowerCase()";
 
@@ -2611,7 +2632,7 @@ StringAutomaton_ptr StringAutomaton::Replace(StringAutomaton_ptr search_auto,
   result_dfa = Automaton::DFAProjectAway(temp_dfa,var);
   dfaFree(temp_dfa);
 
-  result_auto = new StringAutomaton(result_dfa, var);
+  result_auto = new StringAutomaton(result_dfa, var, true);
   DVLOG(VLOG_LEVEL) << result_auto->id_ << " = [" << this->id_ << "]->replace(" << search_auto->id_ << ", " << replace_auto->id_ << ")";
   return result_auto;
 }
@@ -2873,10 +2894,10 @@ StringAutomaton_ptr StringAutomaton::RestrictLengthTo(int length) {
 StringAutomaton_ptr StringAutomaton::RestrictLengthTo(IntAutomaton_ptr length_auto) {
 	CHECK_EQ(this->num_tracks_,1);
   StringAutomaton_ptr restricted_auto = nullptr;
-  StringAutomaton_ptr length_string_auto = new StringAutomaton(length_auto->getDFA(),length_auto->get_number_of_bdd_variables());
+  StringAutomaton_ptr length_string_auto = new StringAutomaton(nullptr,length_auto->get_number_of_bdd_variables());
+  length_string_auto->ShareDFA(*length_auto);
 
   restricted_auto = this->Intersect(length_string_auto);
-  length_string_auto->dfa_ = nullptr;
   delete length_string_auto; length_string_auto = nullptr;
   DVLOG(VLOG_LEVEL) << restricted_auto->id_ << " = [" << this->id_ << "]->restrictLengthTo(" << length_auto->getId() << ")";
 
@@ -2903,7 +2924,8 @@ StringAutomaton_ptr StringAutomaton::RestrictIndexOfTo(IntAutomaton_ptr index_au
 
   bool has_negative_1 = index_auto->hasNegative1();
 
-  StringAutomaton_ptr length_string_auto = new StringAutomaton(index_auto->getDFA(),index_auto->get_number_of_bdd_variables());
+  StringAutomaton_ptr length_string_auto = new StringAutomaton(nullptr,index_auto->get_number_of_bdd_variables());
+  length_string_auto->ShareDFA(*index_auto);
 //  UnaryAutomaton_ptr unary_auto = index_auto->toUnaryAutomaton();
 //	StringAutomaton_ptr length_string_auto = unary_auto->toStringAutomaton();
 //	delete unary_auto;
@@ -2916,7 +2938,6 @@ StringAutomaton_ptr StringAutomaton::RestrictIndexOfTo(IntAutomaton_ptr index_au
 
   not_contains_length_auto = length_string_auto->Difference(contains_auto);
   delete contains_auto; contains_auto = nullptr;
-  length_string_auto->dfa_ = nullptr;
   delete length_string_auto; length_string_auto = nullptr;
 
   tmp_auto_1 = not_contains_length_auto->Concat(search_auto);
@@ -3070,7 +3091,8 @@ StringAutomaton_ptr StringAutomaton::RestrictLastIndexOfTo(
   StringAutomaton_ptr restricted_auto = nullptr, contains_auto = nullptr,
           not_contains_auto = nullptr, not_contains_subject_auto = nullptr,
           tmp_auto_1 = nullptr, tmp_auto_2 = nullptr;
-  StringAutomaton_ptr length_string_auto = new StringAutomaton(index_auto->getDFA(),index_auto->get_number_of_bdd_variables());
+  StringAutomaton_ptr length_string_auto = new StringAutomaton(nullptr,index_auto->get_number_of_bdd_variables());
+  length_string_auto->ShareDFA(*index_auto);
   //UnaryAutomaton_ptr unary_auto = index_auto->toUnaryAutomaton();
 	//StringAutomaton_ptr length_string_auto = unary_auto->toStringAutomaton();
 	//delete unary_auto;
@@ -3087,7 +3109,6 @@ StringAutomaton_ptr StringAutomaton::RestrictLastIndexOfTo(
 
   tmp_auto_1 = length_string_auto->Concat(search_auto);
   tmp_auto_2 = tmp_auto_1->Concat(not_contains_auto);
-  length_string_auto->dfa_ = nullptr;
   delete length_string_auto; length_string_auto = nullptr;
   delete tmp_auto_1; tmp_auto_1 = nullptr;
   delete not_contains_auto; not_contains_auto = nullptr;
@@ -3153,13 +3174,13 @@ StringAutomaton_ptr StringAutomaton::RestrictFromIndexToEndTo(
 		IntAutomaton_ptr index_auto, StringAutomaton_ptr sub_string_auto) {
 	CHECK_EQ(this->num_tracks_,1);
   StringAutomaton_ptr restricted_auto = nullptr, tmp_auto_1 = nullptr, tmp_auto_2;
-  StringAutomaton_ptr length_string_auto = new StringAutomaton(index_auto->getDFA(),index_auto->get_number_of_bdd_variables());
+  StringAutomaton_ptr length_string_auto = new StringAutomaton(nullptr,index_auto->get_number_of_bdd_variables());
+  length_string_auto->ShareDFA(*index_auto);
 //  UnaryAutomaton_ptr unary_auto = index_auto->toUnaryAutomaton();
 //	StringAutomaton_ptr length_string_auto = unary_auto->toStringAutomaton();
 //	delete unary_auto;
 
   tmp_auto_1 = length_string_auto->Concat(sub_string_auto);
-  length_string_auto->dfa_ = nullptr;
   delete length_string_auto; length_string_auto = nullptr;
 
   restricted_auto = this->Intersect(tmp_auto_1);
@@ -3270,7 +3291,7 @@ StringAutomaton_ptr StringAutomaton::PreToUpperCase(StringAutomaton_ptr rangeAut
 	dfaFree(result_dfa);
 
 
-  result_auto = new StringAutomaton(temp_dfa,var);
+  result_auto = new StringAutomaton(temp_dfa,var,true);
 
   if (rangeAuto not_eq nullptr) {
     StringAutomaton_ptr tmp_auto = result_auto;
@@ -3299,7 +3320,7 @@ StringAutomaton_ptr StringAutomaton::PreToLowerCase(StringAutomaton_ptr rangeAut
 	DFA_ptr temp_dfa = Automaton::DFAProjectAway(result_dfa,var);
 	dfaFree(result_dfa);
 
-  result_auto = new StringAutomaton(temp_dfa,var);
+  result_auto = new StringAutomaton(temp_dfa,var,true);
 
   if (rangeAuto not_eq nullptr) {
     StringAutomaton_ptr tmp_auto = result_auto;
@@ -3528,8 +3549,15 @@ StringAutomaton_ptr StringAutomaton::ProjectKTrack(int k_track) {
   	indices.push_back(k_track+num_tracks_*i);
   }
 
-  auto result_dfa = Automaton::DFAProjectAway(dfa_,_map,indices);
-  auto result_auto = new StringAutomaton(result_dfa,num_tracks_-1,(num_tracks_-1)*VAR_PER_TRACK);
+  std::vector<int> parameters {(int)_map.size()};
+  parameters.insert(parameters.end(), _map.begin(), _map.end());
+  parameters.insert(parameters.end(), indices.begin(), indices.end());
+  auto result_dfa = GetOrComputeDFA(OperationCache::Operation::PROJECT_AWAY_AND_REMAP, {this}, parameters,
+      [this, &_map, &indices]() {
+    return Automaton::DFAProjectAway(dfa_,_map,indices);
+  });
+  auto result_auto = new StringAutomaton(nullptr,num_tracks_-1,(num_tracks_-1)*VAR_PER_TRACK);
+  result_auto->ShareDFA(result_dfa, true);
   if(formula_ != nullptr) {
   	result_auto->SetFormula(formula_->clone());
   }
@@ -3665,51 +3693,13 @@ std::map<std::string,std::vector<std::string>> StringAutomaton::GetModelsWithinB
 		bound = counter.GetMinBound(num_models);
 	}
 
-  // compute BFS for unweighted graph (dfa)
-  std::queue<int> states_to_process;
-  std::vector<int> distances(this->dfa_->ns,INT_MAX);
-  std::set<int> final_states;
-
-  std::vector<int> shortest_accepting_path(this->dfa_->ns,INT_MAX);
-  for(int start_state = 0; start_state < this->dfa_->ns; start_state++) {
-  	distances[start_state] = 0;
-		states_to_process.push(start_state);
-
-		while(not states_to_process.empty()) {
-			int s = states_to_process.front();
-			states_to_process.pop();
-			// mark final states for later
-			if(this->dfa_->f[s] == 1) {
-				final_states.insert(s);
-			}
-
-			for(auto iter : getNextStates(s)) {
-				if(distances[iter] == INT_MAX) {
-					states_to_process.push(iter);
-					distances[iter] = distances[s] + 1;
-				}
-			}
-		}
-
-		int shortest = INT_MAX;
-		for(auto final : final_states) {
-			distances[final]--; // account for lambda/lambda transition
-			if(distances[final] < shortest) {
-				shortest = distances[final];
-			}
-		}
-		shortest_accepting_path[start_state] = shortest;
-
-
-		distances = std::vector<int>(this->dfa_->ns,INT_MAX);
+  std::vector<int> shortest_accepting_path = GetMetadata().distance_to_accepting;
+  for (auto& distance : shortest_accepting_path) {
+    if (distance != INT_MAX) {
+      distance--; // account for lambda/lambda transition
+    }
   }
 
-//  for(int i = 0; i < this->dfa_->ns; i++) {
-//  	LOG(INFO) << "shortest path for state " << i << " = " << shortest_accepting_path[i];
-//  }
-//
-  //LOG(INFO) << "Done computing shortest paths to final state";
-
   // assume num_tracks > 1; Otherwise, juse call normal version
   int models_so_far = 0;
   int num_tracks = this->num_tracks_;
@@ -4035,11 +4025,14 @@ bool StringAutomaton::IsAcceptingSingleString() {
   return isAcceptingSingleWord();
 }
 
+/**
+ * Follows char ranges that decrease the distance to an accepting state; among those, the char with the most leading
+ * bits in common with a readable ascii char is taken at each step
+ */
 std::string StringAutomaton::GetAnAcceptingString() {
   CHECK_EQ(this->num_tracks_,1);
-  std::stringstream ss;
 
-  auto readable_ascii_heuristic = [](unsigned& index) -> bool {
+  auto readable_ascii_heuristic = [](unsigned index) -> bool {
     switch (index) {
       case 1:
       case 2:
@@ -4049,31 +4042,65 @@ std::string StringAutomaton::GetAnAcceptingString() {
         return false;
     }
   };
-  std::vector<bool>* example = getAnAcceptingWord(readable_ascii_heuristic);
+  unsigned preferred_char = 0;
+  for (int i = 0; i < num_of_bdd_variables_; ++i) {
+    preferred_char = (preferred_char << 1) | readable_ascii_heuristic(i);
+  }
+
+  const Metadata& metadata = GetMetadata();
+  int state = this->dfa_->s;
+  CHECK_NE(INT_MAX, metadata.distance_to_accepting[state]) << "automaton does not accept any string";
+
+  std::string model;
+  while (metadata.distance_to_accepting[state] > 0) {
+    int next_state = -1;
+    unsigned next_char = 0;
+    for (auto& range : GetCharRanges(state)) {
+      if (metadata.distance_to_accepting[range.next_state] == metadata.distance_to_accepting[state] - 1) {
+        const unsigned c = GetClosestChar(range, preferred_char, num_of_bdd_variables_);
+        if (next_state == -1 or (c ^ preferred_char) < (next_char ^ preferred_char)) {
+          next_state = range.next_state;
+          next_char = c;
+        }
+      }
+    }
+    model.push_back((unsigned char)next_char);
+    state = next_state;
+  }
+  return model;
+}
 
-  unsigned char c = 0;
-  unsigned bit_range = num_of_bdd_variables_ - 1;
-  unsigned read_count = 0;
-  for (auto bit: *example) {
-    if (bit) {
-      c |= 1;
-    } else {
-      c |= 0;
+/**
+ * A symbol is one character, bdd variable 0 is the most significant bit
+ */
+std::string StringAutomaton::DecodeWord(const std::vector<bool>& word) const {
+  CHECK_EQ(this->num_tracks_,1);
+  std::string model;
+  model.reserve(word.size() / num_of_bdd_variables_);
+  for (std::size_t i = 0; i < word.size(); i += num_of_bdd_variables_) {
+    unsigned char c = 0;
+    for (int b = 0; b < num_of_bdd_variables_; ++b) {
+      c = (c << 1) | word[i + b];
     }
+    model.push_back(c);
+  }
+  return model;
+}
 
-    if (read_count < (bit_range)) {
-      c <<= 1;
+bool StringAutomaton::EncodeWord(const std::string& model, const unsigned long number_of_symbols, std::vector<bool>& word) const {
+  CHECK_EQ(this->num_tracks_,1);
+  word.clear();
+  word.reserve(model.size() * num_of_bdd_variables_);
+  for (unsigned char c : model) {
+    if (num_of_bdd_variables_ < 8 and (c >> num_of_bdd_variables_) != 0) {
+      DVLOG(VLOG_LEVEL) << "model has a character outside of the alphabet: " << model;
+      return false;
     }
-    if (read_count == bit_range) {
-      ss << c;
-      c = 0;
-      read_count = 0;
-    } else {
-      read_count++;
+    for (int b = num_of_bdd_variables_ - 1; b >= 0; --b) {
+      word.push_back((c >> b) & 1);
     }
   }
-  delete example;
-  return ss.str();
+  return true;
 }
 
 std::string StringAutomaton::GetAnAcceptingStringRandom() {
@@ -4130,8 +4157,9 @@ const StringAutomaton::TransitionVector& StringAutomaton::GenerateTransitionsFor
   bits_per_var--;
   // check table for precomputed value first
   std::pair<int,StringFormula::Type> key(bits_per_var,type);
-  if(TRANSITION_TABLE.find(key) != TRANSITION_TABLE.end()) {
-    return TRANSITION_TABLE[key];
+  auto it = TRANSITION_TABLE.find(key);
+  if(it != TRANSITION_TABLE.end()) {
+    return it->second;
   }
 
   // not previously computed; compute now and cache for later.
@@ -4169,47 +4197,60 @@ const StringAutomaton::TransitionVector& StringAutomaton::GenerateTransitionsFor
       break;
   }
 
-  std::vector<std::map<std::string,int>> states(3, std::map<std::string, int>());
-  states[0]["00"] = 0;
-  states[0]["01"] = 1;
-  states[0]["10"] = 2;
-  states[0]["11"] = 0;
-
-  states[1]["XX"] = 1;
-  states[2]["XX"] = 2;
+  // relation state transitions on a pair of bits: from eq, bits decide the order; lt and gt are absorbing
+  struct RelationTransition {
+    char left_bit;
+    char right_bit;
+    int next_state;
+  };
+  static const RelationTransition relation_transitions[3][4] = {
+    { {'0', '0', 0}, {'0', '1', 1}, {'1', '0', 2}, {'1', '1', 0} },
+    { {'X', 'X', 1} },
+    { {'X', 'X', 2} }
+  };
+  static const int number_of_relation_transitions[3] = {4, 1, 1};
 
+  // depth first over the bit positions, patterns are written in place and copied out at accepting leaves.
+  // The last bit stays '0', the lambda bit for multitrack lambda.
+  CHECK_GE(bits_per_var, 0);
   TransitionVector good_trans;
-  std::queue<std::pair<int,std::pair<std::string,std::string>>> next;
-  next.push(std::make_pair(0,std::make_pair("","")));
-
-  while(!next.empty()) {
-    std::pair<int,std::pair<std::string,std::string>> curr = next.front();
-    if(curr.second.first.size() >= bits_per_var) {
-      if(final_states[curr.first]) {
-        // append lambda bit for multitrack lambda
-        curr.second.first += '0';
-        curr.second.second += '0';
-        good_trans.push_back(curr.second);
+  std::string left_pattern (bits_per_var + 1, '0'), right_pattern (bits_per_var + 1, '0');
+  std::vector<int> path_states (bits_per_var + 1, 0), next_transitions (bits_per_var + 1, 0);
+  int depth = 0;
+  while (depth >= 0) {
+    const int current_state = path_states[depth];
+    if (depth == bits_per_var) {
+      if (final_states[current_state]) {
+        good_trans.push_back(std::make_pair(left_pattern, right_pattern));
       }
+      --depth;
+    } else if (next_transitions[depth] == number_of_relation_transitions[current_state]) {
+      --depth;
     } else {
-      for(auto& t : states[curr.first]) {
-        next.push(std::make_pair(
-            t.second,
-            std::make_pair(
-                curr.second.first + std::string(1,t.first[0]),
-                curr.second.second + std::string(1,t.first[1]))));
-      }
+      const RelationTransition& transition = relation_transitions[current_state][next_transitions[depth]];
+      ++next_transitions[depth];
+      left_pattern[depth] = transition.left_bit;
+      right_pattern[depth] = transition.right_bit;
+      ++depth;
+      path_states[depth] = transition.next_state;
+      next_transitions[depth] = 0;
     }
-    next.pop();
   }
 
   // cache the transitions for later
-  TRANSITION_TABLE[key] = good_trans;
-
-  return TRANSITION_TABLE[key];
+  return TRANSITION_TABLE[key] = std::move(good_trans);
 }
 
 DFA_ptr StringAutomaton::MakeBinaryRelationDfa(StringFormula::Type type, int bits_per_var, int num_tracks, int left_track, int right_track) {
+  auto relation_dfa = FactoryCache::Instance().GetOrMake(FactoryCache::Factory::BINARY_RELATION,
+      {static_cast<int>(type), bits_per_var, num_tracks, left_track, right_track},
+      [type, bits_per_var, num_tracks, left_track, right_track]() {
+    return StringAutomaton::BuildBinaryRelationDfa(type, bits_per_var, num_tracks, left_track, right_track);
+  });
+  return dfaCopy(relation_dfa.get());
+}
+
+DFA_ptr StringAutomaton::BuildBinaryRelationDfa(StringFormula::Type type, int bits_per_var, int num_tracks, int left_track, int right_track) {
   DFA_ptr temp_dfa = nullptr, result_dfa = nullptr, aligned_dfa = nullptr;
   int var = bits_per_var;
   int len = num_tracks * var;
@@ -4342,6 +4383,14 @@ DFA_ptr StringAutomaton::MakeBinaryRelationDfa(StringFormula::Type type, int bit
 }
 
 DFA_ptr StringAutomaton::MakeBinaryAlignedDfa(int left_track, int right_track, int num_tracks) {
+  auto aligned_dfa = FactoryCache::Instance().GetOrMake(FactoryCache::Factory::BINARY_ALIGNED,
+      {left_track, right_track, num_tracks}, [left_track, right_track, num_tracks]() {
+    return StringAutomaton::BuildBinaryAlignedDfa(left_track, right_track, num_tracks);
+  });
+  return dfaCopy(aligned_dfa.get());
+}
+
+DFA_ptr StringAutomaton::BuildBinaryAlignedDfa(int left_track, int right_track, int num_tracks) {
   DFA_ptr temp_dfa = nullptr, result_dfa = nullptr;
   TransitionVector tv;
   int init = 0,lambda_star = 1, lambda_lambda = 2,
@@ -5386,6 +5435,7 @@ DFA_ptr StringAutomaton::TrimLambdaPrefix(DFA_ptr dfa, int var, bool project_bit
   for(int i = 0; i < reachable.size(); i++) {
     state_paths = pp = make_paths(dfa->bddm, dfa->q[reachable[i]]);
     std::vector<char> exep(var,'X');
+    std::vector<char> extra_bit_value = GetBinaryFormat(i, num_bits); // i = current state
     while(pp) {
       if(pp->to == sink) {
         pp = pp->next;
@@ -5405,7 +5455,6 @@ DFA_ptr StringAutomaton::TrimLambdaPrefix(DFA_ptr dfa, int var, bool project_bit
       }
 
       if (!IsExepEqualChar(exep, lambda_vec,var)) {
-        std::vector<char> extra_bit_value = GetBinaryFormat(i, num_bits); // i = current state
         std::vector<char> v = exep;
         v.insert(v.end(), extra_bit_value.begin(), extra_bit_value.end());
         state_exeps.push_back(std::make_pair(v, pp->to + 1));
@@ -5665,6 +5714,224 @@ DFA_ptr StringAutomaton::PreConcatSuffix(DFA_ptr concat_dfa, DFA_ptr prefix_dfa,
   return TrimPrefix(concat_dfa,prefix_dfa,var);
 }
 
+bool StringAutomaton::IsAcceptingString(const std::string& value) const {
+  CHECK_EQ(this->num_tracks_,1);
+  int state = this->dfa_->s;
+  for (unsigned char c : value) {
+    state = GetNextStateForChar(state, c);
+  }
+  return this->dfa_->f[state] == 1;
+}
+
+bool StringAutomaton::UsesCharRanges() const {
+  // single track automata with extra bits, e.g., suffixes with state bits, walk the bdds
+  return this->num_tracks_ == 1 and this->num_of_bdd_variables_ <= MAX_CHAR_RANGE_BITS;
+}
+
+/**
+ * Narrows down an aligned block of chars bit by bit, takes the half with the preferred bit if it meets the range
+ */
+unsigned StringAutomaton::GetClosestChar(const CharRange& range, const unsigned preferred_char, const int number_of_bdd_variables) {
+  unsigned c = 0;
+  for (int b = number_of_bdd_variables - 1; b >= 0; --b) {
+    const unsigned bit = 1u << b;
+    const unsigned low = c | (preferred_char & bit);
+    const unsigned high = low | (bit - 1);
+    if (high < range.first or low > range.last) {
+      c |= (~preferred_char & bit);
+    } else {
+      c = low;
+    }
+  }
+  return c;
+}
+
+/**
+ * Ranges may overlap, they are merged first
+ */
+DFA_ptr StringAutomaton::MakeCharRangesDfa(std::vector<CharRange> ranges, const int number_of_bdd_variables) {
+  std::sort(ranges.begin(), ranges.end(), [](const CharRange& left, const CharRange& right) {
+    return left.first < right.first;
+  });
+  std::vector<CharRange> merged_ranges;
+  for (auto& range : ranges) {
+    if (not merged_ranges.empty() and (unsigned long)range.first <= (unsigned long)merged_ranges.back().last + 1) {
+      merged_ranges.back().last = std::max(merged_ranges.back().last, range.last);
+    } else {
+      merged_ranges.push_back({range.first, range.last, 1});
+    }
+  }
+
+  // state 0 reads one char into accepting state 1, anything else goes to the sink
+  return Automaton::DFAMakeFromCharRanges({merged_ranges, {}}, {false, true}, number_of_bdd_variables);
+}
+
+/**
+ * A state of the result is a set of (state, repetition) pairs of the operand. A set is kept as a pattern, i.e., the
+ * pairs with repetitions relative to the smallest one, and a counter for the smallest repetition. Transitions of a
+ * pattern are computed once and reused for every counter below the bound, so that large bounds only add states.
+ * A new repetition starts after each char that reaches an accepting state; empty repetitions are not counted, they can
+ * only lower the minimum to zero.
+ */
+DFA_ptr StringAutomaton::DFARepeat(const unsigned long min, const unsigned long max, const bool is_bounded) const {
+  using Pattern = std::vector<std::pair<int, unsigned long>>;
+  struct PatternTransition {
+    unsigned first;
+    unsigned last;
+    int pattern;
+    unsigned long delta;
+  };
+
+  const int initial_state = dfa_->s;
+  const int sink_state = this->GetSinkState();
+  const unsigned long effective_min = (dfa_->f[initial_state] == 1) ? 0 : min;
+  // counters above the cap behave the same
+  const unsigned long cap = is_bounded ? max : std::max(effective_min, 1ul);
+  CHECK_GT(cap, 0);
+
+  std::vector<Pattern> patterns;
+  std::vector<unsigned long> pattern_widths;
+  std::map<Pattern, int> pattern_ids;
+  std::map<int, std::vector<PatternTransition>> pattern_transitions;
+  std::vector<std::pair<int, unsigned long>> states;
+  std::map<std::pair<int, unsigned long>, int> state_ids;
+
+  // takes the pairs, sorted by state, and gives the pattern and the counter
+  auto get_state_id = [&](const Pattern& pairs) {
+    unsigned long counter = pairs.front().second;
+    for (auto& pair : pairs) {
+      counter = std::min(counter, pair.second);
+    }
+    Pattern pattern = pairs;
+    unsigned long width = 0;
+    for (auto& pair : pattern) {
+      pair.second -= counter;
+      width = std::max(width, pair.second);
+    }
+    int pattern_id = -1;
+    auto pattern_it = pattern_ids.find(pattern);
+    if (pattern_it == pattern_ids.end()) {
+      pattern_id = patterns.size();
+      pattern_ids[pattern] = pattern_id;
+      patterns.push_back(std::move(pattern));
+      pattern_widths.push_back(width);
+    } else {
+      pattern_id = pattern_it->second;
+    }
+
+    const std::pair<int, unsigned long> state {pattern_id, counter};
+    auto state_it = state_ids.find(state);
+    if (state_it != state_ids.end()) {
+      return state_it->second;
+    }
+    const int state_id = states.size();
+    state_ids[state] = state_id;
+    states.push_back(state);
+    return state_id;
+  };
+
+  auto compute_transitions = [&](const int pattern_id, const unsigned long counter) {
+    // copied, new patterns are added while the transitions are computed
+    const Pattern pattern = patterns[pattern_id];
+    std::vector<unsigned long> bounds;
+    for (auto& pair : pattern) {
+      for (auto& range : this->GetCharRanges(pair.first)) {
+        if (range.next_state != sink_state) {
+          bounds.push_back(range.first);
+          bounds.push_back((unsigned long)range.last + 1);
+        }
+      }
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    std::vector<PatternTransition> transitions;
+    Pattern pairs;
+    for (std::size_t i = 0; i + 1 < bounds.size(); ++i) {
+      pairs.clear();
+      for (auto& pair : pattern) {
+        const int next_state = this->GetNextStateForChar(pair.first, bounds[i]);
+        if (next_state == sink_state) {
+          continue;
+        }
+        const unsigned long repetition = counter + pair.second;
+        pairs.push_back(std::make_pair(next_state, repetition));
+        if (dfa_->f[next_state] == 1 and (repetition < cap or not is_bounded)) {
+          pairs.push_back(std::make_pair(initial_state, std::min(repetition + 1, cap)));
+        }
+      }
+      if (pairs.empty()) {
+        continue;
+      }
+      std::sort(pairs.begin(), pairs.end());
+      pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+      const int target_id = get_state_id(pairs);
+      const int target_pattern = states[target_id].first;
+      const unsigned long delta = states[target_id].second - counter;
+      const unsigned last = bounds[i + 1] - 1;
+      if (not transitions.empty() and transitions.back().pattern == target_pattern and transitions.back().delta == delta
+          and (unsigned long)transitions.back().last + 1 == bounds[i]) {
+        transitions.back().last = last;
+      } else {
+        transitions.push_back({(unsigned)bounds[i], last, target_pattern, delta});
+      }
+    }
+    return transitions;
+  };
+
+  std::vector<std::vector<CharRange>> transitions;
+  std::vector<bool> is_accepting;
+  // the initial state is not shared, revisiting the initial state of the operand in the first repetition is not the
+  // same as reading the empty string
+  get_state_id({std::make_pair(initial_state, 1ul)});
+  state_ids.clear();
+  for (std::size_t id = 0; id < states.size(); ++id) {
+    const int pattern_id = states[id].first;
+    const unsigned long counter = states[id].second;
+
+    bool accepting = (id == 0 and effective_min == 0);
+    for (auto& pair : patterns[pattern_id]) {
+      accepting = accepting or (dfa_->f[pair.first] == 1 and counter + pair.second >= effective_min);
+    }
+    is_accepting.push_back(accepting);
+
+    // below the cap transitions do not depend on the counter
+    std::vector<PatternTransition> computed_transitions;
+    const std::vector<PatternTransition>* current_transitions = nullptr;
+    if (counter + pattern_widths[pattern_id] < cap) {
+      auto it = pattern_transitions.find(pattern_id);
+      if (it == pattern_transitions.end()) {
+        it = pattern_transitions.insert(std::make_pair(pattern_id, compute_transitions(pattern_id, counter))).first;
+      }
+      current_transitions = &it->second;
+    } else {
+      computed_transitions = compute_transitions(pattern_id, counter);
+      current_transitions = &computed_transitions;
+    }
+
+    std::vector<CharRange> ranges;
+    for (auto& transition : *current_transitions) {
+      const std::pair<int, unsigned long> target {transition.pattern, counter + transition.delta};
+      auto state_it = state_ids.find(target);
+      int next_state = -1;
+      if (state_it == state_ids.end()) {
+        next_state = states.size();
+        state_ids[target] = next_state;
+        states.push_back(target);
+      } else {
+        next_state = state_it->second;
+      }
+      ranges.push_back({transition.first, transition.last, next_state});
+    }
+    transitions.push_back(std::move(ranges));
+  }
+
+  DVLOG(VLOG_LEVEL) << "repeat(" << min << ", " << (is_bounded ? std::to_string(max) : "inf") << ") of " << id_
+                    << " has " << states.size() << " states from " << patterns.size() << " patterns";
+  return Automaton::DFAMakeFromCharRanges(transitions, is_accepting, num_of_bdd_variables_);
+}
+
 bool StringAutomaton::HasExceptionToValidStateFrom(int state, std::vector<char>& exception) {
 	int sink_state = this->GetSinkState();
 	return (sink_state != this->getNextState(state, exception));
@@ -5687,6 +5954,7 @@ std::vector<int> StringAutomaton::GetAcceptingStates() {
 StringAutomaton_ptr StringAutomaton::IndexOfHelper(StringAutomaton_ptr search_auto) {
 	StringAutomaton_ptr index_of_auto = nullptr;
 	index_of_auto = this->Search(search_auto);
+	index_of_auto->MakeDFAUnique();
 	int sink_state = index_of_auto->GetSinkState();
 	int current_state = -1;
 	int next_state = -1;
@@ -5737,6 +6005,7 @@ StringAutomaton_ptr StringAutomaton::LastIndexOfHelper(StringAutomaton_ptr searc
 	DFA_ptr lastIndexOf_dfa = nullptr, minimized_dfa = nullptr;
 
 	search_result_auto = this->Search(search_auto);
+	search_result_auto->MakeDFAUnique();
 
 	Graph_ptr graph = search_result_auto->toGraph();
 	// Mark start state of a match
@@ -6324,7 +6593,7 @@ StringAutomaton_ptr StringAutomaton::RemoveReservedWords() {
 	result_dfa = dfaBuild(statuses);
 	//delete[] indices;
 	delete[] statuses;
-	string_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables);
+	string_auto = new StringAutomaton(dfaMinimize(result_dfa), number_of_variables, true);
 	dfaFree(result_dfa); result_dfa = nullptr;
 
 	while (number_of_extra_bits_needed > 0) {
@@ -39,10 +39,10 @@ class StringAutomaton: public Automaton {
 	using TransitionVector = std::vector<std::pair<std::string,std::string>>;
 	using TransitionTable = std::map<std::pair<int,StringFormula::Type>,TransitionVector>;
 public:
-	StringAutomaton(const DFA_ptr, const int number_of_bdd_variables);
+	StringAutomaton(const DFA_ptr, const int number_of_bdd_variables, const bool is_minimized = false);
 	StringAutomaton(const DFA_ptr, const int number_of_tracks, const int number_of_bdd_variables);
 	StringAutomaton(const DFA_ptr, const int i_track, const int number_of_tracks, const int in_num_vars);
-	StringAutomaton(const DFA_ptr, StringFormula_ptr formula, const int number_of_bdd_variables);
+	StringAutomaton(const DFA_ptr, StringFormula_ptr formula, const int number_of_bdd_variables, const bool is_minimized = false);
   StringAutomaton(const StringAutomaton&);
   virtual ~StringAutomaton();
 
@@ -190,6 +190,12 @@ public:
 
   StringAutomaton_ptr Complement();
   StringAutomaton_ptr Intersect(StringAutomaton_ptr);
+
+  /**
+   * Intersects all given automata, automata with different number of tracks are intersected one by one.
+   * Stops as soon as an intermediate result is empty.
+   */
+  static StringAutomaton_ptr Intersect(const std::vector<StringAutomaton_ptr>& automata);
   StringAutomaton_ptr Union(StringAutomaton_ptr);
   StringAutomaton_ptr Difference(StringAutomaton_ptr);
   StringAutomaton_ptr Concat(StringAutomaton_ptr);
@@ -286,8 +292,15 @@ public:
   bool HasEmptyString();
   bool IsEmptyString();
   bool IsAcceptingSingleString();
+
+  /**
+   * Membership test, reads the string over the char ranges of the states
+   */
+  bool IsAcceptingString(const std::string& value) const;
   std::string GetAnAcceptingString();
   std::string GetAnAcceptingStringRandom();
+  std::string DecodeWord(const std::vector<bool>& word) const override;
+  bool EncodeWord(const std::string& model, const unsigned long number_of_symbols, std::vector<bool>& word) const override;
 
   StringFormula_ptr GetFormula();
   void SetFormula(StringFormula_ptr formula);
@@ -315,6 +328,34 @@ public:
 	static DFA_ptr PreConcatSuffix(DFA_ptr concat_dfa, DFA_ptr prefix_dfa, int var);
 
 protected:
+  bool UsesCharRanges() const override;
+
+  /**
+   * Gets the char in the range that has the most bits in common with the preferred char, starting from the most
+   * significant bit
+   */
+  static unsigned GetClosestChar(const CharRange& range, const unsigned preferred_char, const int number_of_bdd_variables);
+
+  /**
+   * Makes a dfa that accepts the strings of length one with a char in one of the ranges, targets of the ranges are ignored
+   */
+  static DFA_ptr MakeCharRangesDfa(std::vector<CharRange> ranges, const int number_of_bdd_variables);
+
+  /**
+   * Builders of the memoized relation and alignment dfas
+   */
+  static DFA_ptr BuildBinaryRelationDfa(StringFormula::Type type, int bits_per_var, int num_tracks, int left_track, int right_track);
+  static DFA_ptr BuildBinaryAlignedDfa(int left_track, int right_track, int total_tracks);
+
+  /**
+   * Makes a dfa for min to max repetitions of this automaton, each repetition is a copy of the dfa that is tracked with
+   * a counter instead of concatenating copies
+   * @param min
+   * @param max ignored if not bounded
+   * @param is_bounded
+   */
+  DFA_ptr DFARepeat(const unsigned long min, const unsigned long max, const bool is_bounded) const;
+
   bool HasExceptionToValidStateFrom(int state, std::vector<char>& exception);
   std::vector<int> GetAcceptingStates();
 
@@ -12,14 +12,19 @@ namespace Theory {
 
 const int SymbolicCounter::VLOG_LEVEL = 9;
 
-SymbolicCounter::SymbolicCounter() : type_(SymbolicCounter::Type::STRING), bound_(0) {
+const std::size_t SymbolicCounter::DEFAULT_CACHE_SIZE = 64;
+
+SymbolicCounter::Cache::Cache() : size(DEFAULT_CACHE_SIZE), has_recurrence(false), has_scc_recurrence(false), is_scc_decomposable(false) {
+}
+
+SymbolicCounter::SymbolicCounter() : type_(SymbolicCounter::Type::STRING), bound_(0), cache_(std::make_shared<Cache>()) {
 
 }
 
 SymbolicCounter::~SymbolicCounter() {
 }
 
-SymbolicCounter::Type SymbolicCounter::type() {
+SymbolicCounter::Type SymbolicCounter::type() const {
   return type_;
 }
 
@@ -27,12 +32,13 @@ void SymbolicCounter::set_type(const Type t) {
   type_ = t;
 }
 
-unsigned long SymbolicCounter::get_bound() {
+unsigned long SymbolicCounter::get_bound() const {
   return bound_;
 }
 
 void SymbolicCounter::set_bound(const unsigned long bound) {
   bound_ = bound;
+  cache_ = std::make_shared<Cache>();
 }
 
 Eigen::SparseVector<BigInteger> SymbolicCounter::get_initialization_vector() const {
@@ -41,6 +47,7 @@ Eigen::SparseVector<BigInteger> SymbolicCounter::get_initialization_vector() con
 
 void SymbolicCounter::set_initialization_vector(const Eigen::SparseVector<BigInteger>& initialization_vector) {
   initialization_vector_ = initialization_vector;
+  cache_ = std::make_shared<Cache>();
 }
 
 Eigen::SparseMatrix<BigInteger> SymbolicCounter::get_transition_count_matrix() const {
@@ -49,122 +56,864 @@ Eigen::SparseMatrix<BigInteger> SymbolicCounter::get_transition_count_matrix() c
 
 void SymbolicCounter::set_transition_count_matrix(const Eigen::SparseMatrix<BigInteger>& transition_count_matrix) {
   transition_count_matrix_ = transition_count_matrix;
+  power_of_two_matrix_ = Util::PowerOfTwoMatrix(transition_count_matrix_);
+  cache_ = std::make_shared<Cache>();
 }
 
-BigInteger SymbolicCounter::Count(const unsigned long bound) {
-  unsigned long power = bound;
+void SymbolicCounter::set_cache_size(const std::size_t cache_size) {
+  std::unique_lock<std::shared_timed_mutex> lock (cache_->mutex);
+  cache_->size = cache_size;
+  while (cache_->counts.size() > cache_size) {
+    cache_->counts.erase(cache_->counts.begin());
+  }
+  while (cache_->vectors.size() > cache_size) {
+    cache_->vectors.erase(cache_->vectors.begin());
+  }
+}
+
+BigInteger SymbolicCounter::Count(const unsigned long bound) const {
+  if (SymbolicCounter::Type::UNARYINT == type_) {
+    const int accepting_state = transition_count_matrix_.rows() - 1;
+    return CountUnary(bound, transition_count_matrix_.coeff(accepting_state, accepting_state) != 0);
+  }
+  const unsigned long power = GetPower(bound);
+  BigInteger result;
+  if (GetCachedCount(power, result)) {
+    return result;
+  }
+
+  Eigen::SparseVector<BigInteger> vector;
+  const unsigned long remaining_power = power - GetCheckpoint(power, vector);
+  // component analysis costs about as much as iterating number of rows times, finite languages and simple cycles
+  // give a closed form after that
+  std::vector<BigInteger> recurrence, terms;
+  if (remaining_power > static_cast<unsigned long>(transition_count_matrix_.rows())
+      and GetSCCRecurrence(recurrence, terms)) {
+    return CountbySCCDecomposition(bound);
+  }
+  if (IsMatrixMultiplicationCheaper(remaining_power)) {
+    return CountbyMatrixMultiplication(bound);
+  }
+  return CountbyIteration(bound);
+}
+
+BigInteger SymbolicCounter::CountbyIteration(const unsigned long bound) const {
+  const unsigned long power = GetPower(bound);
+  Eigen::SparseVector<BigInteger> vector;
+  unsigned long remaining_power = power - GetCheckpoint(power, vector);
+
+  while (remaining_power > 0) {
+    vector = power_of_two_matrix_.Multiply(vector);
+    --remaining_power;
+  }
+
+  BigInteger result = vector.coeff(0);
+  CacheCounts({std::make_pair(power, result)}, power, vector);
+  DVLOG(VLOG_LEVEL) << "Count(" << bound << ") = " << result;
+  return result;
+}
+
+/**
+ * Multiplies the closest known count vector with the matrix power by successive squaring,
+ * only the set bits of the power are applied to the vector.
+ */
+BigInteger SymbolicCounter::CountbyMatrixMultiplication(const unsigned long bound) const {
+  const unsigned long power = GetPower(bound);
+  Eigen::SparseVector<BigInteger> vector;
+  unsigned long remaining_power = power - GetCheckpoint(power, vector);
+
+  if (remaining_power > 0) {
+    Eigen::SparseMatrix<BigInteger> x = transition_count_matrix_;
+    while (true) {
+      if (remaining_power & 1) {
+        vector = x * vector;
+      }
+      remaining_power >>= 1;
+      if (remaining_power == 0) {
+        break;
+      }
+      x = x * x;
+    }
+  }
+
+  BigInteger result = vector.coeff(0);
+  CacheCounts({std::make_pair(power, result)}, power, vector);
+  DVLOG(VLOG_LEVEL) << "CountbyMatrixMultiplication(" << bound << ") = " << result;
+  return result;
+}
+
+BigInteger SymbolicCounter::CountbyRecurrence(const unsigned long bound) const {
+  std::vector<BigInteger> recurrence, initial_terms;
+  GetRecurrence(recurrence, initial_terms);
+  BigInteger result = Util::Math::linear_recurrence_term(recurrence, initial_terms, GetPower(bound));
+  DVLOG(VLOG_LEVEL) << "CountbyRecurrence(" << bound << ") = " << result;
+  return result;
+}
+
+/**
+ * Partial sums of a sequence satisfying a recurrence with characteristic polynomial p(x)
+ * satisfy the recurrence with characteristic polynomial (x - 1) p(x).
+ */
+BigInteger SymbolicCounter::SumbyRecurrence(const unsigned long bound) const {
+  std::vector<BigInteger> recurrence, initial_terms;
+  GetRecurrence(recurrence, initial_terms);
+  const std::size_t degree = recurrence.size();
+  std::vector<BigInteger> sum_recurrence (degree + 1);
+  for (std::size_t i = 0; i <= degree; ++i) {
+    const BigInteger current = (i < degree) ? recurrence[i] : BigInteger(0);
+    const BigInteger previous = (i == 0) ? BigInteger(-1) : recurrence[i - 1];
+    sum_recurrence[i] = current - previous;
+  }
+  std::vector<BigInteger> sum_initial_terms (initial_terms.size());
+  BigInteger sum = 0;
+  for (std::size_t i = 0; i < initial_terms.size(); ++i) {
+    sum += initial_terms[i];
+    sum_initial_terms[i] = sum;
+  }
+
+  BigInteger result = Util::Math::linear_recurrence_term(sum_recurrence, sum_initial_terms, GetPower(bound));
+  DVLOG(VLOG_LEVEL) << "SumbyRecurrence(" << bound << ") = " << result;
+  return result;
+}
+
+BigInteger SymbolicCounter::CountUnary(const unsigned long bound, const bool count_less_than_or_equal_to_bound) const {
+  const int num_of_rows = transition_count_matrix_.rows();
+  const int accepting_state = num_of_rows - 1;
+  std::vector<int> next_state (num_of_rows, -1);
+  std::vector<BigInteger> accepting_weight (num_of_rows, 0);
+  for (int k = 0; k < transition_count_matrix_.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<BigInteger>::InnerIterator it(transition_count_matrix_, k); it; ++it) {
+      if (it.row() == accepting_state or it.value() == 0) {
+        continue;
+      } else if (it.col() == accepting_state) {
+        accepting_weight[it.row()] = it.value();
+      } else {
+        CHECK(next_state[it.row()] == -1 and it.value() == 1) << "count matrix is not a lasso";
+        next_state[it.row()] = it.col();
+      }
+    }
+  }
+
+  // accepting weights of values in the order of the lasso, values after the last one repeat the cycle
+  std::vector<int> state_values (num_of_rows, -1);
+  std::vector<BigInteger> value_weights;
+  int cycle_head = -1;
+  for (int state = 0; state != -1 and state != accepting_state; state = next_state[state]) {
+    if (state_values[state] != -1) {
+      cycle_head = state_values[state];
+      break;
+    }
+    state_values[state] = value_weights.size();
+    value_weights.push_back(accepting_weight[state]);
+  }
+
+  const BigInteger max_value = (BigInteger(1) << bound) - 1;
+  const BigInteger num_of_values = value_weights.size();
+  BigInteger result = 0;
+  if (not count_less_than_or_equal_to_bound) {
+    if (max_value < num_of_values) {
+      result = value_weights[max_value.convert_to<std::size_t>()];
+    } else if (cycle_head != -1) {
+      const BigInteger period = num_of_values - cycle_head;
+      result = value_weights[cycle_head + ((max_value - cycle_head) % period).convert_to<std::size_t>()];
+    }
+  } else if (max_value < num_of_values) {
+    const std::size_t last_value = max_value.convert_to<std::size_t>();
+    for (std::size_t v = 0; v <= last_value; ++v) {
+      result += value_weights[v];
+    }
+  } else {
+    for (auto& weight : value_weights) {
+      result += weight;
+    }
+    if (cycle_head != -1) {
+      // values from num_of_values to max_value walk around the cycle starting at its head
+      const std::size_t period = value_weights.size() - cycle_head;
+      const BigInteger remaining_values = max_value - num_of_values + 1;
+      const std::size_t num_of_partial_values = (remaining_values % period).convert_to<std::size_t>();
+      BigInteger cycle_weight = 0, partial_weight = 0;
+      for (std::size_t j = 0; j < period; ++j) {
+        cycle_weight += value_weights[cycle_head + j];
+        if (j < num_of_partial_values) {
+          partial_weight += value_weights[cycle_head + j];
+        }
+      }
+      result += (remaining_values / period) * cycle_weight + partial_weight;
+    }
+  }
+  DVLOG(VLOG_LEVEL) << "CountUnary(" << bound << ", " << count_less_than_or_equal_to_bound << ") = " << result;
+  return result;
+}
+
+BigInteger SymbolicCounter::CountbySCCDecomposition(const unsigned long bound) const {
+  std::vector<BigInteger> recurrence, terms;
+  if (not GetSCCRecurrence(recurrence, terms)) {
+    return Count(bound);
+  }
+
+  // terms start at power number of rows
+  const unsigned long power = GetPower(bound);
+  const unsigned long offset = transition_count_matrix_.rows();
+  BigInteger result;
+  if (power < offset) {
+    result = terms[power];
+  } else {
+    std::vector<BigInteger> shifted_terms (terms.begin() + offset, terms.end());
+    result = Util::Math::linear_recurrence_term(recurrence, shifted_terms, power - offset);
+  }
+  DVLOG(VLOG_LEVEL) << "CountbySCCDecomposition(" << bound << ") = " << result;
+  return result;
+}
 
+BigInteger SymbolicCounter::CountbyModularArithmetic(const unsigned long bound) const {
+  const unsigned long power = GetPower(bound);
+  BigInteger result;
+  if (GetCachedCount(power, result)) {
+    return result;
+  }
+
+  // each prime contributes at least 60 bits
+  const unsigned long num_of_bits = GetCountBitBound(power) + 1;
+  const std::size_t num_of_primes = (num_of_bits + 59) / 60;
+  auto primes = Util::Math::get_large_primes(num_of_primes);
+  result = Util::Math::chinese_remainder(CountModuli(power, primes), primes);
+  DVLOG(VLOG_LEVEL) << "CountbyModularArithmetic(" << bound << ") = " << result << " using " << num_of_primes << " primes";
+  return result;
+}
+
+std::uint64_t SymbolicCounter::CountModulo(const unsigned long bound, const std::uint64_t modulus) const {
+  CHECK_GT(modulus, 0);
+  CHECK_LT(modulus, std::uint64_t(1) << 63);
+  return CountModuli(GetPower(bound), {modulus}).front();
+}
+
+/**
+ * Each matrix and vector entry is kept as a double mantissa in [0.5, 1) with its own exponent. A row is summed after
+ * aligning its terms to the largest term exponent, so entries with very different magnitudes never overflow or
+ * lose precision to subnormals.
+ */
+double SymbolicCounter::CountLog2(const unsigned long bound) const {
+  struct ScaledDouble {
+    double mantissa;
+    long exponent;
+  };
+  auto to_scaled_double = [](const BigInteger& value) -> ScaledDouble {
+    if (value == 0) {
+      return ScaledDouble {0, 0};
+    }
+    const long shift = std::max(0L, static_cast<long>(boost::multiprecision::msb(value)) - 62);
+    int exponent = 0;
+    const double mantissa = std::frexp(static_cast<double>(static_cast<std::uint64_t>(value >> shift)), &exponent);
+    return ScaledDouble {mantissa, exponent + shift};
+  };
+
+  // unary powers are 2^bound - 1, lasso arithmetic counts exactly at the cost of the number of states
+  if (SymbolicCounter::Type::UNARYINT == type_) {
+    const ScaledDouble count = to_scaled_double(Count(bound));
+    const double result = (count.mantissa > 0) ? (std::log2(count.mantissa) + count.exponent) : -std::numeric_limits<double>::infinity();
+    DVLOG(VLOG_LEVEL) << "CountLog2(" << bound << ") = " << result;
+    return result;
+  }
+
+  const unsigned long power = GetPower(bound);
+  const std::size_t num_of_rows = transition_count_matrix_.rows();
+
+  std::vector<std::vector<std::pair<std::size_t, ScaledDouble>>> rows (num_of_rows);
+  for (int k = 0; k < transition_count_matrix_.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<BigInteger>::InnerIterator it(transition_count_matrix_, k); it; ++it) {
+      if (it.value() != 0) {
+        rows[it.row()].push_back(std::make_pair(static_cast<std::size_t>(it.col()), to_scaled_double(it.value())));
+      }
+    }
+  }
+
+  std::vector<ScaledDouble> x (num_of_rows, ScaledDouble {0, 0}), y (num_of_rows, ScaledDouble {0, 0});
+  const Eigen::SparseVector<BigInteger> initial_vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+  for (Eigen::SparseVector<BigInteger>::InnerIterator it(initial_vector); it; ++it) {
+    x[it.index()] = to_scaled_double(it.value());
+  }
+
+  for (unsigned long step = 0; step < power; ++step) {
+    for (std::size_t r = 0; r < num_of_rows; ++r) {
+      long max_exponent = LONG_MIN;
+      for (auto& entry : rows[r]) {
+        const ScaledDouble& operand = x[entry.first];
+        if (operand.mantissa != 0) {
+          max_exponent = std::max(max_exponent, entry.second.exponent + operand.exponent);
+        }
+      }
+      if (max_exponent == LONG_MIN) {
+        y[r] = ScaledDouble {0, 0};
+        continue;
+      }
+
+      double sum = 0;
+      for (auto& entry : rows[r]) {
+        const ScaledDouble& operand = x[entry.first];
+        if (operand.mantissa != 0) {
+          // terms far below the largest one are under the rounding error, clamp to keep ldexp in range
+          const long shift = std::max(-1100L, entry.second.exponent + operand.exponent - max_exponent);
+          sum += std::ldexp(entry.second.mantissa * operand.mantissa, static_cast<int>(shift));
+        }
+      }
+      int exponent = 0;
+      y[r].mantissa = std::frexp(sum, &exponent);
+      y[r].exponent = max_exponent + exponent;
+    }
+    x.swap(y);
+  }
+
+  const double result = (x[0].mantissa > 0) ? (std::log2(x[0].mantissa) + x[0].exponent) : -std::numeric_limits<double>::infinity();
+  DVLOG(VLOG_LEVEL) << "CountLog2(" << bound << ") = " << result;
+  return result;
+}
+
+double SymbolicCounter::CountLog2ErrorBound(const unsigned long bound) const {
+  const double unit_roundoff = std::ldexp(1.0, -53);
+  if (SymbolicCounter::Type::UNARYINT == type_) {
+    // exact count is rounded once before the final log2
+    const BigInteger count = Count(bound);
+    const double num_of_bits = (count == 0) ? 0 : static_cast<double>(boost::multiprecision::msb(count)) + 1;
+    return unit_roundoff / std::log(2.0) + (num_of_bits + 2) * unit_roundoff * 2;
+  }
+
+  const std::size_t num_of_rows = transition_count_matrix_.rows();
+  std::vector<std::size_t> row_lengths (num_of_rows, 0);
+  for (int k = 0; k < transition_count_matrix_.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<BigInteger>::InnerIterator it(transition_count_matrix_, k); it; ++it) {
+      ++row_lengths[it.row()];
+    }
+  }
+  std::size_t max_row_length = 0;
+  for (auto length : row_lengths) {
+    max_row_length = std::max(max_row_length, length);
+  }
+
+  // per step: rounding the matrix entries, the products and the sums, initial vector is rounded once
+  const unsigned long power = GetPower(bound);
+  const double step_error = std::log1p((max_row_length + 1) * unit_roundoff) / std::log(2.0);
+  const double propagation_error = (static_cast<double>(power) + 1) * step_error;
+  // final log2 and the addition of the exponent
+  const double evaluation_error = (static_cast<double>(GetCountBitBound(power)) + 2) * unit_roundoff * 2;
+  return propagation_error + evaluation_error;
+}
+
+std::vector<BigInteger> SymbolicCounter::CountBounds(const std::vector<unsigned long>& bounds) const {
+  std::vector<BigInteger> results (bounds.size());
+  if (bounds.empty()) {
+    return results;
+  } else if (SymbolicCounter::Type::UNARYINT == type_) {
+    for (std::size_t i = 0; i < bounds.size(); ++i) {
+      results[i] = Count(bounds[i]);
+    }
+    return results;
+  }
+
+  // visit powers in increasing order, keep track of where each result goes
+  std::vector<std::pair<unsigned long, std::size_t>> powers;
+  powers.reserve(bounds.size());
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    powers.push_back(std::make_pair(GetPower(bounds[i]), i));
+  }
+  std::sort(powers.begin(), powers.end());
+
+  std::vector<std::pair<unsigned long, BigInteger>> counts;
+  auto it = powers.begin();
+  Eigen::SparseVector<BigInteger> vector;
+  const unsigned long last_power = ForwardSweep(powers.front().first, powers.back().first, vector,
+      [&it, &powers, &results, &counts](const unsigned long power, const Eigen::SparseVector<BigInteger>& current_vector) {
+    if (it != powers.end() and it->first == power) {
+      counts.push_back(std::make_pair(power, current_vector.coeff(0)));
+    }
+    while (it != powers.end() and it->first == power) {
+      results[it->second] = current_vector.coeff(0);
+      ++it;
+    }
+    return it != powers.end();
+  });
+  CacheCounts(counts, last_power, vector);
+
+  DVLOG(VLOG_LEVEL) << "CountBounds(" << bounds.size() << " bounds) done";
+  return results;
+}
+
+std::vector<BigInteger> SymbolicCounter::CountAllBounds(const unsigned long max_bound) const {
+  std::vector<unsigned long> bounds (max_bound + 1);
+  for (unsigned long b = 0; b <= max_bound; ++b) {
+    bounds[b] = b;
+  }
+  return CountBounds(bounds);
+}
+
+std::vector<Eigen::SparseVector<BigInteger>> SymbolicCounter::GetCountVectors(const unsigned long bound) const {
+  CHECK(SymbolicCounter::Type::UNARYINT != type_) << "count vectors are not kept for unary integers";
+  const unsigned long power = GetPower(bound);
+  std::vector<Eigen::SparseVector<BigInteger>> vectors;
+  vectors.reserve(power + 1);
+  Eigen::SparseVector<BigInteger> vector;
+  ForwardSweep(0, power, vector, [&vectors](const unsigned long current_power, const Eigen::SparseVector<BigInteger>& current_vector) {
+    vectors.push_back(current_vector);
+    return true;
+  });
+  return vectors;
+}
+
+int SymbolicCounter::GetMinBound(int num_models) const {
+  int min_bound = INT_MAX;
+  Eigen::SparseVector<BigInteger> vector, previous_vector;
+  ForwardSweep(0, INT_MAX, vector, [num_models, &min_bound, &previous_vector](const unsigned long power, const Eigen::SparseVector<BigInteger>& current_vector) {
+    if (power > 0) {
+      // if we have enough models, or the count vector doesn't change, return with
+      // the corresponding bound
+      if (current_vector.coeff(0) >= num_models) {
+        min_bound = power;
+        return false;
+      } else if (previous_vector.isApprox(current_vector)) {
+        min_bound = power - 1;
+        return false;
+      }
+    }
+    previous_vector = current_vector;
+    return true;
+  });
+
+  return min_bound;
+}
+
+unsigned long SymbolicCounter::GetPower(const unsigned long bound) const {
+  unsigned long power = bound;
   if (SymbolicCounter::Type::BINARYINT == type_) {
     ++power; // handle sign bit
   } else if (SymbolicCounter::Type::UNARYINT == type_) {
+    CHECK_LT(bound, static_cast<unsigned long>(std::numeric_limits<unsigned long>::digits)) << "use Count for large unary bounds";
     unsigned long base = 1;
     power = (base << bound) - 1;
   }
+  return power;
+}
+
+unsigned long SymbolicCounter::GetCheckpoint(const unsigned long power, Eigen::SparseVector<BigInteger>& vector) const {
+  unsigned long checkpoint_power = 0;
+  {
+    std::shared_lock<std::shared_timed_mutex> lock (cache_->mutex);
+    auto it = cache_->vectors.upper_bound(power);
+    if (it != cache_->vectors.begin()) {
+      --it;
+      checkpoint_power = it->first;
+      vector = it->second;
+    }
+  }
 
-  if (power >= bound_) {
-    power = power - bound_;
+  // initialization vector is the count vector at power bound_
+  if (bound_ <= power and (checkpoint_power < bound_ or vector.size() == 0)) {
+    vector = initialization_vector_;
+    return bound_;
+  } else if (vector.size() == 0) {
+    vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+    return 0;
+  }
+  return checkpoint_power;
+}
+
+bool SymbolicCounter::GetCachedCount(const unsigned long power, BigInteger& count) const {
+  std::shared_lock<std::shared_timed_mutex> lock (cache_->mutex);
+  auto it = cache_->counts.find(power);
+  if (it == cache_->counts.end()) {
+    return false;
+  }
+  count = it->second;
+  return true;
+}
+
+/**
+ * Keeps the highest powers when the cache is full, lower ones are cheaper to recompute.
+ */
+void SymbolicCounter::CacheCounts(const std::vector<std::pair<unsigned long, BigInteger>>& counts, const unsigned long power,
+                                  const Eigen::SparseVector<BigInteger>& vector) const {
+  std::unique_lock<std::shared_timed_mutex> lock (cache_->mutex);
+  if (cache_->size == 0) {
+    return;
+  }
+  for (auto& entry : counts) {
+    cache_->counts[entry.first] = entry.second;
+  }
+  while (cache_->counts.size() > cache_->size) {
+    cache_->counts.erase(cache_->counts.begin());
+  }
+  cache_->vectors[power] = vector;
+  while (cache_->vectors.size() > cache_->size) {
+    cache_->vectors.erase(cache_->vectors.begin());
+  }
+}
+
+/**
+ * Count sequence is a[k] = (M^k v)[0] where v is the last column of the count matrix M, its minimal
+ * polynomial has degree at most the number of rows of M, hence 2 * rows terms determine the recurrence.
+ */
+void SymbolicCounter::GetRecurrence(std::vector<BigInteger>& recurrence, std::vector<BigInteger>& initial_terms) const {
+  {
+    std::shared_lock<std::shared_timed_mutex> lock (cache_->mutex);
+    if (cache_->has_recurrence) {
+      recurrence = cache_->recurrence;
+      initial_terms = cache_->recurrence_initial_terms;
+      return;
+    }
+  }
+
+  const std::size_t num_of_terms = 2 * static_cast<std::size_t>(transition_count_matrix_.rows()) + 1;
+  initial_terms.clear();
+  initial_terms.reserve(num_of_terms);
+  Eigen::SparseVector<BigInteger> current_vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+  for (std::size_t i = 0; i < num_of_terms; ++i) {
+    initial_terms.push_back(current_vector.coeff(0));
+    if (i + 1 < num_of_terms) {
+      current_vector = power_of_two_matrix_.Multiply(current_vector);
+    }
+  }
+  recurrence = Util::Math::berlekamp_massey(initial_terms);
+  DVLOG(VLOG_LEVEL) << "recurrence degree: " << recurrence.size();
+
+  std::unique_lock<std::shared_timed_mutex> lock (cache_->mutex);
+  if (not cache_->has_recurrence) {
+    cache_->recurrence = recurrence;
+    cache_->recurrence_initial_terms = initial_terms;
+    cache_->has_recurrence = true;
+  }
+}
+
+/**
+ * Matrix is kept in compressed row form with residues of an entry for all moduli next to each other,
+ * so that the innermost loop runs over moduli on contiguous memory. Products are accumulated in 128 bits
+ * and reduced once every few terms when all moduli are below 2^61.
+ */
+std::vector<std::uint64_t> SymbolicCounter::CountModuli(const unsigned long power, const std::vector<std::uint64_t>& moduli) const {
+  const std::size_t num_of_moduli = moduli.size();
+  const std::size_t num_of_rows = transition_count_matrix_.rows();
+  std::vector<std::uint64_t> results;
+  results.reserve(num_of_moduli);
+
+  std::vector<std::vector<std::pair<std::size_t, BigInteger>>> rows (num_of_rows);
+  for (int k = 0; k < transition_count_matrix_.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<BigInteger>::InnerIterator it(transition_count_matrix_, k); it; ++it) {
+      rows[it.row()].push_back(std::make_pair(static_cast<std::size_t>(it.col()), it.value()));
+    }
+  }
+  const Eigen::SparseVector<BigInteger> initial_vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+
+  // moduli are processed in blocks to keep the working vectors small
+  const std::size_t block_size = 32;
+  for (std::size_t block_start = 0; block_start < num_of_moduli; block_start += block_size) {
+    const std::size_t k = std::min(block_size, num_of_moduli - block_start);
+    const std::uint64_t* block_moduli = moduli.data() + block_start;
+    bool is_lazy = true;
+    for (std::size_t j = 0; j < k; ++j) {
+      is_lazy = is_lazy and (block_moduli[j] < (std::uint64_t(1) << 61));
+    }
+    const std::size_t terms_per_reduction = is_lazy ? 63 : 1;
+
+    std::vector<std::size_t> row_offsets (num_of_rows + 1, 0);
+    std::vector<std::size_t> columns;
+    std::vector<std::uint64_t> values;
+    for (std::size_t r = 0; r < num_of_rows; ++r) {
+      for (auto& entry : rows[r]) {
+        columns.push_back(entry.first);
+        for (std::size_t j = 0; j < k; ++j) {
+          values.push_back(static_cast<std::uint64_t>(entry.second % block_moduli[j]));
+        }
+      }
+      row_offsets[r + 1] = columns.size();
+    }
+
+    std::vector<std::uint64_t> x (num_of_rows * k, 0), y (num_of_rows * k, 0);
+    for (Eigen::SparseVector<BigInteger>::InnerIterator it(initial_vector); it; ++it) {
+      for (std::size_t j = 0; j < k; ++j) {
+        x[it.index() * k + j] = static_cast<std::uint64_t>(it.value() % block_moduli[j]);
+      }
+    }
+
+    std::vector<unsigned __int128> accumulator (k);
+    for (unsigned long step = 0; step < power; ++step) {
+      for (std::size_t r = 0; r < num_of_rows; ++r) {
+        std::fill(accumulator.begin(), accumulator.end(), 0);
+        std::size_t num_of_terms = 0;
+        for (std::size_t e = row_offsets[r]; e < row_offsets[r + 1]; ++e) {
+          const std::uint64_t* value = values.data() + e * k;
+          const std::uint64_t* operand = x.data() + columns[e] * k;
+          for (std::size_t j = 0; j < k; ++j) {
+            accumulator[j] += static_cast<unsigned __int128>(value[j]) * operand[j];
+          }
+          if (++num_of_terms == terms_per_reduction) {
+            for (std::size_t j = 0; j < k; ++j) {
+              accumulator[j] %= block_moduli[j];
+            }
+            num_of_terms = 0;
+          }
+        }
+        std::uint64_t* target = y.data() + r * k;
+        for (std::size_t j = 0; j < k; ++j) {
+          target[j] = static_cast<std::uint64_t>(accumulator[j] % block_moduli[j]);
+        }
+      }
+      x.swap(y);
+    }
+
+    for (std::size_t j = 0; j < k; ++j) {
+      results.push_back(x[j]);
+    }
+  }
+  return results;
+}
+
+unsigned long SymbolicCounter::GetCountBitBound(const unsigned long power) const {
+  BigInteger max_row_sum = 0;
+  std::vector<BigInteger> row_sums (transition_count_matrix_.rows());
+  for (int k = 0; k < transition_count_matrix_.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<BigInteger>::InnerIterator it(transition_count_matrix_, k); it; ++it) {
+      row_sums[it.row()] += it.value();
+    }
+  }
+  for (auto& row_sum : row_sums) {
+    if (row_sum > max_row_sum) {
+      max_row_sum = row_sum;
+    }
+  }
+
+  BigInteger max_initial_value = 0;
+  const Eigen::SparseVector<BigInteger> initial_vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+  for (Eigen::SparseVector<BigInteger>::InnerIterator it(initial_vector); it; ++it) {
+    if (it.value() > max_initial_value) {
+      max_initial_value = it.value();
+    }
+  }
+
+  // ceil(log2(max_row_sum)) bits per step
+  const unsigned long bits_per_step = (max_row_sum <= 1) ? 0 : boost::multiprecision::msb(BigInteger(max_row_sum - 1)) + 1;
+  const unsigned long initial_bits = (max_initial_value == 0) ? 0 : boost::multiprecision::msb(max_initial_value) + 1;
+  return bits_per_step * power + initial_bits;
+}
+
+/**
+ * Count at power k is the weighted number of walks of length k + 1 from the start state (0) to the artificial accepting
+ * state (last row). Its generating function has the determinants of (I - x M_C) of the components C on such walks as
+ * denominator, which is 1 - w x^p for a simple cycle. Numerator degree is less than the number of rows, hence the
+ * recurrence holds from that power on.
+ */
+bool SymbolicCounter::GetSCCRecurrence(std::vector<BigInteger>& recurrence, std::vector<BigInteger>& terms) const {
+  {
+    std::shared_lock<std::shared_timed_mutex> lock (cache_->mutex);
+    if (cache_->has_scc_recurrence) {
+      recurrence = cache_->scc_recurrence;
+      terms = cache_->scc_terms;
+      return cache_->is_scc_decomposable;
+    }
+  }
+
+  const int num_of_rows = transition_count_matrix_.rows();
+  const int accepting_state = num_of_rows - 1;
+  std::vector<std::vector<std::pair<int, BigInteger>>> next_states (num_of_rows);
+  std::vector<std::vector<int>> previous_states (num_of_rows);
+  for (int k = 0; k < transition_count_matrix_.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<BigInteger>::InnerIterator it(transition_count_matrix_, k); it; ++it) {
+      if (it.value() != 0) {
+        next_states[it.row()].push_back(std::make_pair(static_cast<int>(it.col()), it.value()));
+        previous_states[it.col()].push_back(it.row());
+      }
+    }
+  }
+
+  // states that are on a walk from start to accepting state
+  auto mark_reachable = [num_of_rows](const int from, std::function<std::vector<int>(const int)> next) {
+    std::vector<bool> is_reachable (num_of_rows, false);
+    std::stack<int> state_stack;
+    state_stack.push(from);
+    is_reachable[from] = true;
+    while (not state_stack.empty()) {
+      const int state = state_stack.top(); state_stack.pop();
+      for (int next_state : next(state)) {
+        if (not is_reachable[next_state]) {
+          is_reachable[next_state] = true;
+          state_stack.push(next_state);
+        }
+      }
+    }
+    return is_reachable;
+  };
+  auto is_forward_reachable = mark_reachable(0, [&next_states](const int state) {
+    std::vector<int> states;
+    for (auto& entry : next_states[state]) {
+      states.push_back(entry.first);
+    }
+    return states;
+  });
+  auto is_backward_reachable = mark_reachable(accepting_state, [&previous_states](const int state) {
+    return previous_states[state];
+  });
+  std::vector<bool> is_relevant (num_of_rows);
+  for (int s = 0; s < num_of_rows; ++s) {
+    is_relevant[s] = is_forward_reachable[s] and is_backward_reachable[s];
+  }
+
+  // iterative tarjan on relevant states
+  std::vector<int> index (num_of_rows, -1), low_link (num_of_rows, 0), component (num_of_rows, -1);
+  std::vector<bool> is_on_stack (num_of_rows, false);
+  std::stack<int> scc_stack;
+  std::vector<std::vector<int>> components;
+  int current_index = 0;
+  for (int root = 0; root < num_of_rows; ++root) {
+    if (not is_relevant[root] or index[root] != -1) {
+      continue;
+    }
+    // pair of state and position of the next successor to visit
+    std::stack<std::pair<int, std::size_t>> call_stack;
+    call_stack.push(std::make_pair(root, 0));
+    index[root] = low_link[root] = current_index++;
+    scc_stack.push(root);
+    is_on_stack[root] = true;
+    while (not call_stack.empty()) {
+      const int state = call_stack.top().first;
+      std::size_t& position = call_stack.top().second;
+      if (position < next_states[state].size()) {
+        const int next_state = next_states[state][position].first;
+        ++position;
+        if (not is_relevant[next_state]) {
+          continue;
+        } else if (index[next_state] == -1) {
+          index[next_state] = low_link[next_state] = current_index++;
+          scc_stack.push(next_state);
+          is_on_stack[next_state] = true;
+          call_stack.push(std::make_pair(next_state, 0));
+        } else if (is_on_stack[next_state]) {
+          low_link[state] = std::min(low_link[state], index[next_state]);
+        }
+        continue;
+      }
+
+      if (low_link[state] == index[state]) {
+        std::vector<int> states;
+        int member = -1;
+        do {
+          member = scc_stack.top(); scc_stack.pop();
+          is_on_stack[member] = false;
+          component[member] = components.size();
+          states.push_back(member);
+        } while (member != state);
+        components.push_back(states);
+      }
+      call_stack.pop();
+      if (not call_stack.empty()) {
+        const int parent = call_stack.top().first;
+        low_link[parent] = std::min(low_link[parent], low_link[state]);
+      }
+    }
+  }
+
+  // characteristic polynomial in reversed form, q[0] = 1
+  std::vector<BigInteger> q {1};
+  bool is_decomposable = true;
+  for (std::size_t c = 0; c < components.size() and is_decomposable; ++c) {
+    BigInteger weight = 1;
+    int num_of_internal_edges = 0;
+    for (int state : components[c]) {
+      int num_of_successors = 0;
+      for (auto& entry : next_states[state]) {
+        if (is_relevant[entry.first] and component[entry.first] == static_cast<int>(c)) {
+          ++num_of_successors;
+          weight *= entry.second;
+        }
+      }
+      if (num_of_successors > 1) {
+        is_decomposable = false;
+      }
+      num_of_internal_edges += num_of_successors;
+    }
+    if (num_of_internal_edges == 0) {
+      continue; // trivial component
+    } else if (num_of_internal_edges != static_cast<int>(components[c].size())) {
+      is_decomposable = false;
+      continue;
+    }
+
+    // multiply with 1 - weight x^period
+    const std::size_t period = components[c].size();
+    std::vector<BigInteger> product (q.size() + period, 0);
+    for (std::size_t i = 0; i < q.size(); ++i) {
+      product[i] += q[i];
+      product[i + period] -= q[i] * weight;
+    }
+    q = std::move(product);
+  }
+
+  if (is_decomposable) {
+    recurrence.resize(q.size() - 1);
+    for (std::size_t i = 1; i < q.size(); ++i) {
+      recurrence[i - 1] = -q[i];
+    }
+    const std::size_t num_of_terms = num_of_rows + recurrence.size();
+    terms.clear();
+    terms.reserve(num_of_terms);
+    Eigen::SparseVector<BigInteger> current_vector = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+    for (std::size_t i = 0; i < num_of_terms; ++i) {
+      terms.push_back(current_vector.coeff(0));
+      if (i + 1 < num_of_terms) {
+        current_vector = power_of_two_matrix_.Multiply(current_vector);
+      }
+    }
+    DVLOG(VLOG_LEVEL) << "scc recurrence degree: " << recurrence.size() << " (" << components.size() << " components)";
   } else {
-    initialization_vector_ = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
+    recurrence.clear();
+    terms.clear();
+    DVLOG(VLOG_LEVEL) << "count matrix has a complex component";
   }
 
-  while (power > 0) {
-    initialization_vector_ = transition_count_matrix_ * initialization_vector_;
-    --power;
+  std::unique_lock<std::shared_timed_mutex> lock (cache_->mutex);
+  if (not cache_->has_scc_recurrence) {
+    cache_->scc_recurrence = recurrence;
+    cache_->scc_terms = terms;
+    cache_->is_scc_decomposable = is_decomposable;
+    cache_->has_scc_recurrence = true;
   }
+  return is_decomposable;
+}
 
-  bound_ = bound;
-  if (SymbolicCounter::Type::BINARYINT == type_) {
-    ++bound_; // handle sign bit
-  }
-
-
-  DVLOG(VLOG_LEVEL) << "Count(" << bound << ") = " << initialization_vector_.coeff(0);
-  return initialization_vector_.coeff(0);
-}
-
-BigInteger SymbolicCounter::CountbyMatrixMultiplication(const unsigned long bound) {
-  LOG(FATAL) << "not fixed yet";
-  return 0;
-  //  // matrix exponentiation is off by 1 because of artificial accepting state
-//  int power = bound + 1;
-//
-//  Eigen::SparseMatrix<BigInteger> y;
-//  bool has_odds = false;
-//
-//  while (power > 1) {
-//    if (power % 2 == 0) {
-//      power = power / 2;
-//    } else {
-//      power = (power - 1) / 2;
-//      if (has_odds) {
-//        y = x * y;
-//      } else {
-//        y = x;
-//        has_odds = true;
-//      }
-//    }
-//    x = x * x;
-//  }
-//
-//  if (has_odds) {
-//    x = x * y;
-//  }
-//
-//  BigInteger result = x.coeff(this->dfa_->s, this->dfa_->ns);
-//  return result;
-}
-
-int SymbolicCounter::GetMinBound(int num_models) {
-
-
-	unsigned long bound = INT_MAX;
-	unsigned long power = bound;
-
-	if (SymbolicCounter::Type::BINARYINT == type_) {
-		++power; // handle sign bit
-	} else if (SymbolicCounter::Type::UNARYINT == type_) {
-		unsigned long base = 1;
-		power = (base << bound) - 1;
-	}
-
-	if (power >= bound_) {
-		power = power - bound_;
-	} else {
-		initialization_vector_ = transition_count_matrix_.innerVector(transition_count_matrix_.cols()-1);
-	}
-
-	int count = 0;
-	int min_bound = INT_MAX;
-	while (power > 0) {
-		auto before_vector(initialization_vector_);
-		initialization_vector_ = transition_count_matrix_ * initialization_vector_;
-		--power;
-		count++;
-		// if we have enough models, or the count vector doesn't change, return with
-		// the corresponding bound
-		if(initialization_vector_.coeff(0) >= num_models) {
-			min_bound = count;
-			break;
-		} else if(before_vector.isApprox(initialization_vector_)) {
-			// -1 for incrementing count when not needed
-			count--;
-			min_bound = count;
-			break;
-		}
-	}
-
-	bound_ = min_bound;
-	if (SymbolicCounter::Type::BINARYINT == type_) {
-		++bound_; // handle sign bit
-	}
-
-	return min_bound;
+/**
+ * Iteration costs one sparse matrix-vector product per power, squaring costs
+ * one sparse matrix-matrix product per bit of the power. Powers of the count matrix
+ * fill in quickly, hence a squaring step is estimated as a product of two matrices
+ * that are as dense as the reachability allows.
+ */
+bool SymbolicCounter::IsMatrixMultiplicationCheaper(const unsigned long remaining_power) const {
+  if (remaining_power < 2) {
+    return false;
+  }
+  const double num_of_states = transition_count_matrix_.rows();
+  const double non_zeros = transition_count_matrix_.nonZeros();
+  const double density = (num_of_states > 0) ? (non_zeros / (num_of_states * num_of_states)) : 1.0;
+  const double iteration_cost = static_cast<double>(remaining_power) * non_zeros;
+  const double squaring_cost = std::log2(static_cast<double>(remaining_power))
+      * num_of_states * num_of_states * num_of_states * std::max(density, 1.0 / num_of_states) * 2;
+  return squaring_cost < iteration_cost;
+}
+
+unsigned long SymbolicCounter::ForwardSweep(const unsigned long from_power, const unsigned long to_power, Eigen::SparseVector<BigInteger>& vector,
+                                   std::function<bool(const unsigned long power, const Eigen::SparseVector<BigInteger>& vector)> visit) const {
+  unsigned long current_power = GetCheckpoint(from_power, vector);
+  while (true) {
+    if (current_power >= from_power and not visit(current_power, vector)) {
+      break;
+    }
+    if (current_power >= to_power) {
+      break;
+    }
+    vector = power_of_two_matrix_.Multiply(vector);
+    ++current_power;
+  }
+  return current_power;
 }
 
 std::string SymbolicCounter::str() const {
   std::stringstream ss;
   ss << "type:       " << static_cast<int>(type_)<< std::endl;
-  ss << "last bound  : " << bound_ << std::endl;
+  ss << "init bound  : " << bound_ << std::endl;
   ss << "init vector : " << std::endl << initialization_vector_ << std::endl;
   ss << "symb matrix : " << std::endl << transition_count_matrix_ << std::endl;
   return ss.str();
@@ -8,9 +8,21 @@
 #ifndef SRC_THEORY_SYMBOLICCOUNTER_H_
 #define SRC_THEORY_SYMBOLICCOUNTER_H_
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <shared_mutex>
 #include <sstream>
+#include <stack>
 #include <string>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -28,25 +40,103 @@ class SymbolicCounter {
   SymbolicCounter();
   virtual ~SymbolicCounter();
 
-  Type type();
+  Type type() const;
   void set_type(const Type t);
-  unsigned long get_bound();
+  unsigned long get_bound() const;
   void set_bound(const unsigned long bound);
   Eigen::SparseVector<BigInteger> get_initialization_vector() const;
   void set_initialization_vector(const Eigen::SparseVector<BigInteger>& initialization_vector);
   Eigen::SparseMatrix<BigInteger> get_transition_count_matrix() const;
   void set_transition_count_matrix(const Eigen::SparseMatrix<BigInteger>& transition_count_matrix);
 
-  BigInteger Count(const unsigned long bound);
-  BigInteger CountbyMatrixMultiplication(const unsigned long bound);
-  int GetMinBound(int num_models);
+  /**
+   * Sets the maximum number of cached counts and count vectors, 0 disables caching.
+   * Cache is shared among copies of a counter.
+   */
+  void set_cache_size(const std::size_t cache_size);
+
+  /**
+   * Counts by picking the cheaper of iterative vector multiplication and
+   * matrix exponentiation by successive squaring.
+   */
+  BigInteger Count(const unsigned long bound) const;
+  BigInteger CountbyIteration(const unsigned long bound) const;
+  BigInteger CountbyMatrixMultiplication(const unsigned long bound) const;
+
+  /**
+   * Counts using the linear recurrence that the count sequence satisfies, recurrence is
+   * derived once from the transition count matrix.
+   */
+  BigInteger CountbyRecurrence(const unsigned long bound) const;
+
+  /**
+   * Sums counts of all powers up to the one of the given bound using the recurrence.
+   */
+  BigInteger SumbyRecurrence(const unsigned long bound) const;
+
+  /**
+   * Counts using the strongly connected components of the count matrix. If every component on a path from the
+   * start state to the artificial accepting state is trivial or a simple cycle, the characteristic polynomial is the
+   * product of (1 - w x^p) over cycles of length p and weight w; counts then follow a known recurrence.
+   * Acyclic automata saturate once the bound passes the longest word. Falls back to Count otherwise.
+   */
+  BigInteger CountbySCCDecomposition(const unsigned long bound) const;
+
+  /**
+   * Counts unary integer counters with lasso arithmetic, count matrix of a unary automaton is a lasso where each state
+   * has at most one successor besides the artificial accepting state. Cost is linear in the number of states,
+   * independent of the bound; values up to 2^bound - 1 are considered.
+   */
+  BigInteger CountUnary(const unsigned long bound, const bool count_less_than_or_equal_to_bound) const;
+
+  /**
+   * Counts by running the iteration modulo several 61 bit primes on flat arrays and reconstructing
+   * the exact result with Chinese remaindering. Number of primes is decided from a bound on the result size.
+   */
+  BigInteger CountbyModularArithmetic(const unsigned long bound) const;
+
+  /**
+   * Gets the count modulo the given modulus (less than 2^63) without computing the exact count.
+   */
+  std::uint64_t CountModulo(const unsigned long bound, const std::uint64_t modulus) const;
+
+  /**
+   * Approximates log2 of the count using floating point vectors whose entries each keep a mantissa and a separate
+   * integer exponent, so that they never overflow. Returns -infinity if there is no model.
+   */
+  double CountLog2(const unsigned long bound) const;
+
+  /**
+   * Upper bound on |CountLog2(bound) - log2(Count(bound))|; all values are non-negative, hence each step multiplies
+   * the relative error of each entry by at most (1 + (k + 1)u) where k is the maximum row length and u = 2^-53.
+   */
+  double CountLog2ErrorBound(const unsigned long bound) const;
+
+  /**
+   * Counts for all given bounds with a single forward sweep over the count vectors.
+   * @param bounds in any order
+   * @return counts in the order of bounds
+   */
+  std::vector<BigInteger> CountBounds(const std::vector<unsigned long>& bounds) const;
+
+  /**
+   * Counts for every bound from 0 to max_bound with a single forward sweep.
+   */
+  std::vector<BigInteger> CountAllBounds(const unsigned long max_bound) const;
+
+  /**
+   * Gets the count vectors of all powers up to the one of the given bound, entry s of vector k is the number of paths
+   * with k + 1 steps from state s to the artificial accepting state.
+   */
+  std::vector<Eigen::SparseVector<BigInteger>> GetCountVectors(const unsigned long bound) const;
+  int GetMinBound(int num_models) const;
 
   template <class Archive>
   void save(Archive& ar) const {
     ar(static_cast<int>(type_));
     ar(bound_);
     Util::Serialize::save(ar, initialization_vector_);
-    Util::Serialize::save(ar, transition_count_matrix_);
+    Util::Serialize::save(ar, power_of_two_matrix_);
   }
 
   template <class Archive>
@@ -56,7 +146,9 @@ class SymbolicCounter {
     type_ = static_cast<Type>(type);
     ar(bound_);
     Util::Serialize::load(ar, initialization_vector_);
-    Util::Serialize::load(ar, transition_count_matrix_);
+    Util::Serialize::load(ar, power_of_two_matrix_);
+    transition_count_matrix_ = power_of_two_matrix_.ToSparseMatrix();
+    cache_ = std::make_shared<Cache>();
   }
 
   std::string str() const;
@@ -66,6 +158,78 @@ protected:
   unsigned long bound_;
   Eigen::SparseVector<BigInteger> initialization_vector_;
   Eigen::SparseMatrix<BigInteger> transition_count_matrix_;
+  /**
+   * Same matrix with entries as exponent lists, count vectors are multiplied with shifts and additions
+   */
+  Util::PowerOfTwoMatrix power_of_two_matrix_;
+
+  /**
+   * Counts and count vectors per power, and the recurrence of the count sequence.
+   * Evaluation never modifies the counter itself, results are shared through the cache which is
+   * guarded for concurrent readers.
+   */
+  struct Cache {
+    Cache();
+    mutable std::shared_timed_mutex mutex;
+    std::size_t size;
+    std::map<unsigned long, BigInteger> counts;
+    std::map<unsigned long, Eigen::SparseVector<BigInteger>> vectors;
+    bool has_recurrence;
+    std::vector<BigInteger> recurrence;
+    std::vector<BigInteger> recurrence_initial_terms;
+    bool has_scc_recurrence;
+    bool is_scc_decomposable;
+    std::vector<BigInteger> scc_recurrence;
+    std::vector<BigInteger> scc_terms;
+  };
+  std::shared_ptr<Cache> cache_;
+
+  /**
+   * Number of matrix multiplications needed for the given bound, depends on counter type.
+   */
+  unsigned long GetPower(const unsigned long bound) const;
+
+  /**
+   * Gets the closest known count vector at or below the given power.
+   * @return power of the vector
+   */
+  unsigned long GetCheckpoint(const unsigned long power, Eigen::SparseVector<BigInteger>& vector) const;
+  bool GetCachedCount(const unsigned long power, BigInteger& count) const;
+  void CacheCounts(const std::vector<std::pair<unsigned long, BigInteger>>& counts, const unsigned long power,
+                   const Eigen::SparseVector<BigInteger>& vector) const;
+  void GetRecurrence(std::vector<BigInteger>& recurrence, std::vector<BigInteger>& initial_terms) const;
+
+  /**
+   * Computes the recurrence given by the component structure, terms start with the first power where the recurrence
+   * holds without transients, i.e., the number of rows of the matrix.
+   * @return false if there is a complex component on an accepting path
+   */
+  bool GetSCCRecurrence(std::vector<BigInteger>& recurrence, std::vector<BigInteger>& terms) const;
+
+  /**
+   * Runs the count iteration up to the given power modulo each of the moduli.
+   * @return count modulo each modulus
+   */
+  std::vector<std::uint64_t> CountModuli(const unsigned long power, const std::vector<std::uint64_t>& moduli) const;
+
+  /**
+   * Upper bound on the number of bits of the count at the given power, entries grow at most by the maximum row sum per step.
+   */
+  unsigned long GetCountBitBound(const unsigned long power) const;
+
+  /**
+   * Estimates whether successive squaring is cheaper than iterative multiplication.
+   */
+  bool IsMatrixMultiplicationCheaper(const unsigned long remaining_power) const;
+
+  /**
+   * Multiplies the count vector up to to_power starting from the closest checkpoint to from_power.
+   * visit is called with every power starting from from_power, sweep stops early when visit returns false.
+   * @return last visited power
+   */
+  unsigned long ForwardSweep(const unsigned long from_power, const unsigned long to_power, Eigen::SparseVector<BigInteger>& vector,
+                    std::function<bool(const unsigned long power, const Eigen::SparseVector<BigInteger>& vector)> visit) const;
+  static const std::size_t DEFAULT_CACHE_SIZE;
 private:
   static const int VLOG_LEVEL;
 };
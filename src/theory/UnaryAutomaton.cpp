@@ -365,9 +365,29 @@ void UnaryAutomaton::SetFormula(ArithmeticFormula_ptr formula) {
 	formula_ = formula;
 }
 
+/**
+ * Counts values less than 2^bound with lasso arithmetic instead of 2^bound matrix iterations
+ */
+BigInteger UnaryAutomaton::SymbolicCount(int bound, bool count_less_than_or_equal_to_bound) {
+  if (not is_counter_cached_) {
+    SetSymbolicCounter();
+  }
+  BigInteger result = counter_.CountUnary(static_cast<unsigned long>(bound), count_less_than_or_equal_to_bound);
+  DVLOG(VLOG_LEVEL) << "[" << this->id_ << "]->symbolic_count(" << bound << ") : " << result;
+  return result;
+}
+
+BigInteger UnaryAutomaton::SymbolicCount(double bound, bool count_less_than_or_equal_to_bound) {
+  return SymbolicCount(static_cast<int>(bound), count_less_than_or_equal_to_bound);
+}
+
 void UnaryAutomaton::decide_counting_schema(Eigen::SparseMatrix<BigInteger>& count_matrix) {
-  LOG(FATAL) << "Not tested";
   counter_.set_type(SymbolicCounter::Type::UNARYINT);
+  if (count_bound_exact_) {
+    count_matrix.insert(this->dfa_->ns, this->dfa_->ns) = 0;
+  } else {
+    count_matrix.insert(this->dfa_->ns, this->dfa_->ns) = 1;
+  }
 }
 
 } /* namespace Theory */
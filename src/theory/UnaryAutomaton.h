@@ -59,6 +59,9 @@ public:
   ArithmeticFormula_ptr GetFormula();
   void SetFormula(ArithmeticFormula_ptr formula);
 
+  BigInteger SymbolicCount(int bound, bool count_less_than_or_equal_to_bound = true) override;
+  BigInteger SymbolicCount(double bound, bool count_less_than_or_equal_to_bound = true) override;
+
 protected:
   void decide_counting_schema(Eigen::SparseMatrix<BigInteger>& count_matrix) override;
 
@@ -15,6 +15,7 @@ namespace Option {
 
 std::string Theory::TMP_PATH     = ".";
 std::string Theory::SCRIPT_PATH  = ".";
+std::string Theory::REGEX_CACHE_FILE = "";
 
 } /* namespace Option */
 } /* namespace Vlab */
@@ -20,6 +20,7 @@ class Theory {
 public:
   static std::string TMP_PATH;
   static std::string SCRIPT_PATH;
+  static std::string REGEX_CACHE_FILE;
 };
 
 } /* namespace Option */
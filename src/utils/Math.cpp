@@ -7,6 +7,10 @@
 
 #include "Math.h"
 
+#include <mutex>
+
+#include <glog/logging.h>
+
 namespace Vlab {
 namespace Util {
 namespace Math {
@@ -28,6 +32,199 @@ int lcm(int x, int y) {
   return x * y / gcd(x, y);
 }
 
+std::uint64_t pow_mod(std::uint64_t base, std::uint64_t exponent, const std::uint64_t modulus) {
+  std::uint64_t result = 1 % modulus;
+  base %= modulus;
+  while (exponent > 0) {
+    if (exponent & 1) {
+      result = mul_mod(result, base, modulus);
+    }
+    base = mul_mod(base, base, modulus);
+    exponent >>= 1;
+  }
+  return result;
+}
+
+/**
+ * Modulus is a prime here, hence inverse is x^(p-2)
+ */
+std::uint64_t inverse_mod(const std::uint64_t x, const std::uint64_t modulus) {
+  return pow_mod(x, modulus - 2, modulus);
+}
+
+bool is_prime(const std::uint64_t n) {
+  if (n < 2) {
+    return false;
+  }
+  // these bases are enough for all 64 bit numbers
+  static const std::uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  for (std::uint64_t p : bases) {
+    if (n % p == 0) {
+      return n == p;
+    }
+  }
+
+  std::uint64_t d = n - 1;
+  int s = 0;
+  while ((d & 1) == 0) {
+    d >>= 1;
+    ++s;
+  }
+
+  for (std::uint64_t a : bases) {
+    std::uint64_t x = pow_mod(a, d, n);
+    if (x == 1 or x == n - 1) {
+      continue;
+    }
+    bool is_composite = true;
+    for (int r = 1; r < s; ++r) {
+      x = mul_mod(x, x, n);
+      if (x == n - 1) {
+        is_composite = false;
+        break;
+      }
+    }
+    if (is_composite) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<std::uint64_t> get_large_primes(const std::size_t count) {
+  static std::mutex primes_mutex;
+  static std::vector<std::uint64_t> primes;
+
+  std::lock_guard<std::mutex> lock (primes_mutex);
+  std::uint64_t candidate = primes.empty() ? ((std::uint64_t(1) << 61) - 1) : (primes.back() - 2);
+  while (primes.size() < count) {
+    if (is_prime(candidate)) {
+      primes.push_back(candidate);
+    }
+    candidate -= 2;
+  }
+  return std::vector<std::uint64_t>(primes.begin(), primes.begin() + count);
+}
+
+Theory::BigInteger chinese_remainder(const std::vector<std::uint64_t>& residues, const std::vector<std::uint64_t>& moduli) {
+  Theory::BigInteger result = 0;
+  Theory::BigInteger product = 1;
+  for (std::size_t i = 0; i < moduli.size(); ++i) {
+    const std::uint64_t modulus = moduli[i];
+    const std::uint64_t result_mod = static_cast<std::uint64_t>(result % modulus);
+    const std::uint64_t product_mod = static_cast<std::uint64_t>(product % modulus);
+    const std::uint64_t difference = (residues[i] % modulus + modulus - result_mod) % modulus;
+    const std::uint64_t t = mul_mod(difference, inverse_mod(product_mod, modulus), modulus);
+    result += product * t;
+    product *= modulus;
+  }
+  return result;
+}
+
+std::vector<Theory::BigInteger> berlekamp_massey(const std::vector<Theory::BigInteger>& sequence) {
+  using Rational = boost::multiprecision::cpp_rational;
+  // connection polynomials, current (c) and the one before the last length change (b)
+  std::vector<Rational> c {1}, b {1};
+  Rational last_discrepancy = 1;
+  std::size_t length = 0, shift = 1;
+
+  for (std::size_t n = 0; n < sequence.size(); ++n) {
+    Rational discrepancy = sequence[n];
+    for (std::size_t i = 1; i <= length; ++i) {
+      discrepancy += c[i] * sequence[n - i];
+    }
+
+    if (discrepancy == 0) {
+      ++shift;
+      continue;
+    }
+
+    const Rational factor = discrepancy / last_discrepancy;
+    std::vector<Rational> previous_c = c;
+    if (c.size() < b.size() + shift) {
+      c.resize(b.size() + shift, 0);
+    }
+    for (std::size_t i = 0; i < b.size(); ++i) {
+      c[i + shift] -= factor * b[i];
+    }
+
+    if (2 * length <= n) {
+      length = n + 1 - length;
+      b = std::move(previous_c);
+      last_discrepancy = discrepancy;
+      shift = 1;
+    } else {
+      ++shift;
+    }
+  }
+
+  std::vector<Theory::BigInteger> recurrence (length);
+  for (std::size_t i = 1; i <= length; ++i) {
+    const Rational coefficient = (i < c.size()) ? Rational(-c[i]) : Rational(0);
+    CHECK_EQ(1, boost::multiprecision::denominator(coefficient)) << "recurrence is not integral";
+    recurrence[i - 1] = boost::multiprecision::numerator(coefficient);
+  }
+  return recurrence;
+}
+
+Theory::BigInteger linear_recurrence_term(const std::vector<Theory::BigInteger>& recurrence,
+                                          const std::vector<Theory::BigInteger>& initial_terms, const unsigned long n) {
+  const std::size_t degree = recurrence.size();
+  if (n < initial_terms.size()) {
+    return initial_terms[n];
+  } else if (degree == 0) {
+    return 0;
+  }
+
+  // multiplies two polynomials of degree < d and reduces the result with x^d = c[0] x^(d-1) + ... + c[d-1]
+  auto multiply_mod = [&recurrence, degree](const std::vector<Theory::BigInteger>& x, const std::vector<Theory::BigInteger>& y) {
+    std::vector<Theory::BigInteger> product (2 * degree - 1);
+    for (std::size_t i = 0; i < degree; ++i) {
+      if (x[i] == 0) {
+        continue;
+      }
+      for (std::size_t j = 0; j < degree; ++j) {
+        product[i + j] += x[i] * y[j];
+      }
+    }
+    for (std::size_t k = product.size() - 1; k >= degree; --k) {
+      if (product[k] == 0) {
+        continue;
+      }
+      for (std::size_t i = 0; i < degree; ++i) {
+        product[k - 1 - i] += product[k] * recurrence[i];
+      }
+    }
+    product.resize(degree);
+    return product;
+  };
+
+  std::vector<Theory::BigInteger> result (degree), base (degree);
+  result[0] = 1;
+  if (degree == 1) {
+    base[0] = recurrence[0];
+  } else {
+    base[1] = 1;
+  }
+
+  unsigned long power = n;
+  while (power > 0) {
+    if (power & 1) {
+      result = multiply_mod(result, base);
+    }
+    power >>= 1;
+    if (power > 0) {
+      base = multiply_mod(base, base);
+    }
+  }
+
+  Theory::BigInteger term = 0;
+  for (std::size_t i = 0; i < degree; ++i) {
+    term += result[i] * initial_terms[i];
+  }
+  return term;
+}
+
 } /* namespace Math */
 } /* namespace Util */
 } /* namespace Vlab */
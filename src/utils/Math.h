@@ -8,6 +8,7 @@
 #ifndef SRC_UTILS_MATH_H_
 #define SRC_UTILS_MATH_H_
 
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <thread>
@@ -32,6 +33,52 @@ using Matrix = std::vector<std::vector<T>>;
 int gcd(int x, int y);
 int lcm(int x, int y);
 
+/**
+ * Modular arithmetic on 64 bit words, modulus must be less than 2^63.
+ */
+inline std::uint64_t mul_mod(const std::uint64_t x, const std::uint64_t y, const std::uint64_t modulus) {
+  return static_cast<std::uint64_t>((static_cast<unsigned __int128>(x) * y) % modulus);
+}
+std::uint64_t pow_mod(std::uint64_t base, std::uint64_t exponent, const std::uint64_t modulus);
+std::uint64_t inverse_mod(const std::uint64_t x, const std::uint64_t modulus);
+
+/**
+ * Deterministic Miller-Rabin for 64 bit words.
+ */
+bool is_prime(const std::uint64_t n);
+
+/**
+ * Gets the largest primes below 2^61 in decreasing order, primes found once are kept for later calls.
+ * 61 bit primes leave room to accumulate 64 products in 128 bits before reducing.
+ * @param count number of primes
+ */
+std::vector<std::uint64_t> get_large_primes(const std::size_t count);
+
+/**
+ * Reconstructs the unique non-negative integer less than the product of moduli from its residues (Garner's algorithm).
+ */
+Theory::BigInteger chinese_remainder(const std::vector<std::uint64_t>& residues, const std::vector<std::uint64_t>& moduli);
+
+/**
+ * Finds the shortest linear recurrence s[n] = c[0] * s[n-1] + ... + c[d-1] * s[n-d] that generates
+ * the given sequence (Berlekamp-Massey over rationals). Coefficients are integral when the sequence is
+ * generated by an integer matrix, since the minimal polynomial divides its monic characteristic polynomial.
+ * @param sequence at least 2d terms of the sequence
+ * @return recurrence coefficients c
+ */
+std::vector<Theory::BigInteger> berlekamp_massey(const std::vector<Theory::BigInteger>& sequence);
+
+/**
+ * Computes the n-th term of a linear recurrence with Kitamasa's method, i.e., x^n mod characteristic polynomial
+ * by successive squaring, in O(d^2 log n) big integer operations.
+ * @param recurrence coefficients as returned by berlekamp_massey
+ * @param initial_terms at least d terms of the sequence
+ * @param n
+ * @return n-th term of the sequence
+ */
+Theory::BigInteger linear_recurrence_term(const std::vector<Theory::BigInteger>& recurrence,
+                                          const std::vector<Theory::BigInteger>& initial_terms, const unsigned long n);
+
 template <class T>
 Matrix<T> multiply_matrix(const Matrix<T>& x, const Matrix<T>& y) {
   unsigned r = x[0].size();
@@ -0,0 +1,133 @@
+/*
+ * PowerOfTwoMatrix.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "PowerOfTwoMatrix.h"
+
+#include <glog/logging.h>
+
+namespace Vlab {
+namespace Util {
+
+const std::string PowerOfTwoMatrix::SERIALIZATION_MAGIC = "abc-power-of-two-matrix";
+
+const int PowerOfTwoMatrix::SERIALIZATION_VERSION = 1;
+
+PowerOfTwoMatrix::PowerOfTwoMatrix() : num_of_rows_(0), num_of_cols_(0), row_offsets_ {0}, exponent_offsets_ {0} {
+}
+
+PowerOfTwoMatrix::PowerOfTwoMatrix(const Eigen::SparseMatrix<Theory::BigInteger>& sparse_matrix)
+    : num_of_rows_(sparse_matrix.rows()),
+      num_of_cols_(sparse_matrix.cols()),
+      row_offsets_(sparse_matrix.rows() + 1, 0),
+      exponent_offsets_ {0} {
+  // row major copy to visit entries row by row, explicit zeros are dropped
+  Eigen::SparseMatrix<Theory::BigInteger, Eigen::RowMajor> row_major_matrix = sparse_matrix;
+  for (int i = 0; i < row_major_matrix.outerSize(); ++i) {
+    for (Eigen::SparseMatrix<Theory::BigInteger, Eigen::RowMajor>::InnerIterator it(row_major_matrix, i); it; ++it) {
+      if (it.value() == 0) {
+        continue;
+      }
+      CHECK_GT(it.value(), 0) << "count matrix entries must be non-negative";
+      col_indices_.push_back(it.col());
+      Theory::BigInteger value = it.value();
+      for (std::uint32_t exponent = boost::multiprecision::lsb(value); value != 0; ++exponent) {
+        if (boost::multiprecision::bit_test(value, exponent)) {
+          exponents_.push_back(exponent);
+          boost::multiprecision::bit_unset(value, exponent);
+        }
+      }
+      exponent_offsets_.push_back(exponents_.size());
+    }
+    row_offsets_[i + 1] = col_indices_.size();
+  }
+}
+
+PowerOfTwoMatrix::~PowerOfTwoMatrix() {
+}
+
+std::size_t PowerOfTwoMatrix::rows() const {
+  return num_of_rows_;
+}
+
+std::size_t PowerOfTwoMatrix::cols() const {
+  return num_of_cols_;
+}
+
+std::size_t PowerOfTwoMatrix::nonZeros() const {
+  return col_indices_.size();
+}
+
+Eigen::SparseMatrix<Theory::BigInteger> PowerOfTwoMatrix::ToSparseMatrix() const {
+  std::vector<Eigen::Triplet<Theory::BigInteger>> entries;
+  entries.reserve(col_indices_.size());
+  for (std::uint32_t i = 0; i < num_of_rows_; ++i) {
+    for (std::uint32_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+      Theory::BigInteger value = 0;
+      for (std::uint32_t e = exponent_offsets_[k]; e < exponent_offsets_[k + 1]; ++e) {
+        boost::multiprecision::bit_set(value, exponents_[e]);
+      }
+      entries.push_back(Eigen::Triplet<Theory::BigInteger>(i, col_indices_[k], value));
+    }
+  }
+  Eigen::SparseMatrix<Theory::BigInteger> sparse_matrix (num_of_rows_, num_of_cols_);
+  sparse_matrix.setFromTriplets(entries.begin(), entries.end());
+  sparse_matrix.makeCompressed();
+  return sparse_matrix;
+}
+
+Eigen::SparseVector<Theory::BigInteger> PowerOfTwoMatrix::Multiply(const Eigen::SparseVector<Theory::BigInteger>& vector) const {
+  std::vector<Theory::BigInteger> dense_vector (num_of_cols_, 0), dense_result;
+  for (Eigen::SparseVector<Theory::BigInteger>::InnerIterator it(vector); it; ++it) {
+    dense_vector[it.index()] = it.value();
+  }
+  Multiply(dense_vector, dense_result);
+
+  Eigen::SparseVector<Theory::BigInteger> result (num_of_rows_);
+  for (std::uint32_t i = 0; i < num_of_rows_; ++i) {
+    if (dense_result[i] != 0) {
+      result.insertBack(i) = std::move(dense_result[i]);
+    }
+  }
+  return result;
+}
+
+void PowerOfTwoMatrix::Multiply(const std::vector<Theory::BigInteger>& vector, std::vector<Theory::BigInteger>& result) const {
+  result.assign(num_of_rows_, 0);
+  Theory::BigInteger term;
+  for (std::uint32_t i = 0; i < num_of_rows_; ++i) {
+    Theory::BigInteger& sum = result[i];
+    for (std::uint32_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+      const Theory::BigInteger& value = vector[col_indices_[k]];
+      if (value == 0) {
+        continue;
+      }
+      for (std::uint32_t e = exponent_offsets_[k]; e < exponent_offsets_[k + 1]; ++e) {
+        if (exponents_[e] == 0) {
+          sum += value;
+        } else {
+          term = value;
+          term <<= exponents_[e];
+          sum += term;
+        }
+      }
+    }
+  }
+}
+
+bool PowerOfTwoMatrix::IsValidOffsets(const std::vector<std::uint32_t>& offsets, const std::uint32_t size) {
+  if (offsets.empty() or offsets.front() != 0 or offsets.back() != size) {
+    return false;
+  }
+  for (std::size_t i = 1; i < offsets.size(); ++i) {
+    if (offsets[i] < offsets[i - 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} /* namespace Util */
+} /* namespace Vlab */
@@ -0,0 +1,130 @@
+/*
+ * PowerOfTwoMatrix.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_UTILS_POWEROFTWOMATRIX_H_
+#define SRC_UTILS_POWEROFTWOMATRIX_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../cereal/archives/binary.hpp"
+#include "../cereal/types/string.hpp"
+#include "../Eigen/SparseCore"
+#include "Math.h"
+
+namespace Vlab {
+namespace Util {
+
+/**
+ * Non-negative integer matrix in row major compressed form where each entry is kept as the list of exponents of its set
+ * bits. Entries of count matrices are sums of powers of two (one per bdd path), multiplication with a vector then
+ * needs only shifts and additions.
+ */
+class PowerOfTwoMatrix {
+ public:
+  PowerOfTwoMatrix();
+  PowerOfTwoMatrix(const Eigen::SparseMatrix<Theory::BigInteger>& sparse_matrix);
+  virtual ~PowerOfTwoMatrix();
+
+  std::size_t rows() const;
+  std::size_t cols() const;
+  std::size_t nonZeros() const;
+  Eigen::SparseMatrix<Theory::BigInteger> ToSparseMatrix() const;
+
+  /**
+   * Computes this * vector with shifts and additions.
+   */
+  Eigen::SparseVector<Theory::BigInteger> Multiply(const Eigen::SparseVector<Theory::BigInteger>& vector) const;
+  void Multiply(const std::vector<Theory::BigInteger>& vector, std::vector<Theory::BigInteger>& result) const;
+
+  /**
+   * Writes a format header before the matrix, see load
+   */
+  template <class Archive>
+  void save(Archive& ar) const {
+    const std::uint32_t non_zeros = col_indices_.size(), num_of_exponents = exponents_.size();
+    ar(SERIALIZATION_MAGIC, SERIALIZATION_VERSION);
+    ar(num_of_rows_);
+    ar(num_of_cols_);
+    ar(non_zeros);
+    ar(num_of_exponents);
+    ar(cereal::binary_data(row_offsets_.data(), row_offsets_.size() * sizeof(std::uint32_t)));
+    ar(cereal::binary_data(col_indices_.data(), non_zeros * sizeof(std::uint32_t)));
+    ar(cereal::binary_data(exponent_offsets_.data(), exponent_offsets_.size() * sizeof(std::uint32_t)));
+    ar(cereal::binary_data(exponents_.data(), num_of_exponents * sizeof(std::uint32_t)));
+  }
+
+  /**
+   * Throws cereal::Exception if the archive is not written by save in the current format, e.g., a count matrix
+   * serialized before matrices are kept as exponent lists, or if the matrix read is inconsistent: offsets that
+   * decrease or point past the entries, column indices out of range or sizes whose offsets cannot be indexed.
+   * The matrix is left unchanged on error.
+   */
+  template <class Archive>
+  void load(Archive& ar) {
+    std::string magic;
+    int version = 0;
+    ar(magic, version);
+    if (magic != SERIALIZATION_MAGIC or version != SERIALIZATION_VERSION) {
+      throw cereal::Exception("not a power of two matrix or unsupported version");
+    }
+    std::uint32_t num_of_rows = 0, num_of_cols = 0, non_zeros = 0, num_of_exponents = 0;
+    ar(num_of_rows);
+    ar(num_of_cols);
+    ar(non_zeros);
+    ar(num_of_exponents);
+    if (num_of_rows == std::numeric_limits<std::uint32_t>::max() or non_zeros == std::numeric_limits<std::uint32_t>::max()) {
+      throw cereal::Exception("corrupted power of two matrix, too many rows or entries");
+    }
+    std::vector<std::uint32_t> row_offsets (num_of_rows + 1), col_indices (non_zeros), exponent_offsets (non_zeros + 1),
+        exponents (num_of_exponents);
+    ar(cereal::binary_data(row_offsets.data(), row_offsets.size() * sizeof(std::uint32_t)));
+    ar(cereal::binary_data(col_indices.data(), non_zeros * sizeof(std::uint32_t)));
+    ar(cereal::binary_data(exponent_offsets.data(), exponent_offsets.size() * sizeof(std::uint32_t)));
+    ar(cereal::binary_data(exponents.data(), num_of_exponents * sizeof(std::uint32_t)));
+    if (not IsValidOffsets(row_offsets, non_zeros) or not IsValidOffsets(exponent_offsets, num_of_exponents)) {
+      throw cereal::Exception("corrupted power of two matrix, inconsistent offsets");
+    }
+    for (auto col : col_indices) {
+      if (col >= num_of_cols) {
+        throw cereal::Exception("corrupted power of two matrix, column index out of range");
+      }
+    }
+    num_of_rows_ = num_of_rows;
+    num_of_cols_ = num_of_cols;
+    row_offsets_.swap(row_offsets);
+    col_indices_.swap(col_indices);
+    exponent_offsets_.swap(exponent_offsets);
+    exponents_.swap(exponents);
+  }
+
+  static const std::string SERIALIZATION_MAGIC;
+  static const int SERIALIZATION_VERSION;
+
+ protected:
+  /**
+   * Checks offsets start at 0, never decrease and end at the given size
+   */
+  static bool IsValidOffsets(const std::vector<std::uint32_t>& offsets, const std::uint32_t size);
+
+  std::uint32_t num_of_rows_;
+  std::uint32_t num_of_cols_;
+  /**
+   * Entries of row i are at [row_offsets_[i], row_offsets_[i+1]), exponents of entry k are at
+   * [exponent_offsets_[k], exponent_offsets_[k+1]).
+   */
+  std::vector<std::uint32_t> row_offsets_;
+  std::vector<std::uint32_t> col_indices_;
+  std::vector<std::uint32_t> exponent_offsets_;
+  std::vector<std::uint32_t> exponents_;
+};
+
+} /* namespace Util */
+} /* namespace Vlab */
+
+#endif /* SRC_UTILS_POWEROFTWOMATRIX_H_ */
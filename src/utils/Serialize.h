@@ -12,6 +12,7 @@
 #include "../Eigen/SparseCore"
 #include "../cereal/archives/binary.hpp"
 #include "Math.h"
+#include "PowerOfTwoMatrix.h"
 
 namespace Vlab {
 namespace Util {
@@ -158,6 +159,19 @@ void load(Archive& ar, Eigen::SparseMatrix<Theory::BigInteger>& sparse_matrix) {
 
 }
 
+/**
+ * Count matrices are written as exponent lists, an entry 2^k takes 8 bytes instead of a full big integer
+ */
+template<class Archive>
+void save(Archive& ar, const PowerOfTwoMatrix& power_of_two_matrix) {
+  power_of_two_matrix.save(ar);
+}
+
+template<class Archive>
+void load(Archive& ar, PowerOfTwoMatrix& power_of_two_matrix) {
+  power_of_two_matrix.load(ar);
+}
+
 } /* namespace Serialize */
 } /* namespace Util */
 } /* namespace Vlab */
@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "vlab_cs_ucsb_edu_DriverProxy.h"
 #include "Driver.h"
@@ -41,16 +42,56 @@ jobject newBigInteger(JNIEnv *env, jstring value) {
   return big_integer;
 }
 
-void load_model_counter(JNIEnv *env, Vlab::Solver::ModelCounter& mc, jbyteArray model_counter) {
+Vlab::Theory::BigInteger getBigInteger(JNIEnv *env, jobject big_integer) {
+  jclass big_integer_class = env->FindClass("java/math/BigInteger");
+  jmethodID to_string = env->GetMethodID(big_integer_class, "toString", "()Ljava/lang/String;");
+  jstring value = (jstring)env->CallObjectMethod(big_integer, to_string);
+  const char* value_arr = env->GetStringUTFChars(value, JNI_FALSE);
+  Vlab::Theory::BigInteger result {value_arr};
+  env->ReleaseStringUTFChars(value, value_arr);
+  return result;
+}
+
+std::vector<unsigned long> get_bounds(JNIEnv *env, jlongArray bounds) {
+  jsize length = env->GetArrayLength(bounds);
+  jlong* buffer = env->GetLongArrayElements(bounds, nullptr);
+  std::vector<unsigned long> bound_vector (buffer, buffer + length);
+  env->ReleaseLongArrayElements(bounds, buffer, JNI_ABORT);
+  return bound_vector;
+}
+
+jobjectArray newBigIntegerArray(JNIEnv *env, const std::vector<Vlab::Theory::BigInteger>& values) {
+  jclass big_integer_class = env->FindClass("java/math/BigInteger");
+  jobjectArray big_integer_array = env->NewObjectArray(values.size(), big_integer_class, nullptr);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    std::stringstream ss;
+    ss << values[i];
+    jstring value_string = env->NewStringUTF(ss.str().c_str());
+    jobject big_integer = newBigInteger(env, value_string);
+    env->SetObjectArrayElement(big_integer_array, i, big_integer);
+    env->DeleteLocalRef(big_integer);
+    env->DeleteLocalRef(value_string);
+  }
+  return big_integer_array;
+}
+
+/**
+ * Throws IllegalArgumentException and returns false if the bytes are not a serialized model counter
+ */
+bool load_model_counter(JNIEnv *env, Vlab::Solver::ModelCounter& mc, jbyteArray model_counter) {
   jsize length = env->GetArrayLength(model_counter);
   jbyte* buffer = env->GetByteArrayElements(model_counter, nullptr);
   std::string bin_model_counter_str (const_cast<char*>(reinterpret_cast<char*>(buffer)), length);
+  env->ReleaseByteArrayElements(model_counter, buffer, JNI_ABORT);
   std::stringstream is (bin_model_counter_str);
-  {
+  try {
     cereal::BinaryInputArchive ar(is);
     mc.load(ar);
+  } catch (const cereal::Exception& e) {
+    env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), e.what());
+    return false;
   }
-  env->ReleaseByteArrayElements(model_counter, buffer, JNI_ABORT);
+  return true;
 }
 
 /*
@@ -193,6 +234,48 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ
   return newBigInteger(env, result_string);
 }
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countVariable
+ * Signature: (Ljava/lang/String;[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countVariable__Ljava_lang_String_2_3J
+  (JNIEnv *env, jobject obj, jstring var_name, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  auto results = abc_driver->CountVariable(var_name_str, get_bounds(env, bounds));
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  return newBigIntegerArray(env, results);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countInts
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countInts___3J
+  (JNIEnv *env, jobject obj, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  auto results = abc_driver->CountInts(get_bounds(env, bounds));
+  return newBigIntegerArray(env, results);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countStrs
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs___3J
+  (JNIEnv *env, jobject obj, jlongArray bounds) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  auto results = abc_driver->CountStrs(get_bounds(env, bounds));
+  return newBigIntegerArray(env, results);
+}
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    getModelCounterForVariable
@@ -247,7 +330,9 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countVariable__Ljava
   (JNIEnv *env, jobject obj, jstring var_name, jlong bound, jbyteArray model_counter) {
 
   Vlab::Solver::ModelCounter mc;
-  load_model_counter(env, mc, model_counter);
+  if (not load_model_counter(env, mc, model_counter)) {
+    return nullptr;
+  }
   auto result = mc.Count(bound, bound);
   std::stringstream ss;
   ss << result;
@@ -264,7 +349,9 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countInts__J_3B
   (JNIEnv *env, jobject obj, jlong bound, jbyteArray model_counter) {
 
   Vlab::Solver::ModelCounter mc;
-  load_model_counter(env, mc, model_counter);
+  if (not load_model_counter(env, mc, model_counter)) {
+    return nullptr;
+  }
   auto result = mc.CountInts(bound);
   std::stringstream ss;
   ss << result;
@@ -281,7 +368,9 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs__J_3B
   (JNIEnv *env, jobject obj, jlong bound, jbyteArray model_counter) {
 
   Vlab::Solver::ModelCounter mc;
-  load_model_counter(env, mc, model_counter);
+  if (not load_model_counter(env, mc, model_counter)) {
+    return nullptr;
+  }
   auto result = mc.CountStrs(bound);
   std::stringstream ss;
   ss << result;
@@ -298,7 +387,9 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ_3B
   (JNIEnv *env, jobject obj, jlong int_bound, jlong str_bound, jbyteArray model_counter) {
 
   Vlab::Solver::ModelCounter mc;
-  load_model_counter(env, mc, model_counter);
+  if (not load_model_counter(env, mc, model_counter)) {
+    return nullptr;
+  }
   auto result = mc.Count(int_bound, str_bound);
   std::stringstream ss;
   ss << result;
@@ -416,6 +507,129 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getSatisfyingExample
   return map;
 }
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    initModelIterator
+ * Signature: (Ljava/lang/String;J)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_initModelIterator
+  (JNIEnv *env, jobject obj, jstring var_name, jlong bound) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  // a negative bound wraps around to the largest bound, i.e., no bound
+  abc_driver->InitializeModelIterator(var_name_str, static_cast<unsigned long>(bound));
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getNextModel
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getNextModel
+  (JNIEnv *env, jobject obj, jstring var_name) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  std::string model;
+  bool has_model = abc_driver->GetNextModel(var_name_str, model);
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  if (not has_model) {
+    return nullptr;
+  }
+  return env->NewStringUTF(model.c_str());
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    sampleModel
+ * Signature: (Ljava/lang/String;J)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_sampleModel
+  (JNIEnv *env, jobject obj, jstring var_name, jlong bound) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  std::string model;
+  bool has_model = abc_driver->SampleModel(var_name_str, bound, model);
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  if (not has_model) {
+    return nullptr;
+  }
+  return env->NewStringUTF(model.c_str());
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countModelsForRanking
+ * Signature: (Ljava/lang/String;J)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countModelsForRanking
+  (JNIEnv *env, jobject obj, jstring var_name, jlong bound) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  auto result = abc_driver->CountModelsForRanking(var_name_str, bound);
+  std::stringstream ss;
+  ss << result;
+  jstring result_string = env->NewStringUTF(ss.str().c_str());
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  return newBigInteger(env, result_string);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    rankModel
+ * Signature: (Ljava/lang/String;Ljava/lang/String;J)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_rankModel
+  (JNIEnv *env, jobject obj, jstring var_name, jstring model, jlong bound) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  const char* model_arr = env->GetStringUTFChars(model, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  std::string model_str {model_arr};
+  Vlab::Theory::BigInteger result;
+  bool is_model = abc_driver->RankModel(var_name_str, model_str, bound, result);
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  env->ReleaseStringUTFChars(model, model_arr);
+  if (not is_model) {
+    env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "not a model within the bound");
+    return nullptr;
+  }
+  std::stringstream ss;
+  ss << result;
+  jstring result_string = env->NewStringUTF(ss.str().c_str());
+  return newBigInteger(env, result_string);
+}
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    unrankModel
+ * Signature: (Ljava/lang/String;Ljava/math/BigInteger;J)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_unrankModel
+  (JNIEnv *env, jobject obj, jstring var_name, jobject rank, jlong bound) {
+
+  Vlab::Driver *abc_driver = getHandle<Vlab::Driver>(env, obj);
+  const char* var_name_arr = env->GetStringUTFChars(var_name, JNI_FALSE);
+  std::string var_name_str {var_name_arr};
+  std::string model;
+  bool has_model = abc_driver->UnrankModel(var_name_str, getBigInteger(env, rank), bound, model);
+  env->ReleaseStringUTFChars(var_name, var_name_arr);
+  if (not has_model) {
+    env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "rank is out of range");
+    return nullptr;
+  }
+  return env->NewStringUTF(model.c_str());
+}
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    reset
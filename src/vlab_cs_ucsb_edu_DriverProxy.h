@@ -79,6 +79,30 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs__J
 JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_count__JJ
   (JNIEnv *, jobject, jlong, jlong);
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countVariable
+ * Signature: (Ljava/lang/String;[J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countVariable__Ljava_lang_String_2_3J
+  (JNIEnv *, jobject, jstring, jlongArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countInts
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countInts___3J
+  (JNIEnv *, jobject, jlongArray);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countStrs
+ * Signature: ([J)[Ljava/math/BigInteger;
+ */
+JNIEXPORT jobjectArray JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countStrs___3J
+  (JNIEnv *, jobject, jlongArray);
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    getModelCounterForVariable
@@ -167,6 +191,54 @@ JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getSatisfyingExample
 JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getSatisfyingExamplesRandomBounded
   (JNIEnv *, jobject, jint);
 
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    initModelIterator
+ * Signature: (Ljava/lang/String;J)V
+ */
+JNIEXPORT void JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_initModelIterator
+  (JNIEnv *, jobject, jstring, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    getNextModel
+ * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_getNextModel
+  (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    sampleModel
+ * Signature: (Ljava/lang/String;J)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_sampleModel
+  (JNIEnv *, jobject, jstring, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    countModelsForRanking
+ * Signature: (Ljava/lang/String;J)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_countModelsForRanking
+  (JNIEnv *, jobject, jstring, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    rankModel
+ * Signature: (Ljava/lang/String;Ljava/lang/String;J)Ljava/math/BigInteger;
+ */
+JNIEXPORT jobject JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_rankModel
+  (JNIEnv *, jobject, jstring, jstring, jlong);
+
+/*
+ * Class:     vlab_cs_ucsb_edu_DriverProxy
+ * Method:    unrankModel
+ * Signature: (Ljava/lang/String;Ljava/math/BigInteger;J)Ljava/lang/String;
+ */
+JNIEXPORT jstring JNICALL Java_vlab_cs_ucsb_edu_DriverProxy_unrankModel
+  (JNIEnv *, jobject, jstring, jobject, jlong);
+
 /*
  * Class:     vlab_cs_ucsb_edu_DriverProxy
  * Method:    reset
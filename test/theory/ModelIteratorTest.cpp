@@ -0,0 +1,105 @@
+/*
+ * ModelIteratorTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "ModelIteratorTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void ModelIteratorTest::SetUp() {
+  Automaton::SetCountBoundExact(false);
+  // regexes are parsed as the solver does, '|' is union
+  Util::RegularExpression::DEFAULT = Util::RegularExpression::COMPLEMENT | Util::RegularExpression::EMPTY
+      | Util::RegularExpression::ANYSTRING;
+}
+
+void ModelIteratorTest::TearDown() {
+}
+
+std::vector<std::string> ModelIteratorTest::GetModels(StringAutomaton_ptr string_auto, ModelIterator_ptr model_iterator) {
+  std::vector<std::string> models;
+  std::vector<bool> word;
+  std::string model;
+  while (model_iterator->Next(word)) {
+    if (string_auto->DecodeModel(word, model)) {
+      models.push_back(model);
+    }
+  }
+  return models;
+}
+
+std::vector<std::string> ModelIteratorTest::GetModels(const std::string regex, const unsigned long bound) {
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto(regex);
+  ModelIterator_ptr model_iterator = string_auto->GetModelIterator(bound);
+  auto models = GetModels(string_auto, model_iterator);
+  delete model_iterator;
+  delete string_auto;
+  return models;
+}
+
+TEST_F(ModelIteratorTest, LengthLexicographicOrder) {
+  EXPECT_THAT(GetModels("(a|b){0,2}", 2), ElementsAre("", "a", "b", "aa", "ab", "ba", "bb"));
+  EXPECT_THAT(GetModels("ba|c|ab|a", 5), ElementsAre("a", "c", "ab", "ba"));
+  EXPECT_THAT(GetModels("[x-z]*", 1), ElementsAre("", "x", "y", "z"));
+  EXPECT_THAT(GetModels("a*", 0), ElementsAre(""));
+}
+
+TEST_F(ModelIteratorTest, NoModels) {
+  EXPECT_THAT(GetModels("#", 10), IsEmpty());
+  EXPECT_THAT(GetModels("abc", 2), IsEmpty());
+}
+
+TEST_F(ModelIteratorTest, MatchesCount) {
+  for (auto regex : {"[a-c]{1,3}d?", "(ab|c)*", ".a"}) {
+    StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto(regex);
+    const BigInteger count = string_auto->GetSymbolicCounter().Count(3);
+    delete string_auto;
+    auto models = GetModels(regex, 3);
+    EXPECT_EQ(count, BigInteger(models.size())) << regex;
+    // models are distinct and sorted, shorter ones first
+    for (std::size_t i = 1; i < models.size(); ++i) {
+      EXPECT_TRUE(models[i - 1].size() < models[i].size()
+                  or (models[i - 1].size() == models[i].size() and models[i - 1] < models[i])) << regex;
+    }
+  }
+}
+
+TEST_F(ModelIteratorTest, ResumeFrom) {
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto("[a-d]{1,2}");
+  ModelIterator_ptr model_iterator = string_auto->GetModelIterator(2);
+  auto all_models = GetModels(string_auto, model_iterator);
+  delete model_iterator;
+  ASSERT_EQ(20, all_models.size());
+
+  model_iterator = string_auto->GetModelIterator(2);
+  std::vector<bool> word;
+  for (int i = 0; i < 7; ++i) {
+    ASSERT_TRUE(model_iterator->Next(word));
+  }
+  const std::vector<bool> cursor = model_iterator->GetCursor();
+  delete model_iterator;
+
+  model_iterator = string_auto->GetModelIterator(2);
+  model_iterator->ResumeFrom(cursor);
+  EXPECT_EQ(std::vector<std::string>(all_models.begin() + 7, all_models.end()), GetModels(string_auto, model_iterator));
+  delete model_iterator;
+
+  // a cursor that is not a model continues with the next model after it
+  std::vector<bool> non_model;
+  ASSERT_TRUE(string_auto->EncodeWord("bz", 2, non_model));
+  model_iterator = string_auto->GetModelIterator(2);
+  model_iterator->ResumeFrom(non_model);
+  EXPECT_THAT(GetModels(string_auto, model_iterator), ElementsAre("ca", "cb", "cc", "cd", "da", "db", "dc", "dd"));
+  delete model_iterator;
+  delete string_auto;
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
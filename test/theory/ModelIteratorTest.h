@@ -0,0 +1,42 @@
+/*
+ * ModelIteratorTest.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef THEORY_MODELITERATORTEST_H_
+#define THEORY_MODELITERATORTEST_H_
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/ModelIterator.h"
+#include "theory/StringAutomaton.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class ModelIteratorTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Reads the remaining models of the iterator
+   */
+  static std::vector<std::string> GetModels(StringAutomaton_ptr string_auto, ModelIterator_ptr model_iterator);
+
+  /**
+   * Reads all models of the regex up to the bound
+   */
+  static std::vector<std::string> GetModels(const std::string regex, const unsigned long bound);
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_MODELITERATORTEST_H_ */
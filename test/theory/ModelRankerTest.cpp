@@ -0,0 +1,106 @@
+/*
+ * ModelRankerTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "ModelRankerTest.h"
+
+#include <map>
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void ModelRankerTest::SetUp() {
+  Automaton::SetCountBoundExact(false);
+  // same syntax flags as the solver, without the intersection flag
+  Util::RegularExpression::DEFAULT = Util::RegularExpression::COMPLEMENT | Util::RegularExpression::EMPTY
+      | Util::RegularExpression::ANYSTRING;
+}
+
+void ModelRankerTest::TearDown() {
+}
+
+/**
+ * Unranking every index gives the models in lexicographic order, ranking them gives the indices back
+ */
+TEST_F(ModelRankerTest, RankUnrankRoundTrip) {
+  for (auto regex : {"[a-c]{1,3}d?", "(ab|c)*", "a*", "x"}) {
+    StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto(regex);
+    const BigInteger count = string_auto->GetSymbolicCounter().Count(4);
+    ModelRanker_ptr model_ranker = string_auto->GetModelRanker(4);
+    ASSERT_EQ(count, model_ranker->GetNumberOfModels()) << regex;
+
+    std::string previous_model;
+    std::vector<bool> word;
+    for (BigInteger index = 0; index < count; ++index) {
+      ASSERT_TRUE(model_ranker->Unrank(index, word)) << regex << " " << index;
+      const std::string model = string_auto->DecodeWord(word);
+      if (index > 0) {
+        EXPECT_LT(previous_model, model) << regex;
+      }
+      BigInteger rank;
+      ASSERT_TRUE(model_ranker->Rank(word, rank)) << regex << " " << model;
+      EXPECT_EQ(index, rank) << regex << " " << model;
+      previous_model = model;
+    }
+    delete model_ranker;
+    delete string_auto;
+  }
+}
+
+TEST_F(ModelRankerTest, RejectsInvalidInput) {
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto("ab*");
+  ModelRanker_ptr model_ranker = string_auto->GetModelRanker(3);
+  ASSERT_EQ(BigInteger(3), model_ranker->GetNumberOfModels());
+
+  std::vector<bool> word;
+  BigInteger rank;
+  ASSERT_TRUE(string_auto->EncodeWord("ba", 0, word));
+  EXPECT_FALSE(model_ranker->Rank(word, rank));
+  ASSERT_TRUE(string_auto->EncodeWord("abbb", 0, word));
+  EXPECT_FALSE(model_ranker->Rank(word, rank));
+  EXPECT_FALSE(model_ranker->Rank(std::vector<bool>(3, true), rank));
+  ASSERT_TRUE(string_auto->EncodeWord("abb", 0, word));
+  EXPECT_TRUE(model_ranker->Rank(word, rank));
+  EXPECT_EQ(BigInteger(2), rank);
+
+  EXPECT_FALSE(model_ranker->Unrank(3, word));
+  EXPECT_FALSE(model_ranker->Unrank(-1, word));
+  delete model_ranker;
+  delete string_auto;
+
+  StringAutomaton_ptr phi_auto = StringAutomaton::MakePhi();
+  model_ranker = phi_auto->GetModelRanker(3);
+  std::mt19937_64 generator (42);
+  EXPECT_EQ(BigInteger(0), model_ranker->GetNumberOfModels());
+  EXPECT_FALSE(model_ranker->Sample(generator, word));
+  EXPECT_FALSE(model_ranker->Unrank(0, word));
+  delete model_ranker;
+  delete phi_auto;
+}
+
+TEST_F(ModelRankerTest, Sample) {
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto("[a-d]");
+  ModelRanker_ptr model_ranker = string_auto->GetModelRanker(1);
+  std::mt19937_64 generator (42);
+  std::map<std::string, int> frequencies;
+  std::vector<bool> word;
+  for (int i = 0; i < 400; ++i) {
+    ASSERT_TRUE(model_ranker->Sample(generator, word));
+    ++frequencies[string_auto->DecodeWord(word)];
+  }
+  EXPECT_THAT(frequencies, ElementsAre(Key("a"), Key("b"), Key("c"), Key("d")));
+  for (auto& entry : frequencies) {
+    EXPECT_GT(entry.second, 50) << entry.first;
+  }
+  delete model_ranker;
+  delete string_auto;
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
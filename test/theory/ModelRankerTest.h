@@ -0,0 +1,33 @@
+/*
+ * ModelRankerTest.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef THEORY_MODELRANKERTEST_H_
+#define THEORY_MODELRANKERTEST_H_
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/ModelRanker.h"
+#include "theory/StringAutomaton.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class ModelRankerTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_MODELRANKERTEST_H_ */
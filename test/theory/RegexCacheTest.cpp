@@ -0,0 +1,163 @@
+/*
+ * RegexCacheTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "RegexCacheTest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "cereal/archives/binary.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+namespace {
+
+class PublicStringAutomaton : public StringAutomaton {
+ public:
+  using StringAutomaton::DEFAULT_NUM_OF_VARIABLES;
+};
+
+class PublicRegexCache : public RegexCache {
+ public:
+  using RegexCache::FILE_MAGIC;
+  using RegexCache::FILE_VERSION;
+};
+
+}
+
+using namespace ::testing;
+
+void RegexCacheTest::SetUp() {
+  file_name_ = ::testing::TempDir() + "abc_regex_cache_test.bin";
+  compute_count_ = 0;
+  RegexCache::Instance().Clear();
+}
+
+void RegexCacheTest::TearDown() {
+  RegexCache::Instance().set_capacity(RegexCache::DEFAULT_CAPACITY);
+  RegexCache::Instance().Clear();
+  std::remove(file_name_.c_str());
+}
+
+StringAutomaton_ptr RegexCacheTest::GetOrCompute(const std::string regex) {
+  return RegexCache::Instance().GetOrCompute(regex, Util::RegularExpression::DEFAULT,
+      PublicStringAutomaton::DEFAULT_NUM_OF_VARIABLES, [this, &regex]() {
+    ++compute_count_;
+    Util::RegularExpression regular_expression (regex);
+    return StringAutomaton::MakeRegexAuto(&regular_expression);
+  });
+}
+
+TEST_F(RegexCacheTest, GetOrCompute) {
+  const unsigned long hits = RegexCache::Instance().GetStatistics().hits;
+  StringAutomaton_ptr first_auto = GetOrCompute("(ab)*c");
+  StringAutomaton_ptr second_auto = GetOrCompute("(ab)*c");
+  EXPECT_EQ(1, compute_count_);
+  EXPECT_TRUE(first_auto->IsEqual(second_auto));
+  EXPECT_EQ(hits + 1, RegexCache::Instance().GetStatistics().hits);
+  EXPECT_EQ(1, RegexCache::Instance().GetStatistics().size);
+  delete first_auto;
+  delete second_auto;
+}
+
+TEST_F(RegexCacheTest, SaveLoadRoundTrip) {
+  const std::vector<std::string> regexes {"(ab)*c", "[a-z]+@[a-z]+", "#", ".{2,5}", "(a|b)?x{3,}"};
+  std::vector<StringAutomaton_ptr> expected_autos;
+  for (auto& regex : regexes) {
+    expected_autos.push_back(GetOrCompute(regex));
+  }
+  EXPECT_TRUE(RegexCache::Instance().HasUnsavedEntries());
+  ASSERT_TRUE(RegexCache::Instance().Save(file_name_));
+  EXPECT_FALSE(RegexCache::Instance().HasUnsavedEntries());
+
+  RegexCache::Instance().Clear();
+  EXPECT_EQ(0, RegexCache::Instance().GetStatistics().size);
+  ASSERT_TRUE(RegexCache::Instance().Load(file_name_));
+  EXPECT_EQ(regexes.size(), RegexCache::Instance().GetStatistics().size);
+  EXPECT_FALSE(RegexCache::Instance().HasUnsavedEntries());
+
+  compute_count_ = 0;
+  for (std::size_t i = 0; i < regexes.size(); ++i) {
+    StringAutomaton_ptr loaded_auto = GetOrCompute(regexes[i]);
+    EXPECT_TRUE(loaded_auto->IsEqual(expected_autos[i])) << regexes[i];
+    delete loaded_auto;
+    delete expected_autos[i];
+  }
+  EXPECT_EQ(0, compute_count_);
+}
+
+TEST_F(RegexCacheTest, LoadRejectsOtherFiles) {
+  EXPECT_FALSE(RegexCache::Instance().Load(file_name_));
+
+  {
+    std::ofstream out (file_name_, std::ios::binary);
+  }
+  EXPECT_FALSE(RegexCache::Instance().Load(file_name_));
+
+  {
+    std::ofstream out (file_name_, std::ios::binary);
+    out << "not a regex cache file";
+  }
+  EXPECT_FALSE(RegexCache::Instance().Load(file_name_));
+  EXPECT_EQ(0, RegexCache::Instance().GetStatistics().size);
+}
+
+TEST_F(RegexCacheTest, Capacity) {
+  RegexCache::Instance().set_capacity(2);
+  for (auto regex : {"a+", "b+", "a+", "c+"}) {
+    delete GetOrCompute(regex);
+  }
+  // b+ is the least recently used one
+  EXPECT_EQ(2, RegexCache::Instance().GetStatistics().size);
+  compute_count_ = 0;
+  delete GetOrCompute("a+");
+  delete GetOrCompute("c+");
+  EXPECT_EQ(0, compute_count_);
+  delete GetOrCompute("b+");
+  EXPECT_EQ(1, compute_count_);
+
+  RegexCache::Instance().set_capacity(0);
+  EXPECT_EQ(0, RegexCache::Instance().GetStatistics().size);
+  delete GetOrCompute("a+");
+  EXPECT_EQ(0, RegexCache::Instance().GetStatistics().size);
+}
+
+TEST_F(RegexCacheTest, LoadSkipsCorruptedEntries) {
+  const int number_of_bdd_variables = PublicStringAutomaton::DEFAULT_NUM_OF_VARIABLES;
+  const std::string valid_cube (number_of_bdd_variables, 'X');
+  {
+    // one state accepting everything, with a bad cube char, too many states, too many bdd variables and a valid one
+    std::ofstream out (file_name_, std::ios::binary);
+    cereal::BinaryOutputArchive ar(out);
+    ar(PublicRegexCache::FILE_MAGIC, PublicRegexCache::FILE_VERSION, std::size_t(4));
+    ar(std::string("bad cube"), Util::RegularExpression::DEFAULT, number_of_bdd_variables);
+    ar(1, 0, std::vector<int> {1}, std::vector<int> {1}, std::vector<int> {0}, std::string(number_of_bdd_variables, '2'));
+    ar(std::string("too many states"), Util::RegularExpression::DEFAULT, number_of_bdd_variables);
+    ar(1 << 30, 0, std::vector<int> {1}, std::vector<int> {1}, std::vector<int> {0}, valid_cube);
+    ar(std::string("too many bdd variables"), Util::RegularExpression::DEFAULT, 1 << 20);
+    ar(1, 0, std::vector<int> {1}, std::vector<int> {1}, std::vector<int> {0}, std::string(1 << 20, 'X'));
+    ar(std::string("@"), Util::RegularExpression::DEFAULT, number_of_bdd_variables);
+    ar(1, 0, std::vector<int> {1}, std::vector<int> {1}, std::vector<int> {0}, valid_cube);
+  }
+  ASSERT_TRUE(RegexCache::Instance().Load(file_name_));
+  EXPECT_EQ(1, RegexCache::Instance().GetStatistics().size);
+
+  StringAutomaton_ptr loaded_auto = GetOrCompute("@");
+  StringAutomaton_ptr any_string_auto = StringAutomaton::MakeAnyString();
+  EXPECT_EQ(0, compute_count_);
+  EXPECT_TRUE(loaded_auto->IsEqual(any_string_auto));
+  delete any_string_auto;
+  delete loaded_auto;
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
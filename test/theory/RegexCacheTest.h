@@ -0,0 +1,41 @@
+/*
+ * RegexCacheTest.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef THEORY_REGEXCACHETEST_H_
+#define THEORY_REGEXCACHETEST_H_
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/RegexCache.h"
+#include "theory/StringAutomaton.h"
+#include "utils/RegularExpression.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class RegexCacheTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Gets the automaton of the regex from the cache, compute_count_ counts the misses
+   */
+  StringAutomaton_ptr GetOrCompute(const std::string regex);
+
+  std::string file_name_;
+  int compute_count_;
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_REGEXCACHETEST_H_ */
@@ -0,0 +1,140 @@
+/*
+ * RegexCompilerTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "RegexCompilerTest.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void RegexCompilerTest::SetUp() {
+  // syntax flags set by the solver, see main.cpp
+  Util::RegularExpression::DEFAULT = Util::RegularExpression::COMPLEMENT | Util::RegularExpression::EMPTY
+      | Util::RegularExpression::ANYSTRING;
+}
+
+void RegexCompilerTest::TearDown() {
+}
+
+StringAutomaton_ptr RegexCompilerTest::Compile(const std::string regex) {
+  Util::RegularExpression regular_expression (regex);
+  EXPECT_TRUE(RegexCompiler::IsSupported(&regular_expression)) << regex;
+  return StringAutomaton::MakeRegexAuto(&regular_expression);
+}
+
+void RegexCompilerTest::ExpectSameLanguage(StringAutomaton_ptr actual_auto, StringAutomaton_ptr expected_auto) {
+  EXPECT_TRUE(actual_auto->IsEqual(expected_auto));
+  delete actual_auto;
+  delete expected_auto;
+}
+
+StringAutomaton_ptr RegexCompilerTest::Union(StringAutomaton_ptr left_auto, StringAutomaton_ptr right_auto) {
+  StringAutomaton_ptr result_auto = left_auto->Union(right_auto);
+  delete left_auto;
+  delete right_auto;
+  return result_auto;
+}
+
+StringAutomaton_ptr RegexCompilerTest::Concat(StringAutomaton_ptr left_auto, StringAutomaton_ptr right_auto) {
+  StringAutomaton_ptr result_auto = left_auto->Concat(right_auto);
+  delete left_auto;
+  delete right_auto;
+  return result_auto;
+}
+
+StringAutomaton_ptr RegexCompilerTest::Star(StringAutomaton_ptr string_auto) {
+  StringAutomaton_ptr result_auto = string_auto->KleeneClosure();
+  delete string_auto;
+  return result_auto;
+}
+
+StringAutomaton_ptr RegexCompilerTest::Plus(StringAutomaton_ptr string_auto) {
+  StringAutomaton_ptr result_auto = string_auto->Closure();
+  delete string_auto;
+  return result_auto;
+}
+
+StringAutomaton_ptr RegexCompilerTest::Optional(StringAutomaton_ptr string_auto) {
+  StringAutomaton_ptr result_auto = string_auto->Optional();
+  delete string_auto;
+  return result_auto;
+}
+
+TEST_F(RegexCompilerTest, UnionAndConcat) {
+  ExpectSameLanguage(Compile("a|b"), Union(StringAutomaton::MakeString("a"), StringAutomaton::MakeString("b")));
+  ExpectSameLanguage(Compile("ab(c|de)"),
+                     Concat(StringAutomaton::MakeString("ab"),
+                            Union(StringAutomaton::MakeString("c"), StringAutomaton::MakeString("de"))));
+}
+
+TEST_F(RegexCompilerTest, NestedStars) {
+  ExpectSameLanguage(Compile("(a*b*)*"), Star(Union(StringAutomaton::MakeString("a"), StringAutomaton::MakeString("b"))));
+  ExpectSameLanguage(Compile("((ab)*c)*"),
+                     Star(Concat(Star(StringAutomaton::MakeString("ab")), StringAutomaton::MakeString("c"))));
+  ExpectSameLanguage(Compile("(a+)+b"), Concat(Plus(StringAutomaton::MakeString("a")), StringAutomaton::MakeString("b")));
+}
+
+TEST_F(RegexCompilerTest, NullableOperands) {
+  ExpectSameLanguage(Compile("(a?|b*)c"),
+                     Concat(Union(Optional(StringAutomaton::MakeString("a")), Star(StringAutomaton::MakeString("b"))),
+                            StringAutomaton::MakeString("c")));
+  ExpectSameLanguage(Compile("(a?)*"), Star(StringAutomaton::MakeString("a")));
+  ExpectSameLanguage(Compile("(a?b?)+"), Star(Union(StringAutomaton::MakeString("a"), StringAutomaton::MakeString("b"))));
+}
+
+TEST_F(RegexCompilerTest, BoundedRepeat) {
+  ExpectSameLanguage(Compile("(ab){1,2}"), Union(StringAutomaton::MakeString("ab"), StringAutomaton::MakeString("abab")));
+  ExpectSameLanguage(Compile("a{2,}"), Concat(StringAutomaton::MakeString("aa"), Star(StringAutomaton::MakeString("a"))));
+  ExpectSameLanguage(Compile("(a?){2}"),
+                     Union(StringAutomaton::MakeEmptyString(),
+                           Union(StringAutomaton::MakeString("a"), StringAutomaton::MakeString("aa"))));
+}
+
+TEST_F(RegexCompilerTest, CharRanges) {
+  ExpectSameLanguage(Compile("[a-c]"), StringAutomaton::MakeCharRange('a', 'c'));
+  ExpectSameLanguage(Compile("[a-c][b-z]+"),
+                     Concat(StringAutomaton::MakeCharRange('a', 'c'), Plus(StringAutomaton::MakeCharRange('b', 'z'))));
+  ExpectSameLanguage(Compile("[a-c]|[b-d]"), StringAutomaton::MakeCharRange('a', 'd'));
+}
+
+TEST_F(RegexCompilerTest, AnyCharAndAnyString) {
+  ExpectSameLanguage(Compile("."), StringAutomaton::MakeAnyChar());
+  ExpectSameLanguage(Compile("a.b"),
+                     Concat(Concat(StringAutomaton::MakeString("a"), StringAutomaton::MakeAnyChar()),
+                            StringAutomaton::MakeString("b")));
+  ExpectSameLanguage(Compile("@"), StringAutomaton::MakeAnyString());
+  ExpectSameLanguage(Compile("a@"), Concat(StringAutomaton::MakeString("a"), StringAutomaton::MakeAnyString()));
+  ExpectSameLanguage(Compile(".*"), StringAutomaton::MakeAnyString());
+}
+
+TEST_F(RegexCompilerTest, Empty) {
+  ExpectSameLanguage(Compile("#"), StringAutomaton::MakePhi());
+  ExpectSameLanguage(Compile("a#"), StringAutomaton::MakePhi());
+  ExpectSameLanguage(Compile("#|b"), StringAutomaton::MakeString("b"));
+  ExpectSameLanguage(Compile("#*"), StringAutomaton::MakeEmptyString());
+}
+
+TEST_F(RegexCompilerTest, FallbackAboveMaxNumberOfPositions) {
+  Util::RegularExpression regular_expression ("a{5000}");
+  EXPECT_FALSE(RegexCompiler::IsSupported(&regular_expression));
+  ExpectSameLanguage(StringAutomaton::MakeRegexAuto(&regular_expression),
+                     StringAutomaton::MakeString(std::string(5000, 'a')));
+
+  // supported operands are still compiled under an unsupported repetition
+  Util::RegularExpression nested_expression ("(a|b){5000}c");
+  EXPECT_FALSE(RegexCompiler::IsSupported(&nested_expression));
+  StringAutomaton_ptr expected_auto = Union(StringAutomaton::MakeString("a"), StringAutomaton::MakeString("b"));
+  StringAutomaton_ptr repeated_auto = expected_auto->Repeat(5000, 5000);
+  delete expected_auto;
+  ExpectSameLanguage(StringAutomaton::MakeRegexAuto(&nested_expression),
+                     Concat(repeated_auto, StringAutomaton::MakeString("c")));
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
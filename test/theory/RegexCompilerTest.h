@@ -0,0 +1,51 @@
+/*
+ * RegexCompilerTest.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef THEORY_REGEXCOMPILERTEST_H_
+#define THEORY_REGEXCOMPILERTEST_H_
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/RegexCompiler.h"
+#include "theory/StringAutomaton.h"
+#include "utils/RegularExpression.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class RegexCompilerTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Makes the automaton of the regex with the compiler, the regex must be supported by it
+   */
+  StringAutomaton_ptr Compile(const std::string regex);
+
+  /**
+   * Checks that both automata accept the same language and deletes them
+   */
+  void ExpectSameLanguage(StringAutomaton_ptr actual_auto, StringAutomaton_ptr expected_auto);
+
+  /**
+   * Composing constructions used as the reference, they delete their operands
+   */
+  static StringAutomaton_ptr Union(StringAutomaton_ptr left_auto, StringAutomaton_ptr right_auto);
+  static StringAutomaton_ptr Concat(StringAutomaton_ptr left_auto, StringAutomaton_ptr right_auto);
+  static StringAutomaton_ptr Star(StringAutomaton_ptr string_auto);
+  static StringAutomaton_ptr Plus(StringAutomaton_ptr string_auto);
+  static StringAutomaton_ptr Optional(StringAutomaton_ptr string_auto);
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_REGEXCOMPILERTEST_H_ */
@@ -0,0 +1,306 @@
+/*
+ * StringAutomatonTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "StringAutomatonTest.h"
+
+#include <vector>
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+namespace {
+
+class PublicStringAutomaton : public StringAutomaton {
+ public:
+  using StringAutomaton::DEFAULT_NUM_OF_VARIABLES;
+  using StringAutomaton::DFADifference;
+  using StringAutomaton::DFAIsEqual;
+  using StringAutomaton::DFAProjectAway;
+  using StringAutomaton::DFAProjectAwayIndices;
+};
+
+}
+
+using namespace ::testing;
+
+void StringAutomatonTest::SetUp() {
+  // parse regexes with the syntax flags of the solver
+  Util::RegularExpression::DEFAULT = Util::RegularExpression::COMPLEMENT | Util::RegularExpression::EMPTY
+      | Util::RegularExpression::ANYSTRING;
+}
+
+void StringAutomatonTest::TearDown() {
+}
+
+void StringAutomatonTest::ExpectSameLanguage(StringAutomaton_ptr actual_auto, StringAutomaton_ptr expected_auto) {
+  EXPECT_TRUE(actual_auto->IsEqual(expected_auto));
+  delete actual_auto;
+  delete expected_auto;
+}
+
+StringAutomaton_ptr StringAutomatonTest::Unroll(StringAutomaton_ptr string_auto, const unsigned min, const unsigned max) {
+  StringAutomaton_ptr result_auto = StringAutomaton::MakePhi();
+  StringAutomaton_ptr copies_auto = StringAutomaton::MakeEmptyString();
+  for (unsigned i = 0; i <= max; ++i) {
+    if (i >= min) {
+      StringAutomaton_ptr tmp_auto = result_auto;
+      result_auto = tmp_auto->Union(copies_auto);
+      delete tmp_auto;
+    }
+    StringAutomaton_ptr tmp_auto = copies_auto;
+    copies_auto = tmp_auto->Concat(string_auto);
+    delete tmp_auto;
+  }
+  delete copies_auto;
+  return result_auto;
+}
+
+StringAutomaton_ptr StringAutomatonTest::Unroll(StringAutomaton_ptr string_auto, const unsigned min) {
+  StringAutomaton_ptr copies_auto = Unroll(string_auto, min, min);
+  StringAutomaton_ptr closure_auto = string_auto->KleeneClosure();
+  StringAutomaton_ptr result_auto = copies_auto->Concat(closure_auto);
+  delete copies_auto;
+  delete closure_auto;
+  return result_auto;
+}
+
+TEST_F(StringAutomatonTest, RepeatMin) {
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto("ab|c");
+  for (unsigned min = 0; min <= 4; ++min) {
+    ExpectSameLanguage(string_auto->Repeat(min), Unroll(string_auto, min));
+  }
+  delete string_auto;
+}
+
+TEST_F(StringAutomatonTest, RepeatMinMax) {
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto("ab|c");
+  for (unsigned min = 0; min <= 3; ++min) {
+    for (unsigned max = min; max <= 4; ++max) {
+      ExpectSameLanguage(string_auto->Repeat(min, max), Unroll(string_auto, min, max));
+    }
+  }
+  delete string_auto;
+}
+
+TEST_F(StringAutomatonTest, RepeatNullableOperand) {
+  StringAutomaton_ptr optional_auto = StringAutomaton::MakeRegexAuto("(ab)?");
+  ExpectSameLanguage(optional_auto->Repeat(3), Unroll(optional_auto, 3));
+  ExpectSameLanguage(optional_auto->Repeat(2, 3), Unroll(optional_auto, 2, 3));
+  delete optional_auto;
+
+  StringAutomaton_ptr closure_auto = StringAutomaton::MakeRegexAuto("a*b?");
+  ExpectSameLanguage(closure_auto->Repeat(2), Unroll(closure_auto, 2));
+  ExpectSameLanguage(closure_auto->Repeat(1, 3), Unroll(closure_auto, 1, 3));
+  delete closure_auto;
+
+  StringAutomaton_ptr empty_string_auto = StringAutomaton::MakeEmptyString();
+  ExpectSameLanguage(empty_string_auto->Repeat(2), StringAutomaton::MakeEmptyString());
+  ExpectSameLanguage(empty_string_auto->Repeat(2, 5), StringAutomaton::MakeEmptyString());
+  delete empty_string_auto;
+}
+
+TEST_F(StringAutomatonTest, RepeatEmptyBounds) {
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeString("ab");
+  ExpectSameLanguage(string_auto->Repeat(3, 2), StringAutomaton::MakePhi());
+  ExpectSameLanguage(string_auto->Repeat(0, 0), StringAutomaton::MakeEmptyString());
+  delete string_auto;
+
+  StringAutomaton_ptr phi_auto = StringAutomaton::MakePhi();
+  ExpectSameLanguage(phi_auto->Repeat(0, 2), StringAutomaton::MakeEmptyString());
+  ExpectSameLanguage(phi_auto->Repeat(1, 2), StringAutomaton::MakePhi());
+  delete phi_auto;
+}
+
+/**
+ * Unrolling a thousand copies is too slow, the closure limited by length accepts the same language for a single char
+ * operand
+ */
+TEST_F(StringAutomatonTest, RepeatLargeBound) {
+  StringAutomaton_ptr digit_auto = StringAutomaton::MakeCharRange('0', '9');
+  StringAutomaton_ptr closure_auto = digit_auto->Closure();
+  StringAutomaton_ptr length_auto = StringAutomaton::MakeAnyStringWithLengthInRange(1, 1000);
+  ExpectSameLanguage(digit_auto->Repeat(1, 1000), closure_auto->Intersect(length_auto));
+  delete length_auto;
+
+  length_auto = StringAutomaton::MakeAnyStringLengthGreaterThanOrEqualTo(1000);
+  ExpectSameLanguage(digit_auto->Repeat(1000), closure_auto->Intersect(length_auto));
+  delete length_auto;
+  delete closure_auto;
+  delete digit_auto;
+}
+
+TEST_F(StringAutomatonTest, IsIntersectionEmpty) {
+  StringAutomaton_ptr a_auto = StringAutomaton::MakeRegexAuto("a+");
+  StringAutomaton_ptr b_auto = StringAutomaton::MakeRegexAuto("b+");
+  StringAutomaton_ptr ab_auto = StringAutomaton::MakeRegexAuto("(a|b)*");
+  StringAutomaton_ptr phi_auto = StringAutomaton::MakePhi();
+  EXPECT_TRUE(a_auto->IsIntersectionEmpty(b_auto));
+  EXPECT_FALSE(a_auto->IsIntersectionEmpty(ab_auto));
+  EXPECT_FALSE(ab_auto->IsIntersectionEmpty(b_auto));
+  EXPECT_TRUE(ab_auto->IsIntersectionEmpty(phi_auto));
+  EXPECT_TRUE(phi_auto->IsIntersectionEmpty(phi_auto));
+  delete a_auto;
+  delete b_auto;
+  delete ab_auto;
+  delete phi_auto;
+}
+
+TEST_F(StringAutomatonTest, IsSubsetOf) {
+  StringAutomaton_ptr a_auto = StringAutomaton::MakeRegexAuto("a+");
+  StringAutomaton_ptr ab_auto = StringAutomaton::MakeRegexAuto("(a|b)*");
+  StringAutomaton_ptr phi_auto = StringAutomaton::MakePhi();
+  StringAutomaton_ptr any_auto = StringAutomaton::MakeAnyString();
+  EXPECT_TRUE(a_auto->IsSubsetOf(ab_auto));
+  EXPECT_FALSE(ab_auto->IsSubsetOf(a_auto));
+  EXPECT_TRUE(phi_auto->IsSubsetOf(a_auto));
+  EXPECT_FALSE(a_auto->IsSubsetOf(phi_auto));
+  EXPECT_TRUE(ab_auto->IsSubsetOf(any_auto));
+  EXPECT_TRUE(a_auto->IsSubsetOf(a_auto));
+  delete a_auto;
+  delete ab_auto;
+  delete phi_auto;
+  delete any_auto;
+}
+
+/**
+ * On the fly checks agree with the materialized products on every pair
+ */
+TEST_F(StringAutomatonTest, ProductChecksMatchProducts) {
+  std::vector<StringAutomaton_ptr> automata {StringAutomaton::MakeEmptyString()};
+  for (auto regex : {"#", "a*", "a+b", "(ab)*", "[a-c]{2}", "(a|b)*c?", ".*b.*", "~(a*)"}) {
+    automata.push_back(StringAutomaton::MakeRegexAuto(regex));
+  }
+  for (auto left_auto : automata) {
+    for (auto right_auto : automata) {
+      StringAutomaton_ptr intersect_auto = left_auto->Intersect(right_auto);
+      StringAutomaton_ptr difference_auto = left_auto->Difference(right_auto);
+      StringAutomaton_ptr other_difference_auto = right_auto->Difference(left_auto);
+      EXPECT_EQ(intersect_auto->IsEmptyLanguage(), left_auto->IsIntersectionEmpty(right_auto));
+      EXPECT_EQ(difference_auto->IsEmptyLanguage(), left_auto->IsSubsetOf(right_auto));
+      EXPECT_EQ(difference_auto->IsEmptyLanguage() and other_difference_auto->IsEmptyLanguage(),
+                left_auto->IsEqual(right_auto));
+      delete intersect_auto;
+      delete difference_auto;
+      delete other_difference_auto;
+    }
+  }
+  for (auto string_auto : automata) {
+    delete string_auto;
+  }
+}
+
+/**
+ * Union and intersection chains that are not compiled are minimized once after all products
+ */
+TEST_F(StringAutomatonTest, RegexChains) {
+  // with the intersection flag '|' is parsed as intersection
+  const int intersection_flags = Util::RegularExpression::INTERSECTION | Util::RegularExpression::COMPLEMENT;
+  const int union_flags = Util::RegularExpression::COMPLEMENT;
+  for (auto flags : {intersection_flags, union_flags}) {
+    Util::RegularExpression chain_expression ("a*b*|[a-c]{3}|~(b*)|.*a.*", flags);
+    StringAutomaton_ptr chain_auto = StringAutomaton::MakeRegexAuto(&chain_expression);
+    EXPECT_TRUE(chain_auto->IsMinimized());
+
+    StringAutomaton_ptr expected_auto = nullptr;
+    for (auto regex : {"a*b*", "[a-c]{3}", "~(b*)", ".*a.*"}) {
+      Util::RegularExpression operand_expression (regex, flags);
+      StringAutomaton_ptr operand_auto = StringAutomaton::MakeRegexAuto(&operand_expression);
+      if (expected_auto == nullptr) {
+        expected_auto = operand_auto;
+        continue;
+      }
+      StringAutomaton_ptr tmp_auto = expected_auto;
+      expected_auto = (flags == intersection_flags) ? tmp_auto->Intersect(operand_auto) : tmp_auto->Union(operand_auto);
+      delete tmp_auto;
+      delete operand_auto;
+    }
+    EXPECT_EQ(expected_auto->getDFA()->ns, chain_auto->getDFA()->ns);
+    ExpectSameLanguage(chain_auto, expected_auto);
+  }
+}
+
+/**
+ * Products are flagged as minimized unless minimization is deferred
+ */
+TEST_F(StringAutomatonTest, MinimizationDeferral) {
+  StringAutomaton_ptr a_auto = StringAutomaton::MakeRegexAuto("a+");
+  StringAutomaton_ptr b_auto = StringAutomaton::MakeRegexAuto("(ab)*");
+  StringAutomaton_ptr union_auto = a_auto->Union(b_auto);
+  StringAutomaton_ptr complement_auto = union_auto->Complement();
+  EXPECT_TRUE(union_auto->IsMinimized());
+  EXPECT_TRUE(complement_auto->IsMinimized());
+  StringAutomaton_ptr deferred_auto = nullptr;
+  {
+    Automaton::MinimizationDeferral minimization_deferral;
+    deferred_auto = a_auto->Union(b_auto);
+    EXPECT_FALSE(deferred_auto->IsMinimized());
+  }
+  EXPECT_TRUE(deferred_auto->IsEqual(union_auto));
+  delete deferred_auto;
+  delete complement_auto;
+  delete union_auto;
+  delete b_auto;
+  delete a_auto;
+}
+
+/**
+ * Memoized factory dfas are shared, the difference must not change its operands
+ */
+TEST_F(StringAutomatonTest, DFADifferenceKeepsOperands) {
+  StringAutomaton_ptr ab_auto = StringAutomaton::MakeRegexAuto("(a|b)*");
+  StringAutomaton_ptr length_auto = StringAutomaton::MakeAnyStringLengthLessThan(3);
+  DFA_ptr length_dfa = dfaCopy(length_auto->getDFA());
+
+  DFA_ptr difference_dfa = PublicStringAutomaton::DFADifference(ab_auto->getDFA(), length_auto->getDFA());
+  EXPECT_TRUE(PublicStringAutomaton::DFAIsEqual(length_dfa, length_auto->getDFA()));
+  StringAutomaton_ptr expected_auto = ab_auto->Difference(length_auto);
+  EXPECT_TRUE(PublicStringAutomaton::DFAIsEqual(expected_auto->getDFA(), difference_dfa));
+  dfaFree(difference_dfa);
+  dfaFree(length_dfa);
+  delete expected_auto;
+  delete length_auto;
+  delete ab_auto;
+}
+
+/**
+ * Projecting a set of bdd variables at once accepts the same language as projecting them one by one
+ */
+TEST_F(StringAutomatonTest, ProjectAwayIndices) {
+  const int number_of_bdd_variables = PublicStringAutomaton::DEFAULT_NUM_OF_VARIABLES;
+  const std::vector<std::vector<int>> index_sets {{}, {0}, {7}, {0, 3, 5}, {6, 1}, {0, 1, 2, 3, 4, 5, 6}};
+  for (auto regex : {"[a-z]+b", "(ab|cd)*", "a.c"}) {
+    StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto(regex);
+    for (auto& indices : index_sets) {
+      DFA_ptr expected_dfa = dfaCopy(string_auto->getDFA());
+      for (int index : indices) {
+        DFA_ptr tmp_dfa = expected_dfa;
+        expected_dfa = PublicStringAutomaton::DFAProjectAway(tmp_dfa, index);
+        dfaFree(tmp_dfa);
+      }
+      DFA_ptr projected_dfa = PublicStringAutomaton::DFAProjectAwayIndices(string_auto->getDFA(),
+                                                                          number_of_bdd_variables, indices);
+      EXPECT_TRUE(PublicStringAutomaton::DFAIsEqual(expected_dfa, projected_dfa)) << regex << " " << indices.size();
+      dfaFree(expected_dfa);
+      dfaFree(projected_dfa);
+    }
+    delete string_auto;
+  }
+
+  // without any bits only the lengths of the words are left
+  StringAutomaton_ptr string_auto = StringAutomaton::MakeRegexAuto("[a-z]+b");
+  StringAutomaton_ptr length_auto = StringAutomaton::MakeAnyStringLengthGreaterThanOrEqualTo(2);
+  DFA_ptr projected_dfa = PublicStringAutomaton::DFAProjectAwayIndices(string_auto->getDFA(), number_of_bdd_variables,
+                                                                      {0, 1, 2, 3, 4, 5, 6, 7});
+  EXPECT_TRUE(PublicStringAutomaton::DFAIsEqual(length_auto->getDFA(), projected_dfa));
+  dfaFree(projected_dfa);
+  delete length_auto;
+  delete string_auto;
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
@@ -0,0 +1,43 @@
+/*
+ * StringAutomatonTest.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef THEORY_STRINGAUTOMATONTEST_H_
+#define THEORY_STRINGAUTOMATONTEST_H_
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/StringAutomaton.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class StringAutomatonTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Checks that both automata accept the same language and deletes them
+   */
+  void ExpectSameLanguage(StringAutomaton_ptr actual_auto, StringAutomaton_ptr expected_auto);
+
+  /**
+   * Unions the concatenations of min to max copies of the automaton
+   */
+  static StringAutomaton_ptr Unroll(StringAutomaton_ptr string_auto, const unsigned min, const unsigned max);
+
+  /**
+   * Concatenates min copies of the automaton with its Kleene closure
+   */
+  static StringAutomaton_ptr Unroll(StringAutomaton_ptr string_auto, const unsigned min);
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_STRINGAUTOMATONTEST_H_ */
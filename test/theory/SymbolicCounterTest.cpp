@@ -0,0 +1,162 @@
+/*
+ * SymbolicCounterTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "SymbolicCounterTest.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+using namespace ::testing;
+
+void SymbolicCounterTest::SetUp() {
+  Automaton::SetCountBoundExact(false);
+  // '|' is parsed as intersection if the intersection flag is set, use the flags of the solver
+  Util::RegularExpression::DEFAULT = Util::RegularExpression::COMPLEMENT | Util::RegularExpression::EMPTY
+      | Util::RegularExpression::ANYSTRING;
+}
+
+void SymbolicCounterTest::TearDown() {
+}
+
+SymbolicCounter SymbolicCounterTest::GetCounter(const std::string regex) {
+  StringAutomaton_ptr regex_auto = StringAutomaton::MakeRegexAuto(regex);
+  SymbolicCounter counter = regex_auto->GetSymbolicCounter();
+  delete regex_auto;
+  return counter;
+}
+
+TEST_F(SymbolicCounterTest, CountbyRecurrence) {
+  SymbolicCounter counter = GetCounter("(a|b)*");
+  for (unsigned long bound = 0; bound <= 40; ++bound) {
+    const BigInteger expected = (BigInteger(1) << (bound + 1)) - 1;
+    EXPECT_EQ(expected, counter.CountbyIteration(bound)) << bound;
+    EXPECT_EQ(expected, counter.CountbyRecurrence(bound)) << bound;
+  }
+  EXPECT_EQ((BigInteger(1) << 1001) - 1, counter.CountbyRecurrence(1000));
+
+  counter = GetCounter("(ab)*");
+  for (unsigned long bound = 0; bound <= 40; ++bound) {
+    EXPECT_EQ(BigInteger(bound / 2 + 1), counter.CountbyRecurrence(bound)) << bound;
+  }
+  EXPECT_EQ(BigInteger(500001), counter.CountbyRecurrence(1000000));
+
+  counter = GetCounter("[a-z]{3}");
+  for (unsigned long bound = 0; bound <= 10; ++bound) {
+    EXPECT_EQ(BigInteger(bound < 3 ? 0 : 17576), counter.CountbyRecurrence(bound)) << bound;
+  }
+}
+
+TEST_F(SymbolicCounterTest, SumbyRecurrence) {
+  for (auto regex : {"(a|b)*", "a*b*", "(ab|c)*d?", "[a-c]{2,4}", "#"}) {
+    SymbolicCounter counter = GetCounter(regex);
+    BigInteger sum = 0;
+    for (unsigned long bound = 0; bound <= 30; ++bound) {
+      sum += counter.CountbyIteration(bound);
+      EXPECT_EQ(counter.CountbyIteration(bound), counter.CountbyRecurrence(bound)) << regex << " " << bound;
+      EXPECT_EQ(sum, counter.SumbyRecurrence(bound)) << regex << " " << bound;
+    }
+  }
+}
+
+TEST_F(SymbolicCounterTest, ConcurrentCount) {
+  const SymbolicCounter counter = GetCounter("(a|b)*c?");
+  const unsigned long max_bound = 64;
+  std::vector<BigInteger> expected_counts;
+  for (unsigned long bound = 0; bound <= max_bound; ++bound) {
+    expected_counts.push_back((BigInteger(1) << (bound + 1)) - 1 + (BigInteger(1) << bound) - 1);
+  }
+
+  // threads start from different bounds so that they fill and read the shared cache in different orders
+  const unsigned number_of_threads = 8;
+  std::vector<std::vector<BigInteger>> counts (number_of_threads, std::vector<BigInteger>(max_bound + 1));
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < number_of_threads; ++t) {
+    threads.push_back(std::thread([&counter, &counts, t, max_bound]() {
+      for (unsigned long i = 0; i <= max_bound; ++i) {
+        const unsigned long bound = (i * 7 + t * 13) % (max_bound + 1);
+        counts[t][bound] = counter.Count(bound);
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (unsigned t = 0; t < number_of_threads; ++t) {
+    EXPECT_EQ(expected_counts, counts[t]) << t;
+  }
+}
+
+TEST_F(SymbolicCounterTest, CacheIsTransparent) {
+  SymbolicCounter counter = GetCounter("a*b*");
+  SymbolicCounter uncached_counter = GetCounter("a*b*");
+  uncached_counter.set_cache_size(0);
+  for (unsigned long bound : {10, 3, 25, 10, 0, 25, 100}) {
+    const BigInteger expected = BigInteger(bound + 1) * (bound + 2) / 2;
+    EXPECT_EQ(expected, counter.Count(bound)) << bound;
+    EXPECT_EQ(expected, uncached_counter.Count(bound)) << bound;
+  }
+
+  // copies share the cache, shrinking it keeps the results
+  SymbolicCounter counter_copy = counter;
+  counter_copy.set_cache_size(1);
+  EXPECT_EQ(BigInteger(66), counter.Count(10));
+  EXPECT_EQ(BigInteger(5151), counter_copy.Count(100));
+  EXPECT_EQ(counter.CountBounds({5, 50, 20}), std::vector<BigInteger>({21, 1326, 231}));
+}
+
+TEST_F(SymbolicCounterTest, CountbySCCDecomposition) {
+  // simple cycles, chains of simple cycles and a component with two cycles that falls back
+  for (auto regex : {"(a|b)*", "(abc)*", "a*b*c*", "(ab)*(cde)*f", "(a|bc)*", "[a-z]{2,5}"}) {
+    SymbolicCounter counter = GetCounter(regex);
+    for (unsigned long bound = 0; bound <= 30; ++bound) {
+      EXPECT_EQ(counter.CountbyIteration(bound), counter.CountbySCCDecomposition(bound)) << regex << " " << bound;
+    }
+  }
+
+  SymbolicCounter counter = GetCounter("a*b*c*");
+  EXPECT_EQ(counter.CountbyRecurrence(5000), counter.CountbySCCDecomposition(5000));
+}
+
+TEST_F(SymbolicCounterTest, CountFiniteLanguage) {
+  SymbolicCounter counter = GetCounter("abc|de|[x-z]");
+  EXPECT_EQ(BigInteger(0), counter.CountbySCCDecomposition(0));
+  EXPECT_EQ(BigInteger(3), counter.CountbySCCDecomposition(1));
+  EXPECT_EQ(BigInteger(4), counter.CountbySCCDecomposition(2));
+  EXPECT_EQ(BigInteger(5), counter.CountbySCCDecomposition(3));
+  EXPECT_EQ(BigInteger(5), counter.CountbySCCDecomposition(1000000000));
+
+  counter = GetCounter("#");
+  EXPECT_EQ(BigInteger(0), counter.CountbySCCDecomposition(1000000000));
+}
+
+TEST_F(SymbolicCounterTest, CountUnaryLog2) {
+  // values that are 1 modulo 3
+  SemilinearSet_ptr semilinear_set = new SemilinearSet();
+  semilinear_set->set_cycle_head(0);
+  semilinear_set->set_period(3);
+  semilinear_set->add_periodic_constant(1);
+  UnaryAutomaton_ptr unary_auto = UnaryAutomaton::MakeAutomaton(semilinear_set);
+  SymbolicCounter counter = unary_auto->GetSymbolicCounter();
+  delete unary_auto;
+  delete semilinear_set;
+
+  // bounds of 64 and more do not fit the unary power 2^bound - 1
+  for (unsigned long bound : {10ul, 63ul, 64ul, 65ul, 200ul, 1000ul}) {
+    const BigInteger expected = ((BigInteger(1) << bound) - 2) / 3 + 1;
+    EXPECT_EQ(expected, counter.Count(bound)) << bound;
+    EXPECT_NEAR(std::log2(expected.convert_to<double>()), counter.CountLog2(bound),
+                counter.CountLog2ErrorBound(bound) + 1e-12) << bound;
+  }
+}
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
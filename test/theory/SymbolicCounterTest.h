@@ -0,0 +1,37 @@
+/*
+ * SymbolicCounterTest.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef THEORY_SYMBOLICCOUNTERTEST_H_
+#define THEORY_SYMBOLICCOUNTERTEST_H_
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "theory/StringAutomaton.h"
+#include "theory/SymbolicCounter.h"
+#include "theory/UnaryAutomaton.h"
+
+namespace Vlab {
+namespace Theory {
+namespace Test {
+
+class SymbolicCounterTest : public ::testing::Test {
+protected:
+  virtual void SetUp();
+  virtual void TearDown();
+
+  /**
+   * Gets the counter of the regex automaton, counts are for strings up to the bound
+   */
+  static SymbolicCounter GetCounter(const std::string regex);
+};
+
+} /* namespace Test */
+} /* namespace Theory */
+} /* namespace Vlab */
+
+#endif /* THEORY_SYMBOLICCOUNTERTEST_H_ */